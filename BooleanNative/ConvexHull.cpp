@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "ConvexHull.h"
+#include <thread>
+
+namespace PolygonBoolean {
+
+    namespace {
+        double turn(const Point& o, const Point& a, const Point& b) {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        }
+    }
+
+    void ConvexHull::filterInterior(const Point* points, size_t count, std::vector<Point>& out) {
+        out.clear();
+        if (count == 0) return;
+
+        // Extremes in eight directions, counter-clockwise from +x
+        size_t ext[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        for (size_t i = 1; i < count; i++) {
+            const Point& p = points[i];
+            if (p.x > points[ext[0]].x) ext[0] = i;
+            if (p.x + p.y > points[ext[1]].x + points[ext[1]].y) ext[1] = i;
+            if (p.y > points[ext[2]].y) ext[2] = i;
+            if (p.y - p.x > points[ext[3]].y - points[ext[3]].x) ext[3] = i;
+            if (p.x < points[ext[4]].x) ext[4] = i;
+            if (p.x + p.y < points[ext[5]].x + points[ext[5]].y) ext[5] = i;
+            if (p.y < points[ext[6]].y) ext[6] = i;
+            if (p.x - p.y > points[ext[7]].x - points[ext[7]].y) ext[7] = i;
+        }
+
+        Point octagon[8];
+        int n = 0;
+        for (int k = 0; k < 8; k++) {
+            const Point& p = points[ext[k]];
+            if (n == 0 || (p.x != octagon[n - 1].x || p.y != octagon[n - 1].y)) octagon[n++] = p;
+        }
+        while (n > 1 && octagon[n - 1].x == octagon[0].x && octagon[n - 1].y == octagon[0].y) n--;
+
+        if (n < 3) {
+            out.assign(points, points + count);
+            return;
+        }
+
+        out.reserve(count / 4 + 8);
+        for (size_t i = 0; i < count; i++) {
+            const Point& p = points[i];
+            bool inside = true;
+            for (int k = 0, j = n - 1; k < n; j = k++) {
+                if (turn(octagon[j], octagon[k], p) <= 0) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (!inside) out.push_back(p);
+        }
+    }
+
+    void ConvexHull::monotoneChain(std::vector<Point>& pts, std::vector<Point>& hull) {
+        hull.clear();
+        std::sort(pts.begin(), pts.end(), [](const Point& a, const Point& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+            });
+
+        size_t n = pts.size();
+        if (n < 3) {
+            hull = pts;
+            if (n == 2 && pts[0].x == pts[1].x && pts[0].y == pts[1].y) hull.pop_back();
+            return;
+        }
+
+        hull.resize(2 * n);
+        size_t k = 0;
+
+        // Lower hull
+        for (size_t i = 0; i < n; i++) {
+            while (k >= 2 && turn(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+            hull[k++] = pts[i];
+        }
+
+        // Upper hull
+        for (size_t i = n - 1, lower = k + 1; i-- > 0;) {
+            while (k >= lower && turn(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+            hull[k++] = pts[i];
+        }
+
+        hull.resize(k - 1); // last point repeats the first
+    }
+
+    void ConvexHull::serialHull(const Point* points, size_t count, std::vector<Point>& hull) {
+        std::vector<Point> candidates;
+        filterInterior(points, count, candidates);
+        monotoneChain(candidates, hull);
+    }
+
+    std::vector<Point> ConvexHull::compute(const Point* points, size_t count, unsigned threads) {
+        std::vector<Point> hull;
+        if (count == 0) return hull;
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        if (threads == 1 || count < ParallelThreshold) {
+            serialHull(points, count, hull);
+            return hull;
+        }
+
+        // Divide: hull each chunk on its own thread
+        std::vector<std::vector<Point>> partial(threads);
+        std::vector<std::thread> pool;
+        size_t chunk = (count + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; t++) {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            pool.emplace_back([&, t, begin, end]() {
+                serialHull(points + begin, end - begin, partial[t]);
+                });
+        }
+        for (auto& th : pool) th.join();
+
+        // Conquer: the hull of the chunk hulls
+        std::vector<Point> merged;
+        for (const auto& h : partial) merged.insert(merged.end(), h.begin(), h.end());
+        monotoneChain(merged, hull);
+        return hull;
+    }
+
+    std::vector<Point> ConvexHull::compute(const std::vector<Point>& points, unsigned threads) {
+        return compute(points.data(), points.size(), threads);
+    }
+
+    Polygon ConvexHull::compute(const Polygon& polygon) {
+        std::vector<Point> points = polygon.getPoints();
+        if (points.size() < 3) return polygon;
+        return Polygon(compute(points, 1));
+    }
+
+} // namespace PolygonBoolean
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef CONVEXHULL_H
+#define CONVEXHULL_H
+
+#include <vector>
+#include "Polygon.h"
+
+namespace PolygonBoolean {
+
+    // Andrew's monotone chain with Akl–Toussaint prefiltering.
+    // Large inputs can be split across threads: each chunk is hulled
+    // independently and the chunk hulls are merged with one more chain.
+    class ConvexHull {
+    public:
+        static const size_t ParallelThreshold = 1 << 20;
+
+        // Counter-clockwise hull without collinear points.
+        // threads == 0 uses the hardware concurrency; 1 runs serially.
+        static std::vector<Point> compute(const Point* points, size_t count, unsigned threads = 1);
+        static std::vector<Point> compute(const std::vector<Point>& points, unsigned threads = 1);
+        static Polygon compute(const Polygon& polygon);
+
+    private:
+        // Copies the points that are not strictly inside the extreme octagon
+        static void filterInterior(const Point* points, size_t count, std::vector<Point>& out);
+
+        // Sorts pts in place and writes the hull
+        static void monotoneChain(std::vector<Point>& pts, std::vector<Point>& hull);
+
+        static void serialHull(const Point* points, size_t count, std::vector<Point>& hull);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // CONVEXHULL_H
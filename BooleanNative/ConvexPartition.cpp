@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "ConvexPartition.h"
+#include "Triangulator.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace PolygonBoolean {
+
+    bool ConvexPartition::partition(const std::vector<std::vector<Point>>& rings,
+        std::vector<std::vector<size_t>>& pieces) {
+        return partition(RingSpan::of(rings), pieces);
+    }
+
+    bool ConvexPartition::partition(const std::vector<std::vector<Point>>& rings,
+        std::vector<std::vector<Point>>& pieces) {
+        return partition(RingSpan::of(rings), pieces);
+    }
+
+    bool ConvexPartition::partition(const std::vector<RingSpan>& rings,
+        std::vector<std::vector<size_t>>& pieces) {
+        pieces.clear();
+
+        std::vector<size_t> indices;
+        if (!Triangulator::triangulate(rings, indices)) return false;
+
+        std::vector<Point> pts;
+        for (const auto& ring : rings) pts.insert(pts.end(), ring.begin(), ring.end());
+
+        // Half-edge h of triangle h / 3 runs from origin[h] to origin of the
+        // next half-edge in that triangle
+        const size_t count = indices.size();
+        std::vector<size_t> next(count), prev(count), twin(count, SIZE_MAX);
+        for (size_t t = 0; t < count; t += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                next[t + k] = t + (k + 1) % 3;
+                prev[t + k] = t + (k + 2) % 3;
+            }
+        }
+
+        std::unordered_map<uint64_t, size_t> edges;
+        edges.reserve(count);
+        for (size_t h = 0; h < count; h++) {
+            uint64_t from = indices[h], to = indices[next[h]];
+            auto it = edges.find((to << 32) | from);
+            if (it != edges.end()) {
+                twin[h] = it->second;
+                twin[it->second] = h;
+                edges.erase(it);
+            }
+            else {
+                edges.emplace((from << 32) | to, h);
+            }
+        }
+
+        auto convexAt = [&](size_t in, size_t out) {
+            // in ends at the shared vertex, out starts there
+            const Point& a = pts[indices[in]];
+            const Point& b = pts[indices[out]];
+            const Point& c = pts[indices[next[out]]];
+            return (b - a).cross(c - b) >= 0;
+            };
+
+        // Remove diagonals greedily; each test only looks at the two
+        // faces' neighbouring edges, so the pass is linear
+        std::vector<char> removed(count, 0);
+        for (size_t h = 0; h < count; h++) {
+            size_t t = twin[h];
+            if (t == SIZE_MAX || t < h) continue;
+
+            // h runs u → v, t runs v → u
+            if (!convexAt(prev[h], next[t])) continue; // at u
+            if (!convexAt(prev[t], next[h])) continue; // at v
+
+            next[prev[h]] = next[t];
+            prev[next[t]] = prev[h];
+            next[prev[t]] = next[h];
+            prev[next[h]] = prev[t];
+            removed[h] = removed[t] = 1;
+        }
+
+        std::vector<char> visited(count, 0);
+        for (size_t h0 = 0; h0 < count; h0++) {
+            if (removed[h0] || visited[h0]) continue;
+            std::vector<size_t> piece;
+            size_t h = h0;
+            do {
+                visited[h] = 1;
+                piece.push_back(indices[h]);
+                h = next[h];
+            } while (h != h0);
+            pieces.push_back(std::move(piece));
+        }
+
+        return true;
+    }
+
+    bool ConvexPartition::partition(const std::vector<RingSpan>& rings,
+        std::vector<std::vector<Point>>& pieces) {
+        pieces.clear();
+
+        std::vector<std::vector<size_t>> indexPieces;
+        if (!partition(rings, indexPieces)) return false;
+
+        std::vector<Point> pts;
+        for (const auto& ring : rings) pts.insert(pts.end(), ring.begin(), ring.end());
+
+        pieces.reserve(indexPieces.size());
+        for (const auto& piece : indexPieces) {
+            std::vector<Point> out;
+            out.reserve(piece.size());
+            for (size_t i : piece) out.push_back(pts[i]);
+            pieces.push_back(std::move(out));
+        }
+
+        return true;
+    }
+
+} // namespace PolygonBoolean
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef CONVEXPARTITION_H
+#define CONVEXPARTITION_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    // Hertel–Mehlhorn convex decomposition, O(n log n): triangulate, then
+    // drop every diagonal whose removal keeps both of its endpoints
+    // convex. The result has at most four times the minimum number of
+    // convex pieces and is meant to be computed once per static part and
+    // reused by the convex kernels (Minkowski sums, clipping, point tests).
+    class ConvexPartition {
+    public:
+        // rings[0] is the outer boundary, the others are holes; any winding.
+        // Each piece is a CCW list of indices into the rings concatenated
+        // in order.
+        static bool partition(const std::vector<std::vector<Point>>& rings,
+            std::vector<std::vector<size_t>>& pieces);
+
+        // Same, returning the piece coordinates
+        static bool partition(const std::vector<std::vector<Point>>& rings,
+            std::vector<std::vector<Point>>& pieces);
+
+        // Both forms over rings read in place; indices follow iteration order
+        static bool partition(const std::vector<RingSpan>& rings,
+            std::vector<std::vector<size_t>>& pieces);
+        static bool partition(const std::vector<RingSpan>& rings,
+            std::vector<std::vector<Point>>& pieces);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // CONVEXPARTITION_H
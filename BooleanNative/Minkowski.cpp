@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "Minkowski.h"
+#include "ConvexPartition.h"
+#include "WindingOverlay.h"
+
+namespace PolygonBoolean {
+
+    std::vector<std::vector<Point>> Minkowski::sum(
+        const std::vector<std::vector<Point>>& a,
+        const std::vector<std::vector<Point>>& b) {
+        return sum(RingSpan::of(a), RingSpan::of(b));
+    }
+
+    std::vector<std::vector<Point>> Minkowski::sum(
+        const std::vector<RingSpan>& a,
+        const std::vector<RingSpan>& b) {
+        std::vector<std::vector<Point>> piecesA, piecesB;
+        convexPieces(a, piecesA);
+        convexPieces(b, piecesB);
+        return sumOfPieces(piecesA, piecesB);
+    }
+
+    std::vector<std::vector<Point>> Minkowski::sumOfPieces(
+        const std::vector<std::vector<Point>>& piecesA,
+        const std::vector<std::vector<Point>>& piecesB) {
+        if (piecesA.empty() || piecesB.empty()) return {};
+
+        // Partial sums of neighbouring pieces sit next to each other, so
+        // the union tree merges overlapping pieces first
+        std::vector<std::vector<std::vector<Point>>> partial;
+        partial.reserve(piecesA.size() * piecesB.size());
+        for (const auto& pa : piecesA) {
+            for (const auto& pb : piecesB) {
+                std::vector<Point> s = convexSum(pa, pb);
+                if (s.size() >= 3) partial.push_back({ std::move(s) });
+            }
+        }
+        if (partial.empty()) return {};
+
+        return unionTree(partial, 0, partial.size());
+    }
+
+    std::vector<std::vector<Point>> Minkowski::unionTree(
+        std::vector<std::vector<std::vector<Point>>>& parts, size_t begin, size_t end) {
+        if (end - begin == 1) return std::move(parts[begin]);
+
+        size_t mid = begin + (end - begin) / 2;
+        std::vector<std::vector<Point>> rings = unionTree(parts, begin, mid);
+        std::vector<std::vector<Point>> right = unionTree(parts, mid, end);
+        rings.insert(rings.end(), std::make_move_iterator(right.begin()), std::make_move_iterator(right.end()));
+
+        // Each side is already a clean region (winding 0 or 1), so one
+        // non-zero pass only has to deal with the two boundaries
+        return WindingOverlay::resolve(rings, 1);
+    }
+
+    std::vector<std::vector<Point>> Minkowski::difference(
+        const std::vector<std::vector<Point>>& a,
+        const std::vector<std::vector<Point>>& b) {
+        return difference(RingSpan::of(a), RingSpan::of(b));
+    }
+
+    std::vector<std::vector<Point>> Minkowski::difference(
+        const std::vector<RingSpan>& a,
+        const std::vector<RingSpan>& b) {
+        // Point reflection keeps every ring's winding; only B is copied
+        std::vector<std::vector<Point>> negB;
+        negB.reserve(b.size());
+        for (const RingSpan& ring : b) {
+            std::vector<Point>& neg = negB.emplace_back();
+            neg.reserve(ring.size());
+            for (const Point& p : ring) neg.emplace_back(-p.x, -p.y);
+        }
+        return sum(a, RingSpan::of(negB));
+    }
+
+    std::vector<Point> Minkowski::convexSum(const std::vector<Point>& a, const std::vector<Point>& b) {
+        std::vector<Point> pa, pb;
+        if (!normalizeConvex(RingSpan(a), pa) || !normalizeConvex(RingSpan(b), pb)) return {};
+
+        // Start both edge sequences at their lowest (then leftmost) vertex
+        auto lowest = [](const std::vector<Point>& r) {
+            size_t k = 0;
+            for (size_t i = 1; i < r.size(); i++) {
+                if (r[i].y < r[k].y || (r[i].y == r[k].y && r[i].x < r[k].x)) k = i;
+            }
+            return k;
+            };
+        std::rotate(pa.begin(), pa.begin() + lowest(pa), pa.end());
+        std::rotate(pb.begin(), pb.begin() + lowest(pb), pb.end());
+
+        const size_t n = pa.size(), m = pb.size();
+        std::vector<Point> result;
+        result.reserve(n + m);
+
+        size_t i = 0, j = 0;
+        while (i < n || j < m) {
+            result.push_back(pa[i % n] + pb[j % m]);
+            Point ea = pa[(i + 1) % n] - pa[i % n];
+            Point eb = pb[(j + 1) % m] - pb[j % m];
+            double c = ea.cross(eb);
+            if (j == m || (i < n && c > 0)) i++;
+            else if (i == n || c < 0) j++;
+            else { i++; j++; }
+        }
+
+        return result;
+    }
+
+    bool Minkowski::normalizeConvex(RingSpan ring, std::vector<Point>& out) {
+        out.clear();
+        out.reserve(ring.size());
+
+        double area2 = ring.signedArea2();
+        if (area2 == 0) return false;
+
+        auto push = [&](const Point& p) {
+            if (!out.empty() && out.back() == p) return;
+            // Drop the previous vertex if it is collinear with its neighbours
+            while (out.size() >= 2 && (out[out.size() - 1] - out[out.size() - 2]).cross(p - out[out.size() - 1]) == 0) {
+                out.pop_back();
+            }
+            out.push_back(p);
+            };
+
+        for (const Point& p : area2 > 0 ? ring : ring.reverse()) push(p);
+
+        // Close the seam
+        while (out.size() >= 3 && out.front() == out.back()) out.pop_back();
+        while (out.size() >= 3 && (out[out.size() - 1] - out[out.size() - 2]).cross(out[0] - out[out.size() - 1]) == 0) out.pop_back();
+        while (out.size() >= 3 && (out[0] - out.back()).cross(out[1] - out[0]) == 0) out.erase(out.begin());
+
+        return out.size() >= 3;
+    }
+
+    bool Minkowski::isConvex(RingSpan ring) {
+        size_t n = ring.size();
+        if (n < 3) return false;
+
+        int sign = 0;
+        for (size_t i = 0; i < n; i++) {
+            double c = (ring[(i + 1) % n] - ring[i]).cross(ring[(i + 2) % n] - ring[(i + 1) % n]);
+            if (c == 0) continue;
+            int s = c > 0 ? 1 : -1;
+            if (sign == 0) sign = s;
+            else if (s != sign) return false;
+        }
+
+        // Turning in one direction only is not enough for a star-shaped
+        // loop that winds twice; its angles must also add up to one turn
+        double turn = 0;
+        for (size_t i = 0; i < n; i++) {
+            Point e1 = ring[(i + 1) % n] - ring[i];
+            Point e2 = ring[(i + 2) % n] - ring[(i + 1) % n];
+            turn += std::atan2(e1.cross(e2), e1.dot(e2));
+        }
+        return sign != 0 && std::abs(turn) < 7.0;
+    }
+
+    void Minkowski::convexPieces(const std::vector<RingSpan>& rings,
+        std::vector<std::vector<Point>>& pieces) {
+        pieces.clear();
+        if (rings.empty() || rings[0].size() < 3) return;
+
+        if (rings.size() == 1 && isConvex(rings[0])) {
+            pieces.push_back(rings[0].toVector());
+            return;
+        }
+
+        ConvexPartition::partition(rings, pieces);
+    }
+
+} // namespace PolygonBoolean
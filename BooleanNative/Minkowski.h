@@ -0,0 +1,65 @@
+#pragma once
+#ifndef MINKOWSKI_H
+#define MINKOWSKI_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    // Minkowski sum A + B = { a + b } and difference A - B = A + (-B).
+    // The difference is the no-fit polygon used for nesting: B placed with
+    // its reference point at p overlaps A exactly when p lies inside A - B.
+    //
+    // Convex inputs are summed in O(n + m) by merging their edge sequences
+    // by slope. General polygons (concave, with holes) are split into
+    // convex pieces (ConvexPartition), every pair of pieces is summed with
+    // the convex kernel and the partial sums are merged in a balanced
+    // union tree.
+    class Minkowski {
+    public:
+        // rings[0] is the outer boundary, the others are holes; any winding.
+        // Result rings are CCW for outer boundaries and CW for holes.
+        static std::vector<std::vector<Point>> sum(
+            const std::vector<std::vector<Point>>& a,
+            const std::vector<std::vector<Point>>& b);
+
+        static std::vector<std::vector<Point>> difference(
+            const std::vector<std::vector<Point>>& a,
+            const std::vector<std::vector<Point>>& b);
+
+        // Both, reading the rings in place
+        static std::vector<std::vector<Point>> sum(
+            const std::vector<RingSpan>& a,
+            const std::vector<RingSpan>& b);
+        static std::vector<std::vector<Point>> difference(
+            const std::vector<RingSpan>& a,
+            const std::vector<RingSpan>& b);
+
+        // Sum of two regions given as convex pieces (e.g. ConvexPartition
+        // output cached per part); the pieces of each side must not overlap
+        static std::vector<std::vector<Point>> sumOfPieces(
+            const std::vector<std::vector<Point>>& piecesA,
+            const std::vector<std::vector<Point>>& piecesB);
+
+        // Both rings convex (any winding); returns the CCW sum
+        static std::vector<Point> convexSum(const std::vector<Point>& a, const std::vector<Point>& b);
+
+    private:
+        // CCW copy without repeated or collinear vertices; false if degenerate
+        static bool normalizeConvex(RingSpan ring, std::vector<Point>& out);
+
+        static bool isConvex(RingSpan ring);
+
+        static void convexPieces(const std::vector<RingSpan>& rings,
+            std::vector<std::vector<Point>>& pieces);
+
+        // Non-zero union of parts[begin, end), pairwise bottom-up
+        static std::vector<std::vector<Point>> unionTree(
+            std::vector<std::vector<std::vector<Point>>>& parts, size_t begin, size_t end);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // MINKOWSKI_H
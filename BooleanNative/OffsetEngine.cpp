@@ -0,0 +1,205 @@
+#include "pch.h"
+#include "OffsetEngine.h"
+#include "WindingOverlay.h"
+
+namespace PolygonBoolean {
+
+    namespace {
+        constexpr double PI = 3.14159265358979323846;
+
+        Point scaled(const Point& v, double s) {
+            return Point(v.x * s, v.y * s);
+        }
+
+        Point rotate(const Point& v, double angle) {
+            double c = std::cos(angle), s = std::sin(angle);
+            return Point(v.x * c - v.y * s, v.x * s + v.y * c);
+        }
+    }
+
+    std::vector<std::vector<Point>> OffsetEngine::offset(
+        const std::vector<std::vector<Point>>& rings,
+        double distance,
+        const OffsetOptions& options) {
+        return offset(RingSpan::of(rings), distance, options);
+    }
+
+    std::vector<std::vector<Point>> OffsetEngine::offset(
+        const std::vector<RingSpan>& rings,
+        double distance,
+        const OffsetOptions& options) {
+        std::vector<std::vector<Point>> raw;
+        raw.reserve(rings.size());
+
+        for (const auto& ring : rings) {
+            std::vector<Point> curve;
+            offsetRing(ring, distance, options, curve);
+            if (curve.size() >= 3) raw.push_back(std::move(curve));
+        }
+
+        std::vector<std::vector<Point>> result = WindingOverlay::resolve(raw, 1);
+
+        // Rings smaller than the arc tolerance are chord artefacts of the
+        // raw curves, not features of the buffer
+        double tolerance = options.arcTolerance > 0.0 ? options.arcTolerance : std::abs(distance) * 0.01;
+        result.erase(std::remove_if(result.begin(), result.end(), [&](const std::vector<Point>& ring) {
+            double a = 0;
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) a += ring[j].cross(ring[i]);
+            return std::abs(a) * 0.5 < tolerance * tolerance;
+            }), result.end());
+
+        return result;
+    }
+
+    std::vector<std::vector<Point>> OffsetEngine::offsetPolygon(
+        const Polygon& polygon,
+        double distance,
+        const OffsetOptions& options) {
+        std::vector<Point> ring = polygon.getPoints();
+        return offset(std::vector<RingSpan>{ RingSpan(ring.data(), ring.size(), polygon.isClockwise()) },
+            distance, options);
+    }
+
+    void OffsetEngine::offsetRing(RingSpan ring, double distance,
+        const OffsetOptions& options, std::vector<Point>& out) {
+        out.clear();
+
+        // Drop repeated vertices (including a closing duplicate)
+        std::vector<Point> pts;
+        pts.reserve(ring.size());
+        for (const Point& p : ring) {
+            if (pts.empty() || !(pts.back() == p)) pts.push_back(p);
+        }
+        while (pts.size() > 1 && pts.front() == pts.back()) pts.pop_back();
+        size_t n = pts.size();
+        if (n < 3) return;
+
+        if (distance == 0.0) {
+            out = std::move(pts);
+            return;
+        }
+
+        const double absDist = std::abs(distance);
+        double tolerance = options.arcTolerance > 0.0 ? options.arcTolerance : absDist * 0.01;
+        tolerance = std::min(tolerance, absDist);
+
+        // Fill the notches on the closing side whose opening is narrow
+        // against the distance. A disk of radius |distance| reaches at most
+        // c^2 / 8|distance| into a notch of opening c, so filling it moves
+        // the buffer by no more than that (kept to a quarter of the
+        // tolerance). On a noisy outline every such notch would otherwise
+        // route a spike of length |distance| through its vertex, and those
+        // spikes cross each other quadratically in the self-union.
+        const double depth = tolerance * 0.25;
+        const double maxChord2 = 4.0 * (2.0 * absDist * depth - depth * depth);
+        auto fillable = [&](const Point& a, const Point& v, const Point& b) {
+            Point e1 = v - a, e2 = b - v;
+            double turn = e1.cross(e2);
+            if (turn * distance > 0.0 || (turn == 0.0 && e1.dot(e2) <= 0.0)) return false;
+            Point chord = b - a;
+            return chord.dot(chord) <= maxChord2;
+        };
+
+        std::vector<Point> kept;
+        kept.reserve(pts.size());
+        for (const Point& p : pts) {
+            while (kept.size() >= 2 && fillable(kept[kept.size() - 2], kept.back(), p)) kept.pop_back();
+            kept.push_back(p);
+        }
+        // The corners around the seam, until neither end changes
+        size_t first = 0;
+        for (bool changed = true; changed && kept.size() - first > 3;) {
+            changed = false;
+            if (fillable(kept[kept.size() - 2], kept.back(), kept[first])) {
+                kept.pop_back();
+                changed = true;
+            }
+            else if (fillable(kept.back(), kept[first], kept[first + 1])) {
+                first++;
+                changed = true;
+            }
+        }
+        pts.assign(kept.begin() + first, kept.end());
+        n = pts.size();
+        if (n < 3) return;
+
+        // Unit right-hand normal and length of every edge i → i+1
+        std::vector<Point> normals(n);
+        std::vector<double> lengths(n);
+        for (size_t i = 0; i < n; i++) {
+            Point d = pts[(i + 1) % n] - pts[i];
+            double len = std::sqrt(d.dot(d));
+            normals[i] = Point(d.y / len, -d.x / len);
+            lengths[i] = len;
+        }
+
+        const double stepAngle = 2.0 * std::acos(1.0 - tolerance / absDist);
+        const double miterLimit = std::max(options.miterLimit, 1.0);
+
+        out.reserve(n * 3);
+        for (size_t i = 0; i < n; i++) {
+            const Point& v = pts[i];
+            const Point& n1 = normals[(i + n - 1) % n];
+            const Point& n2 = normals[i];
+            Point p1 = v + scaled(n1, distance);
+            Point p2 = v + scaled(n2, distance);
+
+            double turn = n1.cross(n2);
+            double cosAngle = n1.dot(n2);
+
+            if (turn * distance <= 0.0 && cosAngle > -0.999999) {
+                // Closing side: when the miter point falls within the first
+                // half of both edges it is exactly where the offset edges
+                // meet; otherwise route through the vertex and let the
+                // self-union cut the loop away
+                double reach = absDist * std::sqrt(std::max(0.0, (1.0 - cosAngle) / (1.0 + cosAngle)));
+                if (2.0 * reach <= std::min(lengths[(i + n - 1) % n], lengths[i])) {
+                    out.push_back(v + scaled(n1 + n2, distance / (1.0 + cosAngle)));
+                }
+                else {
+                    out.push_back(p1);
+                    out.push_back(v);
+                    out.push_back(p2);
+                }
+                continue;
+            }
+
+            JoinType join = options.join;
+            if (join == JoinType::MITER) {
+                // Miter length relative to |distance| is 1 / cos(theta / 2)
+                if (1.0 + cosAngle < 2.0 / (miterLimit * miterLimit)) {
+                    join = JoinType::SQUARE;
+                }
+                else {
+                    out.push_back(v + scaled(n1 + n2, distance / (1.0 + cosAngle)));
+                    continue;
+                }
+            }
+
+            if (join == JoinType::SQUARE) {
+                // Cut the corner perpendicular to the bisector, |distance| from v
+                Point u1(-n1.y, n1.x); // incoming edge direction
+                Point u2(-n2.y, n2.x); // outgoing edge direction
+                Point bisector = n1 + n2;
+                double len = std::sqrt(bisector.dot(bisector));
+                bisector = len < 1e-12 ? u1 : scaled(bisector, (distance > 0.0 ? 1.0 : -1.0) / len);
+                double t1 = (absDist - distance * n1.dot(bisector)) / u1.dot(bisector);
+                double t2 = (absDist - distance * n2.dot(bisector)) / u2.dot(bisector);
+                out.push_back(p1 + scaled(u1, t1));
+                out.push_back(p2 + scaled(u2, t2));
+                continue;
+            }
+
+            // Round: arc from p1 to p2 around v
+            double sweep = std::atan2(turn, cosAngle);
+            if (std::abs(sweep) > PI - 1e-9) sweep = distance > 0.0 ? PI : -PI;
+            int steps = std::max(1, (int)std::ceil(std::abs(sweep) / stepAngle));
+            out.push_back(p1);
+            for (int k = 1; k < steps; k++) {
+                out.push_back(v + scaled(rotate(n1, sweep * k / steps), distance));
+            }
+            out.push_back(p2);
+        }
+    }
+
+} // namespace PolygonBoolean
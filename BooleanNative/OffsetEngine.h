@@ -0,0 +1,59 @@
+#pragma once
+#ifndef OFFSETENGINE_H
+#define OFFSETENGINE_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    enum class JoinType {
+        MITER,
+        ROUND,
+        SQUARE
+    };
+
+    struct OffsetOptions {
+        JoinType join = JoinType::ROUND;
+        double miterLimit = 2.0;   // max miter length in multiples of |distance|; beyond it a square join is used
+        double arcTolerance = 0.0; // max chord deviation of round joins; 0 = |distance| / 100
+    };
+
+    // Buffers closed rings by a signed distance. Outer rings are expected
+    // CCW and holes CW (the winding convention WindingOverlay produces), so
+    // a positive distance grows the filled region and a negative one
+    // shrinks it.
+    //
+    // Notches on the closing side too narrow for the distance to matter
+    // are filled first. Each ring is then offset edge by edge with the
+    // requested join on the opening side of every corner; on the closing side the raw curve is
+    // routed back through the original vertex. The raw curves are then
+    // resolved with a non-zero self-union, which removes the loops at
+    // concave corners and any region that collapsed under an inward offset.
+    class OffsetEngine {
+    public:
+        static std::vector<std::vector<Point>> offset(
+            const std::vector<std::vector<Point>>& rings,
+            double distance,
+            const OffsetOptions& options = OffsetOptions());
+
+        // Same, reading the rings in place (reverse a span to flip a ring)
+        static std::vector<std::vector<Point>> offset(
+            const std::vector<RingSpan>& rings,
+            double distance,
+            const OffsetOptions& options = OffsetOptions());
+
+        static std::vector<std::vector<Point>> offsetPolygon(
+            const Polygon& polygon,
+            double distance,
+            const OffsetOptions& options = OffsetOptions());
+
+    private:
+        static void offsetRing(RingSpan ring, double distance,
+            const OffsetOptions& options, std::vector<Point>& out);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // OFFSETENGINE_H
@@ -1,5 +1,11 @@
 #include "pch.h"
 #include "Polygon.h"
+#include "Triangulator.h"
+#include "ConvexHull.h"
+#include "OffsetEngine.h"
+#include "Minkowski.h"
+#include "ConvexPartition.h"
+#include "WindingOverlay.h"
 #include <sstream>
 #include <stack>
 #include <queue>
@@ -112,6 +118,15 @@ namespace PolygonBoolean {
             while (angle >= 2 * 3.14) angle -= 2 * 3.14;
             return angle;
         }
+
+        // Every ring of an engine result as its own polygon; outer
+        // boundaries stay CCW and holes CW
+        std::vector<Polygon> toPolygons(const std::vector<std::vector<Point>>& rings) {
+            std::vector<Polygon> polygons;
+            polygons.reserve(rings.size());
+            for (const auto& ring : rings) polygons.emplace_back(ring);
+            return polygons;
+        }
     }
 
     // Constructors & Destructor
@@ -597,7 +612,7 @@ namespace PolygonBoolean {
     bool Polygon::lineSegmentIntersection(const Point& p1, const Point& p2,
         const Point& q1, const Point& q2,
         Point& intersection,
-        double& t1, double& t2) const {
+        double& t1, double& t2) {
         Point r = p2 - p1;
         Point s = q2 - q1;
         Point qp = q1 - p1;
@@ -821,76 +836,62 @@ namespace PolygonBoolean {
     // Utility methods (simplified implementations)
     std::vector<Polygon> Polygon::triangulate() const {
         std::vector<Polygon> triangles;
-        // Basic ear-clipping algorithm (simplified)
         if (vertexCount() < 3) return triangles;
 
         std::vector<Point> points = getPoints();
-
-        // Simple triangle fan for convex polygons
-        if (isConvex()) {
-            for (size_t i = 1; i + 1 < points.size(); i++) {
-                Polygon triangle;
-                triangle.addPoint(points[0]);
-                triangle.addPoint(points[i]);
-                triangle.addPoint(points[i + 1]);
-                triangles.push_back(triangle);
-            }
+        std::vector<size_t> indices;
+        Triangulator::triangulate({ points }, indices);
+
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            Polygon triangle;
+            triangle.addPoint(points[indices[i]]);
+            triangle.addPoint(points[indices[i + 1]]);
+            triangle.addPoint(points[indices[i + 2]]);
+            triangles.push_back(std::move(triangle));
         }
 
         return triangles;
     }
 
-    Polygon Polygon::getConvexHull() const {
-        // Graham scan algorithm (simplified)
-        std::vector<Point> points = getPoints();
-        if (points.size() < 3) return *this;
-
-        // Find lowest point
-        size_t lowest = 0;
-        for (size_t i = 1; i < points.size(); i++) {
-            if (points[i].y < points[lowest].y ||
-                (points[i].y == points[lowest].y && points[i].x < points[lowest].x)) {
-                lowest = i;
-            }
-        }
+    void Polygon::triangulate(std::vector<size_t>& indices) const {
+        indices.clear();
+        if (vertexCount() < 3) return;
+        Triangulator::triangulate({ getPoints() }, indices);
+    }
 
-        // Sort by polar angle
-        std::swap(points[0], points[lowest]);
-        Point pivot = points[0];
+    std::vector<Polygon> Polygon::getConvexPartition() const {
+        std::vector<Polygon> parts;
+        if (vertexCount() < 3) return parts;
 
-        std::sort(points.begin() + 1, points.end(),
-            [pivot](const Point& a, const Point& b) {
-                double cross = (a - pivot).cross(b - pivot);
-                if (isZero(cross)) {
-                    return pivot.distance(a) < pivot.distance(b);
-                }
-                return cross > 0;
-            });
+        std::vector<std::vector<Point>> pieces;
+        ConvexPartition::partition({ getPoints() }, pieces);
 
-        // Build hull
-        std::vector<Point> hull;
-        for (const auto& p : points) {
-            while (hull.size() >= 2 &&
-                (hull[hull.size() - 1] - hull[hull.size() - 2]).cross(p - hull[hull.size() - 2]) <= 0) {
-                hull.pop_back();
-            }
-            hull.push_back(p);
-        }
+        parts.reserve(pieces.size());
+        for (const auto& piece : pieces) parts.emplace_back(piece);
+        return parts;
+    }
 
-        return Polygon(hull);
+    Polygon Polygon::getConvexHull() const {
+        return ConvexHull::compute(*this);
     }
 
-    Polygon Polygon::getOffset(double distance) const {
-        // Simple offset (for convex polygons)
-        Polygon result = *this;
+    std::vector<Polygon> Polygon::getOffset(double distance) const {
+        if (vertexCount() < 3 || distance == 0) return { *this };
 
-        if (isConvex() && distance != 0) {
-            // Scale polygon to achieve offset
-            double scaleFactor = 1.0 + distance / (area() / perimeter());
-            result.scale(scaleFactor, scaleFactor);
-        }
+        // Round-joined buffer; an inward offset can split the polygon and
+        // an outward one can close a concave bay into a hole
+        return toPolygons(OffsetEngine::offsetPolygon(*this, distance));
+    }
 
-        return result;
+    std::vector<Polygon> Polygon::getMinkowskiSum(const Polygon& other) const {
+        if (vertexCount() < 3 || other.vertexCount() < 3) return {};
+        return toPolygons(Minkowski::sum({ getPoints() }, { other.getPoints() }));
+    }
+
+    std::vector<Polygon> Polygon::getMinkowskiDifference(const Polygon& other) const {
+        if (vertexCount() < 3 || other.vertexCount() < 3) return {};
+        return toPolygons(Minkowski::difference({ getPoints() }, { other.getPoints() }));
     }
 
     Polygon Polygon::getBoundary() const {
@@ -987,14 +988,14 @@ namespace PolygonBoolean {
 
             if (polygon[i].y <= p.y) {
                 if (polygon[j].y > p.y) {
-                    if (crossProduct(polygon[i], polygon[j], p) > 0) {
+                    if ((polygon[j] - polygon[i]).cross(p - polygon[i]) > 0) {
                         windingNumber++;
                     }
                 }
             }
             else {
                 if (polygon[j].y <= p.y) {
-                    if (crossProduct(polygon[i], polygon[j], p) < 0) {
+                    if ((polygon[j] - polygon[i]).cross(p - polygon[i]) < 0) {
                         windingNumber--;
                     }
                 }
@@ -1036,9 +1037,58 @@ namespace PolygonBoolean {
     }
 
     std::vector<Polygon> BooleanOperations::compute(const std::vector<Polygon>& polygons, Operation op) {
-        if (polygons.empty()) return {};
-        if (polygons.size() == 1) return polygons;
+        std::vector<std::vector<Point>> points;
+        points.reserve(polygons.size());
+        for (size_t i = 0; i < polygons.size(); i++) {
+            if (polygons[i].vertexCount() >= 3) points.push_back(polygons[i].getPoints());
+            else if (op == INTERSECTION || (op == DIFFERENCE && i == 0)) return {};
+        }
+        if (points.empty()) return {};
+
+        // Every input CCW, so the winding number counts the polygons
+        // covering a point
+        std::vector<RingSpan> rings;
+        rings.reserve(points.size());
+        for (const auto& ring : points) rings.push_back(RingSpan(ring).ccw());
+
+        switch (op) {
+        case UNION:
+            return toPolygons(WindingOverlay::resolve(rings, 1));
+        case INTERSECTION:
+            return toPolygons(WindingOverlay::resolve(rings, (int)rings.size()));
+        case DIFFERENCE:
+            // The first polygon less the others: each reversed one takes
+            // one off the winding where it covers the first
+            for (size_t i = 1; i < rings.size(); i++) rings[i] = rings[i].reverse();
+            return toPolygons(WindingOverlay::resolve(rings, 1));
+        case SYMMETRIC_DIFFERENCE: {
+            // Odd coverage is no winding threshold: fold pairwise,
+            // X ^ Y = (X - Y) + (Y - X)
+            std::vector<std::vector<Point>> result = { rings[0].toVector() };
+            for (size_t i = 1; i < rings.size(); i++) {
+                std::vector<RingSpan> xMinusY = RingSpan::of(result);
+                std::vector<RingSpan> yMinusX = { rings[i] };
+                xMinusY.push_back(rings[i].reverse());
+                for (const auto& ring : result) yMinusX.push_back(RingSpan(ring).reverse());
+
+                std::vector<std::vector<Point>> parts = WindingOverlay::resolve(xMinusY, 1);
+                std::vector<std::vector<Point>> other = WindingOverlay::resolve(yMinusX, 1);
+                parts.insert(parts.end(), other.begin(), other.end());
+                result = WindingOverlay::resolve(parts, 1);
+            }
+            return toPolygons(result);
+        }
+        }
 
-        std::vector<Polygon> result = { polygons[0] };
+        return {};
+    }
+
+    std::vector<Polygon> BooleanOperations::mergeAll(const std::vector<Polygon>& polygons) {
+        return compute(polygons, UNION);
+    }
+
+    std::vector<Polygon> BooleanOperations::clip(const Polygon& subject, const Polygon& clip) {
+        return compute(subject, clip, DIFFERENCE);
+    }
 
-        for (size_t i = 1; i < polygons.size(); i++)
+} // namespace PolygonBoolean
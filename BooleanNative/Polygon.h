@@ -80,12 +80,6 @@ namespace PolygonBoolean {
         bool pointInPolygon(const Point& p) const;
         double crossProduct(const Point& a, const Point& b, const Point& c) const;
 
-        // Intersection methods
-        bool lineSegmentIntersection(const Point& p1, const Point& p2,
-            const Point& q1, const Point& q2,
-            Point& intersection,
-            double& t1, double& t2) const;
-
         // List management
         void insertVertexAfter(Vertex* position, Vertex* newVertex);
         void removeVertex(Vertex* vertex);
@@ -153,8 +147,17 @@ namespace PolygonBoolean {
 
         // Utility methods
         std::vector<Polygon> triangulate() const;
+        void triangulate(std::vector<size_t>& indices) const; // 3 indices per triangle into getPoints()
+        std::vector<Polygon> getConvexPartition() const;
         Polygon getConvexHull() const;
-        Polygon getOffset(double distance) const;
+        // Every ring of the round-joined buffer: outer boundaries CCW,
+        // holes CW
+        std::vector<Polygon> getOffset(double distance) const;
+
+        // Minkowski sum / difference (no-fit polygon), every ring of the
+        // result: outer boundaries CCW, holes CW
+        std::vector<Polygon> getMinkowskiSum(const Polygon& other) const;
+        std::vector<Polygon> getMinkowskiDifference(const Polygon& other) const;
 
         // Boundary operations
         Polygon getBoundary() const;
@@ -169,6 +172,10 @@ namespace PolygonBoolean {
         static double pointDistance(const Point& a, const Point& b);
         static bool isPointOnSegment(const Point& p, const Point& a, const Point& b);
         static int pointInPolygon(const Point& p, const std::vector<Point>& polygon);
+        static bool lineSegmentIntersection(const Point& p1, const Point& p2,
+            const Point& q1, const Point& q2,
+            Point& intersection,
+            double& t1, double& t2);
 
     private:
         // Friend functions for internal operations
@@ -192,11 +199,13 @@ namespace PolygonBoolean {
         // Compute operation and return as single polygon (first result)
         static Polygon computeSingle(const Polygon& A, const Polygon& B, Operation op);
 
-        // Compute operation on multiple polygons
+        // Compute operation on multiple polygons in one winding overlay:
+        // DIFFERENCE is the first polygon less all the others. Returns every
+        // ring of the result, outer boundaries CCW and holes CW
         static std::vector<Polygon> compute(const std::vector<Polygon>& polygons, Operation op);
 
-        // Merge multiple polygons (cascading union)
-        static Polygon mergeAll(const std::vector<Polygon>& polygons);
+        // Union of all polygons, every component and hole
+        static std::vector<Polygon> mergeAll(const std::vector<Polygon>& polygons);
 
         // Clip polygon against another (like difference but returns multiple pieces)
         static std::vector<Polygon> clip(const Polygon& subject, const Polygon& clip);
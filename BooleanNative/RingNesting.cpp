@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "RingNesting.h"
+
+namespace PolygonBoolean {
+
+    std::vector<std::vector<size_t>> RingNesting::group(const std::vector<RingSpan>& rings) {
+        std::vector<std::vector<size_t>> groups;
+        std::vector<double> outerArea;
+        std::vector<size_t> holes;
+
+        for (size_t i = 0; i < rings.size(); i++) {
+            if (rings[i].size() < 3) continue;
+            double a = rings[i].signedArea2();
+            if (a > 0) {
+                groups.push_back({ i });
+                outerArea.push_back(a);
+            }
+            else if (a < 0) {
+                holes.push_back(i);
+            }
+        }
+
+        for (size_t h : holes) {
+            const Point& p = rings[h][0];
+            size_t best = groups.size();
+            for (size_t k = 0; k < groups.size(); k++) {
+                if (best != groups.size() && outerArea[k] >= outerArea[best]) continue;
+                if (contains(rings[groups[k][0]], p))
+                    best = k;
+            }
+            if (best != groups.size())
+                groups[best].push_back(h);
+        }
+
+        return groups;
+    }
+
+    bool RingNesting::contains(RingSpan ring, const Point& p) {
+        int winding = 0;
+        size_t n = ring.size();
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            const Point& a = ring[j];
+            const Point& b = ring[i];
+            if (a.y <= p.y) {
+                if (b.y > p.y && (b - a).cross(p - a) > 0) winding++;
+            }
+            else {
+                if (b.y <= p.y && (b - a).cross(p - a) < 0) winding--;
+            }
+        }
+        return winding != 0;
+    }
+
+} // namespace PolygonBoolean
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef RINGNESTING_H
+#define RINGNESTING_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    // Groups engine output back into polygons with holes. The rings follow
+    // the WindingOverlay convention, CCW for outer boundaries and CW for
+    // holes; each hole goes to the smallest outer that contains its first
+    // vertex.
+    class RingNesting {
+    public:
+        // One group per outer ring, in input order: the outer's index in
+        // rings followed by the indices of its holes. Holes inside no outer
+        // and rings without area are left out.
+        static std::vector<std::vector<size_t>> group(const std::vector<RingSpan>& rings);
+
+    private:
+        // Non-zero winding test, on the ring in place
+        static bool contains(RingSpan ring, const Point& p);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // RINGNESTING_H
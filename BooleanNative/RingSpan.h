@@ -0,0 +1,99 @@
+#pragma once
+#ifndef RINGSPAN_H
+#define RINGSPAN_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "Polygon.h"
+
+namespace PolygonBoolean {
+
+    // Non-owning view of a closed ring: pointer + count + orientation flag.
+    // A reversed span reads the same storage back to front, so engines
+    // reorient input rings without copying them. The storage (a vector, a
+    // memory-mapped file, a foreign buffer) must outlive the span.
+    class RingSpan {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Point;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Point*;
+            using reference = const Point&;
+
+            iterator() = default;
+            iterator(const Point* p, bool reversed) : p(p), step(reversed ? -1 : 1) {}
+
+            reference operator*() const { return step > 0 ? *p : p[-1]; }
+            pointer operator->() const { return &**this; }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            iterator& operator++() { p += step; return *this; }
+            iterator operator++(int) { iterator t = *this; p += step; return t; }
+            iterator& operator--() { p -= step; return *this; }
+            iterator operator--(int) { iterator t = *this; p -= step; return t; }
+            iterator& operator+=(difference_type n) { p += n * step; return *this; }
+            iterator& operator-=(difference_type n) { p -= n * step; return *this; }
+            friend iterator operator+(iterator it, difference_type n) { return it += n; }
+            friend iterator operator+(difference_type n, iterator it) { return it += n; }
+            friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const iterator& a, const iterator& b) { return (a.p - b.p) * a.step; }
+
+            bool operator==(const iterator& o) const { return p == o.p; }
+            bool operator!=(const iterator& o) const { return p != o.p; }
+            bool operator<(const iterator& o) const { return (o - *this) > 0; }
+            bool operator>(const iterator& o) const { return o < *this; }
+            bool operator<=(const iterator& o) const { return !(o < *this); }
+            bool operator>=(const iterator& o) const { return !(*this < o); }
+
+        private:
+            const Point* p = nullptr; // reversed iterators point one past their element
+            std::ptrdiff_t step = 1;
+        };
+
+        RingSpan() = default;
+        RingSpan(const Point* data, size_t count, bool reversed = false)
+            : points(data), count(count), reversed(reversed) {}
+        explicit RingSpan(const std::vector<Point>& ring)
+            : points(ring.data()), count(ring.size()) {}
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        bool isReversed() const { return reversed; }
+
+        const Point& operator[](size_t i) const { return points[reversed ? count - 1 - i : i]; }
+        iterator begin() const { return reversed ? iterator(points + count, true) : iterator(points, false); }
+        iterator end() const { return reversed ? iterator(points, true) : iterator(points + count, false); }
+
+        RingSpan reverse() const { return RingSpan(points, count, !reversed); }
+
+        // Twice the signed area in iteration order (> 0 for CCW)
+        double signedArea2() const {
+            double a = 0;
+            for (size_t i = 0, j = count - 1; i < count; j = i++) a += points[j].cross(points[i]);
+            return reversed ? -a : a;
+        }
+
+        RingSpan ccw() const { return signedArea2() < 0 ? reverse() : *this; }
+
+        std::vector<Point> toVector() const { return std::vector<Point>(begin(), end()); }
+
+        // Spans over every ring of an owned ring list
+        static std::vector<RingSpan> of(const std::vector<std::vector<Point>>& rings) {
+            std::vector<RingSpan> spans;
+            spans.reserve(rings.size());
+            for (const auto& ring : rings) spans.emplace_back(ring);
+            return spans;
+        }
+
+    private:
+        const Point* points = nullptr;
+        size_t count = 0;
+        bool reversed = false;
+    };
+
+} // namespace PolygonBoolean
+
+#endif // RINGSPAN_H
@@ -0,0 +1,354 @@
+#include "pch.h"
+#include "Triangulator.h"
+#include <set>
+#include <cstdint>
+
+namespace PolygonBoolean {
+
+    namespace {
+        enum class SweepType { START, END, SPLIT, MERGE, REGULAR };
+
+        const size_t QUERY = SIZE_MAX;
+
+        // Sweep order: higher y first, ties broken by smaller x
+        bool above(const Point& a, const Point& b) {
+            return a.y > b.y || (a.y == b.y && a.x < b.x);
+        }
+
+        double orient(const Point& a, const Point& b, const Point& c) {
+            return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        }
+    }
+
+    bool Triangulator::triangulate(const std::vector<std::vector<Point>>& rings,
+        std::vector<size_t>& indices) {
+        return triangulate(RingSpan::of(rings), indices);
+    }
+
+    bool Triangulator::triangulate(const std::vector<RingSpan>& rings,
+        std::vector<size_t>& indices) {
+        indices.clear();
+        if (rings.empty() || rings[0].size() < 3) return false;
+
+        // ==================== Vertices (outer CCW, holes CW) ====================
+        std::vector<SweepVertex> verts;
+        size_t total = 0;
+        for (const auto& ring : rings) total += ring.size();
+        verts.reserve(total);
+
+        for (size_t r = 0; r < rings.size(); r++) {
+            const auto& ring = rings[r];
+            size_t base = verts.size();
+            size_t n = ring.size();
+            for (const auto& p : ring) verts.push_back({ p, 0, 0 });
+            if (n < 3) {
+                // Degenerate hole: keep indices stable, leave it out of the sweep
+                for (size_t i = 0; i < n; i++) verts[base + i].prev = verts[base + i].next = base + i;
+                continue;
+            }
+
+            double area = 0.0;
+            for (size_t i = 0, j = n - 1; i < n; j = i++) area += ring[j].cross(ring[i]);
+            bool flip = (r == 0) ? area < 0 : area > 0;
+
+            for (size_t i = 0; i < n; i++) {
+                size_t prev = base + (i + n - 1) % n;
+                size_t next = base + (i + 1) % n;
+                verts[base + i].prev = flip ? next : prev;
+                verts[base + i].next = flip ? prev : next;
+            }
+        }
+
+        std::vector<size_t> order;
+        order.reserve(verts.size());
+        for (size_t i = 0; i < verts.size(); i++) {
+            if (verts[i].next != i) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return above(verts[a].p, verts[b].p);
+            });
+
+        std::vector<SweepType> type(verts.size(), SweepType::REGULAR);
+        for (size_t v : order) {
+            const Point& p = verts[verts[v].prev].p;
+            const Point& c = verts[v].p;
+            const Point& n = verts[verts[v].next].p;
+            bool prevAbove = above(p, c);
+            bool nextAbove = above(n, c);
+            bool convex = orient(p, c, n) > 0;
+
+            if (!prevAbove && !nextAbove) type[v] = convex ? SweepType::START : SweepType::SPLIT;
+            else if (prevAbove && nextAbove) type[v] = convex ? SweepType::END : SweepType::MERGE;
+        }
+
+        // ==================== Monotone partition sweep ====================
+        // Status holds edges (identified by their start vertex) that have
+        // the interior on their right, ordered by x at the sweep line.
+        Point sweep;
+        double queryX = 0.0;
+
+        auto xAt = [&](size_t e) {
+            const Point& a = verts[e].p;
+            const Point& b = verts[verts[e].next].p;
+            if (a.y == b.y) {
+                return std::min(std::max(sweep.x, std::min(a.x, b.x)), std::max(a.x, b.x));
+            }
+            return a.x + (sweep.y - a.y) * (b.x - a.x) / (b.y - a.y);
+            };
+
+        auto less = [&](size_t a, size_t b) {
+            if (a == b) return false;
+            double xa = (a == QUERY) ? queryX : xAt(a);
+            double xb = (b == QUERY) ? queryX : xAt(b);
+            if (xa != xb) return xa < xb;
+            if (a == QUERY) return false;
+            if (b == QUERY) return true;
+
+            // Shared upper endpoint: compare the directions going down
+            auto down = [&](size_t e) {
+                const Point& p = verts[e].p;
+                const Point& q = verts[verts[e].next].p;
+                return above(p, q) ? q - p : p - q;
+                };
+            double c = down(a).cross(down(b));
+            if (c != 0) return c > 0;
+            return a < b;
+            };
+
+        std::set<size_t, decltype(less)> status(less);
+        std::vector<std::set<size_t, decltype(less)>::iterator> where(verts.size(), status.end());
+        std::vector<size_t> helper(verts.size(), 0);
+        std::vector<std::pair<size_t, size_t>> diagonals;
+
+        auto isMerge = [&](size_t v) { return type[v] == SweepType::MERGE; };
+        auto insertEdge = [&](size_t e, size_t h) {
+            where[e] = status.insert(e).first;
+            helper[e] = h;
+            };
+        auto eraseEdge = [&](size_t e) {
+            if (where[e] != status.end()) {
+                status.erase(where[e]);
+                where[e] = status.end();
+            }
+            };
+        auto leftOf = [&](size_t v) -> size_t {
+            queryX = verts[v].p.x;
+            auto it = status.lower_bound(QUERY);
+            if (it == status.begin()) return QUERY;
+            return *std::prev(it);
+            };
+
+        for (size_t v : order) {
+            sweep = verts[v].p;
+            size_t ePrev = verts[v].prev;
+
+            switch (type[v]) {
+            case SweepType::START:
+                insertEdge(v, v);
+                break;
+
+            case SweepType::END:
+                if (where[ePrev] != status.end() && isMerge(helper[ePrev]))
+                    diagonals.emplace_back(v, helper[ePrev]);
+                eraseEdge(ePrev);
+                break;
+
+            case SweepType::SPLIT: {
+                size_t ej = leftOf(v);
+                if (ej != QUERY) {
+                    diagonals.emplace_back(v, helper[ej]);
+                    helper[ej] = v;
+                }
+                insertEdge(v, v);
+                break;
+            }
+
+            case SweepType::MERGE: {
+                if (where[ePrev] != status.end() && isMerge(helper[ePrev]))
+                    diagonals.emplace_back(v, helper[ePrev]);
+                eraseEdge(ePrev);
+                size_t ej = leftOf(v);
+                if (ej != QUERY) {
+                    if (isMerge(helper[ej])) diagonals.emplace_back(v, helper[ej]);
+                    helper[ej] = v;
+                }
+                break;
+            }
+
+            case SweepType::REGULAR:
+                if (above(verts[ePrev].p, verts[v].p)) {
+                    // Interior to the right: v is on a left chain
+                    if (where[ePrev] != status.end() && isMerge(helper[ePrev]))
+                        diagonals.emplace_back(v, helper[ePrev]);
+                    eraseEdge(ePrev);
+                    insertEdge(v, v);
+                }
+                else {
+                    size_t ej = leftOf(v);
+                    if (ej != QUERY) {
+                        if (isMerge(helper[ej])) diagonals.emplace_back(v, helper[ej]);
+                        helper[ej] = v;
+                    }
+                }
+                break;
+            }
+        }
+
+        // ==================== Split into monotone faces ====================
+        // Half-edges with the interior on their left: boundary edges in ring
+        // direction plus both directions of every diagonal.
+        for (auto& d : diagonals) {
+            if (d.first > d.second) std::swap(d.first, d.second);
+        }
+        std::sort(diagonals.begin(), diagonals.end());
+        diagonals.erase(std::unique(diagonals.begin(), diagonals.end()), diagonals.end());
+
+        std::vector<size_t> offset(verts.size() + 1, 0);
+        for (size_t v : order) offset[v + 1]++;
+        for (const auto& d : diagonals) {
+            if (d.first == d.second) continue;
+            offset[d.first + 1]++;
+            offset[d.second + 1]++;
+        }
+        for (size_t i = 0; i < verts.size(); i++) offset[i + 1] += offset[i];
+
+        std::vector<std::pair<double, size_t>> out(offset.back());
+        std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+        auto addHalfEdge = [&](size_t from, size_t to) {
+            const Point d = verts[to].p - verts[from].p;
+            out[fill[from]++] = { std::atan2(d.y, d.x), to };
+            };
+        for (size_t v : order) addHalfEdge(v, verts[v].next);
+        for (const auto& d : diagonals) {
+            if (d.first == d.second) continue;
+            addHalfEdge(d.first, d.second);
+            addHalfEdge(d.second, d.first);
+        }
+        for (size_t i = 0; i < verts.size(); i++) {
+            std::sort(out.begin() + offset[i], out.begin() + offset[i + 1]);
+        }
+
+        std::vector<char> used(out.size(), 0);
+        auto halfEdgeId = [&](size_t from, size_t to) {
+            for (size_t k = offset[from]; k < offset[from + 1]; k++) {
+                if (out[k].second == to) return k;
+            }
+            return SIZE_MAX;
+            };
+
+        std::vector<size_t> face;
+        for (size_t v : order) {
+            for (size_t k = offset[v]; k < offset[v + 1]; k++) {
+                if (used[k]) continue;
+
+                face.clear();
+                size_t from = v;
+                size_t h = k;
+                while (h != SIZE_MAX && !used[h]) {
+                    used[h] = 1;
+                    face.push_back(from);
+                    size_t to = out[h].second;
+
+                    // Next half-edge: first outgoing edge clockwise from to→from
+                    const Point back = verts[from].p - verts[to].p;
+                    double theta = std::atan2(back.y, back.x);
+                    size_t lo = offset[to], hi = offset[to + 1];
+                    size_t pick = hi - 1;
+                    for (size_t m = lo; m < hi; m++) {
+                        if (out[m].first < theta) pick = m;
+                    }
+                    if (out[pick].second == from && hi - lo > 1 && halfEdgeId(to, from) == pick) {
+                        pick = (pick == lo) ? hi - 1 : pick - 1;
+                    }
+                    from = to;
+                    h = pick;
+                }
+
+                if (face.size() >= 3) triangulateMonotone(verts, face, indices);
+            }
+        }
+
+        return true;
+    }
+
+    // ==================== Monotone piece (stack walk) ====================
+    void Triangulator::triangulateMonotone(const std::vector<SweepVertex>& verts,
+        const std::vector<size_t>& face,
+        std::vector<size_t>& indices) {
+        size_t n = face.size();
+
+        auto emit = [&](size_t a, size_t b, size_t c) {
+            if (orient(verts[a].p, verts[b].p, verts[c].p) < 0) std::swap(b, c);
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(c);
+            };
+
+        if (n == 3) {
+            emit(face[0], face[1], face[2]);
+            return;
+        }
+
+        size_t top = 0, bottom = 0;
+        for (size_t i = 1; i < n; i++) {
+            if (above(verts[face[i]].p, verts[face[top]].p)) top = i;
+            if (above(verts[face[bottom]].p, verts[face[i]].p)) bottom = i;
+        }
+
+        // CCW from the top runs down the left chain, back up the right one
+        std::vector<std::pair<size_t, bool>> sorted; // vertex, on left chain
+        sorted.reserve(n);
+        size_t l = (top + 1) % n;
+        size_t r = (top + n - 1) % n;
+        sorted.emplace_back(face[top], true);
+        while (l != bottom || r != bottom) {
+            bool takeLeft = (r == bottom) ||
+                (l != bottom && above(verts[face[l]].p, verts[face[r]].p));
+            if (takeLeft) {
+                sorted.emplace_back(face[l], true);
+                l = (l + 1) % n;
+            }
+            else {
+                sorted.emplace_back(face[r], false);
+                r = (r + n - 1) % n;
+            }
+        }
+        sorted.emplace_back(face[bottom], false);
+
+        std::vector<std::pair<size_t, bool>> stack = { sorted[0], sorted[1] };
+        for (size_t j = 2; j + 1 < n; j++) {
+            auto u = sorted[j];
+            if (u.second != stack.back().second) {
+                // Opposite chain: fan to everything on the stack
+                for (size_t k = 0; k + 1 < stack.size(); k++)
+                    emit(u.first, stack[k].first, stack[k + 1].first);
+                auto last = stack.back();
+                stack.clear();
+                stack.push_back(last);
+                stack.push_back(u);
+            }
+            else {
+                // Same chain: cut ears while the diagonal stays inside
+                auto last = stack.back();
+                stack.pop_back();
+                while (!stack.empty()) {
+                    const Point& s = verts[stack.back().first].p;
+                    const Point& m = verts[last.first].p;
+                    const Point& c = verts[u.first].p;
+                    bool inside = u.second ? orient(s, m, c) > 0 : orient(c, m, s) > 0;
+                    if (!inside) break;
+                    emit(u.first, last.first, stack.back().first);
+                    last = stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(last);
+                stack.push_back(u);
+            }
+        }
+
+        size_t last = sorted[n - 1].first;
+        for (size_t k = 0; k + 1 < stack.size(); k++)
+            emit(last, stack[k].first, stack[k + 1].first);
+    }
+
+} // namespace PolygonBoolean
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef TRIANGULATOR_H
+#define TRIANGULATOR_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    // Sweep-line triangulation of simple polygons with holes, O(n log n).
+    // The polygon is first split into y-monotone pieces (helper/diagonal
+    // sweep), then every piece is triangulated with the stack walk.
+    class Triangulator {
+    public:
+        // rings[0] is the outer boundary, the others are holes; any winding.
+        // Indices refer to the rings concatenated in order, three per
+        // triangle, each triangle counter-clockwise.
+        static bool triangulate(const std::vector<std::vector<Point>>& rings,
+            std::vector<size_t>& indices);
+
+        // Same, reading the rings in place; indices follow iteration order
+        static bool triangulate(const std::vector<RingSpan>& rings,
+            std::vector<size_t>& indices);
+
+    private:
+        struct SweepVertex {
+            Point p;
+            size_t prev;
+            size_t next;
+        };
+
+        static void triangulateMonotone(const std::vector<SweepVertex>& verts,
+            const std::vector<size_t>& face,
+            std::vector<size_t>& indices);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // TRIANGULATOR_H
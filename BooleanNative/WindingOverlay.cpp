@@ -0,0 +1,496 @@
+#include "pch.h"
+#include "WindingOverlay.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace PolygonBoolean {
+
+    namespace {
+        struct Segment {
+            Point a, b;
+        };
+
+        // Uniform grid; each segment is registered in the cells it actually
+        // crosses (row by row), so long diagonal edges stay cheap. Occupied
+        // cells are also listed per row for ray casting.
+        struct SegmentGrid {
+            double minX = 0, minY = 0, cellW = 1, cellH = 1, pad = 0;
+            int cols = 1, rows = 1;
+            std::vector<uint32_t> start;
+            std::vector<uint32_t> items;
+            std::vector<uint32_t> rowStart, rowCells; // occupied columns per row
+
+            int col(double x) const {
+                double c = std::floor((x - minX) / cellW);
+                return c < 0 ? 0 : (c >= cols ? cols - 1 : (int)c);
+            }
+            int row(double y) const {
+                double r = std::floor((y - minY) / cellH);
+                return r < 0 ? 0 : (r >= rows ? rows - 1 : (int)r);
+            }
+
+            template <typename Fn>
+            void forCells(const Segment& s, Fn&& fn) const {
+                double sy0 = std::min(s.a.y, s.b.y), sy1 = std::max(s.a.y, s.b.y);
+                int r0 = row(sy0 - pad), r1 = row(sy1 + pad);
+                if (r0 == r1) {
+                    int c0 = col(std::min(s.a.x, s.b.x) - pad), c1 = col(std::max(s.a.x, s.b.x) + pad);
+                    for (int c = c0; c <= c1; c++) fn(r0 * cols + c);
+                    return;
+                }
+                double dy = s.b.y - s.a.y;
+                double slope = dy != 0.0 ? (s.b.x - s.a.x) / dy : 0.0;
+                for (int r = r0; r <= r1; r++) {
+                    double xa = std::min(s.a.x, s.b.x), xb = std::max(s.a.x, s.b.x);
+                    if (dy != 0.0) {
+                        double ylo = std::max(minY + r * cellH - pad, sy0);
+                        double yhi = std::min(minY + (r + 1) * cellH + pad, sy1);
+                        xa = s.a.x + (ylo - s.a.y) * slope;
+                        xb = s.a.x + (yhi - s.a.y) * slope;
+                    }
+                    int c0 = col(std::min(xa, xb) - pad), c1 = col(std::max(xa, xb) + pad);
+                    for (int c = c0; c <= c1; c++) fn(r * cols + c);
+                }
+            }
+
+            void build(const std::vector<Segment>& segs, double x0, double y0, double x1, double y1, double snap) {
+                size_t n = std::max<size_t>(1, segs.size());
+                double w = std::max(x1 - x0, snap), h = std::max(y1 - y0, snap);
+                // About four cells per segment, but never so small that long
+                // edges fan out over more than a few cells each on average
+                double length = 0;
+                for (const auto& s : segs) length += std::abs(s.b.x - s.a.x) + std::abs(s.b.y - s.a.y);
+                double side = std::max(std::sqrt(w * h / (4.0 * (double)n)), length / (4.0 * (double)n));
+                cols = (int)std::min(8192.0, std::max(1.0, std::ceil(w / side)));
+                rows = (int)std::min(8192.0, std::max(1.0, std::ceil(h / side)));
+                minX = x0; minY = y0;
+                cellW = w / cols; cellH = h / rows;
+                pad = snap * 8.0 + std::max(cellW, cellH) * 1e-9;
+
+                size_t cellCount = (size_t)cols * rows;
+                start.assign(cellCount + 1, 0);
+                for (const auto& s : segs) forCells(s, [&](int cell) { start[cell + 1]++; });
+                for (size_t i = 1; i < start.size(); i++) start[i] += start[i - 1];
+                items.resize(start.back());
+                std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+                for (uint32_t i = 0; i < segs.size(); i++)
+                    forCells(segs[i], [&](int cell) { items[fill[cell]++] = i; });
+
+                rowStart.assign((size_t)rows + 1, 0);
+                rowCells.clear();
+                for (int r = 0; r < rows; r++) {
+                    for (int c = 0; c < cols; c++)
+                        if (start[(size_t)r * cols + c] != start[(size_t)r * cols + c + 1]) rowCells.push_back(c);
+                    rowStart[r + 1] = (uint32_t)rowCells.size();
+                }
+            }
+        };
+
+        // Welds split points that land within the snap tolerance. Cells are
+        // much larger than the tolerance, so neighbours are only probed for
+        // points right at a cell border.
+        struct NodeMap {
+            double tol, inv;
+            std::vector<Point> nodes;
+            std::unordered_map<uint64_t, uint32_t> cells;
+            std::vector<uint32_t> chain;
+
+            explicit NodeMap(double tolerance) : tol(tolerance), inv(1.0 / (tolerance * 64.0)) {}
+
+            static uint64_t key(int64_t cx, int64_t cy) {
+                return (uint64_t)cx * 0x9E3779B97F4A7C15ull ^ ((uint64_t)cy + 0x632BE59BD9B4E019ull);
+            }
+
+            uint32_t probe(int64_t cx, int64_t cy, const Point& p) const {
+                auto it = cells.find(key(cx, cy));
+                if (it == cells.end()) return UINT32_MAX;
+                for (uint32_t i = it->second; i != UINT32_MAX; i = chain[i]) {
+                    if (std::abs(nodes[i].x - p.x) <= tol && std::abs(nodes[i].y - p.y) <= tol) return i;
+                }
+                return UINT32_MAX;
+            }
+
+            uint32_t get(const Point& p) {
+                double fx = p.x * inv, fy = p.y * inv;
+                int64_t cx = (int64_t)std::floor(fx), cy = (int64_t)std::floor(fy);
+                uint32_t found = probe(cx, cy, p);
+                if (found != UINT32_MAX) return found;
+
+                double edge = tol * inv;
+                int dx = fx - cx < edge ? -1 : (fx - cx > 1.0 - edge ? 1 : 0);
+                int dy = fy - cy < edge ? -1 : (fy - cy > 1.0 - edge ? 1 : 0);
+                if (dx && (found = probe(cx + dx, cy, p)) != UINT32_MAX) return found;
+                if (dy && (found = probe(cx, cy + dy, p)) != UINT32_MAX) return found;
+                if (dx && dy && (found = probe(cx + dx, cy + dy, p)) != UINT32_MAX) return found;
+
+                uint32_t id = (uint32_t)nodes.size();
+                nodes.push_back(p);
+                auto res = cells.emplace(key(cx, cy), id);
+                chain.push_back(res.second ? UINT32_MAX : res.first->second);
+                res.first->second = id;
+                return id;
+            }
+        };
+
+        struct Piece {
+            uint32_t u, v;   // canonical direction u → v (u < v)
+            int multiplicity; // (# u→v) - (# v→u)
+        };
+
+        struct SegmentPiece {
+            uint32_t piece;
+            uint32_t from, to;
+        };
+    }
+
+    std::vector<std::vector<Point>> WindingOverlay::resolve(
+        const std::vector<std::vector<Point>>& rings,
+        int minWinding) {
+        return resolve(RingSpan::of(rings), minWinding);
+    }
+
+    std::vector<std::vector<Point>> WindingOverlay::resolve(
+        const std::vector<RingSpan>& rings,
+        int minWinding) {
+        std::vector<std::vector<Point>> result;
+
+        // ==================== Segments ====================
+        std::vector<Segment> segs;
+        double x0 = HUGE_VAL, y0 = HUGE_VAL, x1 = -HUGE_VAL, y1 = -HUGE_VAL;
+        for (const auto& ring : rings) {
+            if (ring.size() < 3) continue;
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                const Point& a = ring[j];
+                const Point& b = ring[i];
+                if (a.x == b.x && a.y == b.y) continue;
+                segs.push_back({ a, b });
+                x0 = std::min(x0, a.x); x1 = std::max(x1, a.x);
+                y0 = std::min(y0, a.y); y1 = std::max(y1, a.y);
+            }
+        }
+        if (segs.size() < 3) return result;
+
+        double extent = std::max(std::max(x1 - x0, y1 - y0), std::max(std::abs(x0), std::abs(y0)));
+        extent = std::max(extent, std::max(std::abs(x1), std::abs(y1)));
+        const double snap = std::max(extent, 1e-300) * 1e-12;
+
+        SegmentGrid grid;
+        grid.build(segs, x0, y0, x1, y1, snap);
+
+        // ==================== Split points ====================
+        std::vector<std::pair<uint32_t, double>> splits;
+        auto addSplit = [&](uint32_t s, double t) {
+            if (t > 0.0 && t < 1.0) splits.emplace_back(s, t);
+            };
+
+        auto touches = [&](const Point& p, const Segment& seg, uint32_t id) {
+            Point d = seg.b - seg.a;
+            double dd = d.dot(d);
+            double t = (p - seg.a).dot(d) / dd;
+            if (t < 0.0 || t > 1.0) return false;
+            Point c(seg.a.x + t * d.x, seg.a.y + t * d.y);
+            if (std::abs(c.x - p.x) > snap * 2.0 || std::abs(c.y - p.y) > snap * 2.0) return false;
+            addSplit(id, t);
+            return true;
+            };
+
+        std::vector<uint32_t> stamp(segs.size(), UINT32_MAX);
+        for (uint32_t si = 0; si < segs.size(); si++) {
+            const Segment& s = segs[si];
+            grid.forCells(s, [&](int cell) {
+                for (uint32_t k = grid.start[cell]; k < grid.start[cell + 1]; k++) {
+                    const uint32_t sj = grid.items[k];
+                    if (sj <= si || stamp[sj] == si) continue;
+                    stamp[sj] = si;
+                    const Segment& o = segs[sj];
+
+                    if (std::max(std::min(s.a.x, s.b.x), std::min(o.a.x, o.b.x)) >
+                        std::min(std::max(s.a.x, s.b.x), std::max(o.a.x, o.b.x)) + snap) continue;
+                    if (std::max(std::min(s.a.y, s.b.y), std::min(o.a.y, o.b.y)) >
+                        std::min(std::max(s.a.y, s.b.y), std::max(o.a.y, o.b.y)) + snap) continue;
+
+                    Point r = s.b - s.a;
+                    Point q = o.b - o.a;
+                    Point w = o.a - s.a;
+                    double rr = r.dot(r), qq = q.dot(q);
+                    double det = r.cross(q);
+
+                    if (std::abs(det) <= 1e-12 * std::sqrt(rr * qq)) {
+                        // Parallel: only collinear overlaps matter
+                        if (std::abs(w.cross(r)) > snap * std::sqrt(rr)) continue;
+                        addSplit(si, w.dot(r) / rr);
+                        addSplit(si, (o.b - s.a).dot(r) / rr);
+                        addSplit(sj, (s.a - o.a).dot(q) / qq);
+                        addSplit(sj, (s.b - o.a).dot(q) / qq);
+                        continue;
+                    }
+
+                    // Endpoints touching the other segment split it there
+                    // (the split welds onto the endpoint's node), so
+                    // shallow crossings near a vertex are never lost
+                    // between the two segments meeting at it
+                    bool touch = false;
+                    touch |= touches(o.a, s, si);
+                    touch |= touches(o.b, s, si);
+                    touch |= touches(s.a, o, sj);
+                    touch |= touches(s.b, o, sj);
+                    if (touch) continue;
+
+                    double t = w.cross(q) / det;
+                    double u = w.cross(r) / det;
+                    if (t <= 0.0 || t >= 1.0 || u <= 0.0 || u >= 1.0) continue;
+                    addSplit(si, t);
+                    addSplit(sj, u);
+                }
+                });
+        }
+        std::sort(splits.begin(), splits.end());
+
+        // ==================== Pieces ====================
+        NodeMap nodes(snap * 4.0);
+        nodes.cells.reserve(segs.size() + splits.size());
+        std::vector<Piece> pieces;
+        std::unordered_map<uint64_t, uint32_t> pieceIndex;
+        pieceIndex.reserve(segs.size() + splits.size());
+
+        // Pieces of every input segment, in the segment's own direction
+        std::vector<SegmentPiece> segPieces;
+        std::vector<uint32_t> segPieceStart(segs.size() + 1, 0);
+        segPieces.reserve(segs.size() + splits.size());
+
+        auto addPiece = [&](uint32_t a, uint32_t b) {
+            if (a == b) return;
+            uint64_t k = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+            auto res = pieceIndex.emplace(k, (uint32_t)pieces.size());
+            if (res.second) pieces.push_back({ std::min(a, b), std::max(a, b), 0 });
+            pieces[res.first->second].multiplicity += a < b ? 1 : -1;
+            segPieces.push_back({ res.first->second, a, b });
+            };
+
+        size_t sp = 0;
+        for (uint32_t s = 0; s < segs.size(); s++) {
+            const Segment& seg = segs[s];
+            uint32_t prev = nodes.get(seg.a);
+            for (; sp < splits.size() && splits[sp].first == s; sp++) {
+                double t = splits[sp].second;
+                uint32_t n = nodes.get(Point(seg.a.x + t * (seg.b.x - seg.a.x), seg.a.y + t * (seg.b.y - seg.a.y)));
+                addPiece(prev, n);
+                prev = n;
+            }
+            addPiece(prev, nodes.get(seg.b));
+            segPieceStart[s + 1] = (uint32_t)segPieces.size();
+        }
+
+        const std::vector<Point>& pos = nodes.nodes;
+        const size_t nodeCount = pos.size();
+
+        // ==================== Arrangement faces ====================
+        // Half-edge 2p runs u → v along piece p, 2p + 1 runs v → u. Pieces
+        // whose directions cancel out do not change the winding anywhere
+        // and are left out of the arrangement.
+        auto tail = [&](uint32_t h) { return (h & 1) ? pieces[h >> 1].v : pieces[h >> 1].u; };
+        auto head = [&](uint32_t h) { return (h & 1) ? pieces[h >> 1].u : pieces[h >> 1].v; };
+
+        std::vector<uint32_t> nodeStart(nodeCount + 1, 0);
+        for (const Piece& p : pieces) {
+            if (p.multiplicity == 0) continue;
+            nodeStart[p.u + 1]++;
+            nodeStart[p.v + 1]++;
+        }
+        for (size_t i = 0; i < nodeCount; i++) nodeStart[i + 1] += nodeStart[i];
+
+        std::vector<std::pair<double, uint32_t>> around(nodeStart.back()); // angle, half-edge
+        {
+            std::vector<uint32_t> fill(nodeStart.begin(), nodeStart.end() - 1);
+            for (uint32_t p = 0; p < pieces.size(); p++) {
+                if (pieces[p].multiplicity == 0) continue;
+                Point d = pos[pieces[p].v] - pos[pieces[p].u];
+                around[fill[pieces[p].u]++] = { std::atan2(d.y, d.x), 2 * p };
+                around[fill[pieces[p].v]++] = { std::atan2(-d.y, -d.x), 2 * p + 1 };
+            }
+        }
+        std::vector<uint32_t> slot(pieces.size() * 2, UINT32_MAX);
+        for (size_t i = 0; i < nodeCount; i++) {
+            std::sort(around.begin() + nodeStart[i], around.begin() + nodeStart[i + 1]);
+            for (uint32_t k = nodeStart[i]; k < nodeStart[i + 1]; k++) slot[around[k].second] = k;
+        }
+
+        // Next half-edge around the face on the left: the first outgoing
+        // edge clockwise from the way we came in
+        auto next = [&](uint32_t h) {
+            uint32_t v = head(h);
+            uint32_t k = slot[h ^ 1];
+            return around[k == nodeStart[v] ? nodeStart[v + 1] - 1 : k - 1].second;
+            };
+
+        std::vector<uint32_t> face(pieces.size() * 2, UINT32_MAX);
+        std::vector<uint32_t> faceStart{ 0 };
+        std::vector<uint32_t> faceEdges;
+        std::vector<double> faceArea;
+        faceEdges.reserve(around.size());
+        for (const auto& entry : around) {
+            uint32_t h0 = entry.second;
+            if (face[h0] != UINT32_MAX) continue;
+            uint32_t id = (uint32_t)faceArea.size();
+            double a2 = 0;
+            uint32_t h = h0;
+            do {
+                face[h] = id;
+                faceEdges.push_back(h);
+                a2 += pos[tail(h)].cross(pos[head(h)]);
+                h = next(h);
+            } while (h != h0 && face[h] == UINT32_MAX);
+            faceArea.push_back(a2);
+            faceStart.push_back((uint32_t)faceEdges.size());
+        }
+
+        // Connected components of the arrangement
+        std::vector<uint32_t> comp(nodeCount);
+        for (uint32_t i = 0; i < nodeCount; i++) comp[i] = i;
+        auto find = [&](uint32_t x) {
+            while (comp[x] != x) x = comp[x] = comp[comp[x]];
+            return x;
+            };
+        for (const Piece& p : pieces) {
+            if (p.multiplicity != 0) comp[find(p.u)] = find(p.v);
+        }
+        for (uint32_t i = 0; i < nodeCount; i++) comp[i] = find(i);
+
+        // ==================== Winding classification ====================
+        // The outer face of each component (negative area) gets its winding
+        // from a single ray cast against the other components; every other
+        // face follows by stepping across pieces: left = right + multiplicity.
+        std::fill(stamp.begin(), stamp.end(), UINT32_MAX);
+        uint32_t query = 0;
+        auto windingOutside = [&](const Point& m, uint32_t c) {
+            query++;
+            int w = 0;
+            int r = grid.row(m.y);
+            auto first = grid.rowCells.begin() + grid.rowStart[r];
+            auto last = grid.rowCells.begin() + grid.rowStart[r + 1];
+            for (auto it = std::lower_bound(first, last, (uint32_t)grid.col(m.x)); it != last; ++it) {
+                int cell = r * grid.cols + (int)*it;
+                for (uint32_t k = grid.start[cell]; k < grid.start[cell + 1]; k++) {
+                    uint32_t id = grid.items[k];
+                    if (stamp[id] == query) continue;
+                    stamp[id] = query;
+                    for (uint32_t j = segPieceStart[id]; j < segPieceStart[id + 1]; j++) {
+                        const SegmentPiece& sp = segPieces[j];
+                        if (pieces[sp.piece].multiplicity == 0 || comp[sp.from] == c) continue;
+                        const Point& a = pos[sp.from];
+                        const Point& b = pos[sp.to];
+                        if ((a.y <= m.y) == (b.y <= m.y)) continue;
+                        double x = a.x + (m.y - a.y) * (b.x - a.x) / (b.y - a.y);
+                        if (x > m.x) w += (b.y > a.y) ? 1 : -1;
+                    }
+                }
+            }
+            return w;
+            };
+
+        const uint32_t faceCount = (uint32_t)faceArea.size();
+        std::vector<uint32_t> outer(nodeCount, UINT32_MAX); // per component root
+        for (uint32_t f = 0; f < faceCount; f++) {
+            uint32_t c = comp[tail(faceEdges[faceStart[f]])];
+            if (outer[c] == UINT32_MAX || faceArea[f] < faceArea[outer[c]]) outer[c] = f;
+        }
+
+        const int unknown = INT32_MIN;
+        std::vector<int> winding(faceCount, unknown);
+        std::vector<uint32_t> queue;
+        queue.reserve(faceCount);
+        for (uint32_t c = 0; c < nodeCount; c++) {
+            uint32_t f = outer[c];
+            if (f == UINT32_MAX) continue;
+            winding[f] = windingOutside(pos[tail(faceEdges[faceStart[f]])], c);
+            queue.push_back(f);
+        }
+        for (size_t qi = 0; qi < queue.size(); qi++) {
+            uint32_t f = queue[qi];
+            for (uint32_t k = faceStart[f]; k < faceStart[f + 1]; k++) {
+                uint32_t h = faceEdges[k];
+                uint32_t g = face[h ^ 1];
+                if (winding[g] != unknown) continue;
+                int d = pieces[h >> 1].multiplicity;
+                winding[g] = winding[f] - ((h & 1) ? -d : d);
+                queue.push_back(g);
+            }
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> kept; // directed, region on the left
+        for (uint32_t p = 0; p < pieces.size(); p++) {
+            if (pieces[p].multiplicity == 0) continue;
+            int left = winding[face[2 * p]];
+            int right = winding[face[2 * p + 1]];
+            if (left == unknown || right == unknown) continue;
+
+            bool inLeft = left >= minWinding;
+            bool inRight = right >= minWinding;
+            if (inLeft == inRight) continue;
+            if (inLeft) kept.emplace_back(pieces[p].u, pieces[p].v);
+            else kept.emplace_back(pieces[p].v, pieces[p].u);
+        }
+
+        // ==================== Link into rings ====================
+        std::vector<uint32_t> offset(nodeCount + 1, 0);
+        for (const auto& e : kept) offset[e.first + 1]++;
+        for (size_t i = 0; i < nodeCount; i++) offset[i + 1] += offset[i];
+
+        std::vector<std::pair<double, uint32_t>> out(kept.size()); // angle, target
+        std::vector<uint32_t> fill(offset.begin(), offset.end() - 1);
+        for (const auto& e : kept) {
+            Point d = pos[e.second] - pos[e.first];
+            out[fill[e.first]++] = { std::atan2(d.y, d.x), e.second };
+        }
+        for (size_t i = 0; i < nodeCount; i++) std::sort(out.begin() + offset[i], out.begin() + offset[i + 1]);
+
+        std::vector<char> used(out.size(), 0);
+        std::vector<Point> ring;
+        for (uint32_t startNode = 0; startNode < nodeCount; startNode++) {
+            for (uint32_t h0 = offset[startNode]; h0 < offset[startNode + 1]; h0++) {
+                if (used[h0]) continue;
+
+                ring.clear();
+                uint32_t from = startNode;
+                uint32_t h = h0;
+                bool closed = false;
+                while (!used[h]) {
+                    used[h] = 1;
+                    ring.push_back(pos[from]);
+                    uint32_t to = out[h].second;
+                    if (offset[to] == offset[to + 1]) break;
+
+                    // First outgoing edge clockwise from the way we came in
+                    Point back = pos[from] - pos[to];
+                    double theta = std::atan2(back.y, back.x);
+                    uint32_t pick = offset[to + 1] - 1;
+                    for (uint32_t k = offset[to]; k < offset[to + 1]; k++) {
+                        if (out[k].first < theta) pick = k;
+                    }
+                    from = to;
+                    h = pick;
+                    if (h == h0) { closed = true; break; }
+                }
+                if (!closed || ring.size() < 3) continue;
+
+                // Drop straight-through vertices left behind by split points
+                std::vector<Point> clean;
+                clean.reserve(ring.size());
+                size_t n = ring.size();
+                for (size_t i = 0; i < n; i++) {
+                    const Point& p = ring[(i + n - 1) % n];
+                    const Point& c = ring[i];
+                    const Point& q = ring[(i + 1) % n];
+                    Point e1 = c - p, e2 = q - c;
+                    double cr = e1.cross(e2);
+                    if (std::abs(cr) <= 1e-12 * std::sqrt(e1.dot(e1) * e2.dot(e2)) && e1.dot(e2) > 0) continue;
+                    clean.push_back(c);
+                }
+                if (clean.size() >= 3) result.push_back(std::move(clean));
+            }
+        }
+
+        return result;
+    }
+
+} // namespace PolygonBoolean
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef WINDINGOVERLAY_H
+#define WINDINGOVERLAY_H
+
+#include <vector>
+#include "Polygon.h"
+#include "RingSpan.h"
+
+namespace PolygonBoolean {
+
+    // Resolves an arbitrary set of closed rings (self-intersecting,
+    // overlapping, sharing edges) into the boundary of the region whose
+    // winding number is at least minWinding.
+    //
+    // With minWinding = 1 this is the non-zero union of the rings: the
+    // self-union used to clean raw offset curves and to merge partial
+    // Minkowski sums. Intersection of two CCW polygons is minWinding = 2,
+    // and A - B is A plus reversed B with minWinding = 1.
+    //
+    // Segments are split at every crossing and collinear overlap (found
+    // through a uniform grid), coincident pieces are merged, and each
+    // piece is kept when the winding on its two sides straddles
+    // minWinding. Output rings are CCW for outer boundaries and CW for
+    // holes.
+    class WindingOverlay {
+    public:
+        static std::vector<std::vector<Point>> resolve(
+            const std::vector<std::vector<Point>>& rings,
+            int minWinding = 1);
+
+        // Same, reading the rings in place; a reversed span contributes
+        // with the opposite winding
+        static std::vector<std::vector<Point>> resolve(
+            const std::vector<RingSpan>& rings,
+            int minWinding = 1);
+    };
+
+} // namespace PolygonBoolean
+
+#endif // WINDINGOVERLAY_H
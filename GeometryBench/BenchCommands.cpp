@@ -0,0 +1,1339 @@
+#include "BenchCommands.h"
+#include "BenchEngines.h"
+#include "PerfCounters.h"
+#include "../GeometryCore/BooleanCache.h"
+#include "../GeometryCore/FlatPolygonStore.h"
+#include "../GeometryCore/GeometryIO.h"
+#include "../GeometryCore/IncrementalBooleanSession.h"
+#include "../GeometryCore/PolygonUtilityExtension.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // "--name value" pairs; returns false on an unknown or dangling flag
+    bool NextArg(int argc, char** argv, int& i, std::string& flag, const char*& value)
+    {
+        flag = argv[i];
+        if (flag.compare(0, 2, "--") != 0 || i + 1 >= argc)
+            return false;
+        value = argv[++i];
+        return true;
+    }
+
+    int FileNumber(FILE* f)
+    {
+#ifdef _WIN32
+        return _fileno(f);
+#else
+        return fileno(f);
+#endif
+    }
+
+    // ---------------------------------------------------------------
+    // gen
+    // ---------------------------------------------------------------
+
+    int WritePolygons(const std::vector<Polygon>& polys, const std::string& format, const char* out)
+    {
+        if (format == "flat")
+        {
+            if (!out)
+            {
+                fprintf(stderr, "gen: --format flat needs --out\n");
+                return 2;
+            }
+            FlatPolygonWriter writer(out);
+            writer.Add(polys);
+            writer.Finish();
+            return 0;
+        }
+
+        FILE* f = out ? fopen(out, "wb") : stdout;
+        if (!f)
+        {
+            fprintf(stderr, "gen: cannot write %s\n", out);
+            return 1;
+        }
+        {
+            ByteSink sink = ByteSink::ToFd(FileNumber(f));
+            if (format == "wkb")
+            {
+                WkbWriter writer(sink);
+                for (const Polygon& p : polys)
+                    writer.Write(p);
+            }
+            else
+            {
+                WktWriter writer(sink);
+                for (const Polygon& p : polys)
+                    writer.Write(p);
+            }
+            sink.Flush();
+        }
+        if (f != stdout)
+            fclose(f);
+        return 0;
+    }
+
+    // ---------------------------------------------------------------
+    // sweep
+    // ---------------------------------------------------------------
+
+    // One timed unit: an engine over every pair of a workload, or a kernel
+    struct SweepTarget
+    {
+        std::string name;
+        const BenchEngine* engine; // null for kernels
+        bool byDefault;
+    };
+
+    // Polygonutility::RemoveDuplicates over every input vertex
+    void RunRemoveDuplicates(const Workload& w)
+    {
+        std::vector<Point> pts;
+        pts.reserve(w.VertexCount());
+        for (const auto* side : { &w.a, &w.b })
+        {
+            for (const Polygon& p : *side)
+            {
+                pts.insert(pts.end(), p.outer.vertices.begin(), p.outer.vertices.end());
+                for (const Ring& h : p.holes)
+                    pts.insert(pts.end(), h.vertices.begin(), h.vertices.end());
+            }
+        }
+        Polygonutility util;
+        util.RemoveDuplicates(pts);
+    }
+
+    std::vector<SweepTarget> SweepTargets()
+    {
+        std::vector<SweepTarget> targets;
+        for (const BenchEngine& e : BenchEngines())
+            targets.push_back({ e.name, &e, e.byDefault });
+        targets.push_back({ "remove-duplicates", nullptr, true });
+        return targets;
+    }
+
+    struct SweepPoint
+    {
+        size_t vertices;
+        double seconds; // median per call
+    };
+
+    struct SweepResult
+    {
+        std::string target;
+        std::string kind;
+        std::vector<SweepPoint> points;
+        double exponent = 0;
+        double r2 = 0;
+        double tailExponent = 0;
+        bool flagged = false;
+        std::string error;
+    };
+
+    // Least squares on log(time) = e * log(n) + c. Calls below 50 us are
+    // mostly fixed overhead and timer noise, so they only count when too
+    // few slower points exist.
+    void Fit(SweepResult& r)
+    {
+        std::vector<SweepPoint> use;
+        for (const SweepPoint& p : r.points)
+        {
+            if (p.seconds >= 50e-6)
+                use.push_back(p);
+        }
+        if (use.size() < 3)
+        {
+            size_t from = r.points.size() > 3 ? r.points.size() - 3 : 0;
+            use.assign(r.points.begin() + from, r.points.end());
+        }
+        if (use.size() < 2)
+            return;
+
+        double sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+        for (const SweepPoint& p : use)
+        {
+            double x = std::log(static_cast<double>(p.vertices));
+            double y = std::log(std::max(p.seconds, 1e-9));
+            sx += x; sy += y; sxx += x * x; sxy += x * y; syy += y * y;
+        }
+        double n = static_cast<double>(use.size());
+        double vx = sxx - sx * sx / n;
+        double vy = syy - sy * sy / n;
+        double cxy = sxy - sx * sy / n;
+        if (vx <= 0)
+            return;
+        r.exponent = cxy / vx;
+        r.r2 = vy > 0 ? cxy * cxy / (vx * vy) : 1;
+
+        const SweepPoint& p0 = use[use.size() - 2];
+        const SweepPoint& p1 = use.back();
+        r.tailExponent = std::log(std::max(p1.seconds, 1e-9) / std::max(p0.seconds, 1e-9))
+            / std::log(static_cast<double>(p1.vertices) / p0.vertices);
+    }
+
+    struct SweepOptions
+    {
+        std::vector<std::string> targets;
+        std::vector<WorkloadKind> kinds;
+        BoolOp op = BoolOp::Union;
+        size_t minVertices = 10;
+        size_t maxVertices = 10000000;
+        double factor = 4;
+        double minTime = 0.2;
+        double maxCallSec = 1.0;
+        double maxExponent = 1.5;
+        unsigned seed = 42;
+        const char* out = nullptr;
+    };
+
+    double TimeCall(const SweepTarget& target, const Workload& w, const std::vector<BenchPair>& pairs, BoolOp op)
+    {
+        Clock::time_point t0 = Clock::now();
+        if (target.engine)
+        {
+            for (const BenchPair& pair : pairs)
+                target.engine->Run(pair, op);
+        }
+        else
+        {
+            RunRemoveDuplicates(w);
+        }
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    SweepResult Sweep(const SweepTarget& target, WorkloadKind kind, const SweepOptions& opt)
+    {
+        SweepResult r;
+        r.target = target.name;
+        r.kind = WorkloadGenerator::KindName(kind);
+
+        double size = static_cast<double>(opt.minVertices);
+        while (size <= static_cast<double>(opt.maxVertices) + 0.5)
+        {
+            size_t n = static_cast<size_t>(size + 0.5);
+            size *= opt.factor;
+
+            WorkloadGenerator gen(opt.seed);
+            Workload w = gen.Generate(kind, n);
+            std::vector<BenchPair> pairs;
+            if (target.engine)
+                pairs = MakeBenchPairs(r.kind, w, target.engine->usesNative);
+
+            std::vector<double> samples;
+            try
+            {
+                double total = 0;
+                while (samples.size() < 3 || total < opt.minTime)
+                {
+                    double s = TimeCall(target, w, pairs, opt.op);
+                    samples.push_back(s);
+                    total += s;
+                    if (s > opt.maxCallSec)
+                        break;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                r.error = e.what();
+                break;
+            }
+
+            std::sort(samples.begin(), samples.end());
+            double median = samples[samples.size() / 2];
+            r.points.push_back({ w.VertexCount(), median });
+            fprintf(stderr, "%-20s %-12s %10zu vertices %12.6f s\n",
+                r.target.c_str(), r.kind.c_str(), w.VertexCount(), median);
+
+            if (median > opt.maxCallSec)
+                break;
+        }
+
+        Fit(r);
+        r.flagged = r.points.size() >= 3 && r.exponent > opt.maxExponent;
+        return r;
+    }
+
+    void WriteSweepJson(FILE* f, const std::vector<SweepResult>& results, const SweepOptions& opt)
+    {
+        fprintf(f, "{\n  \"seed\": %u,\n  \"op\": \"%s\",\n  \"maxExponent\": %g,\n  \"results\": [",
+            opt.seed, OpName(opt.op), opt.maxExponent);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const SweepResult& r = results[i];
+            fprintf(f, "%s\n    { \"target\": \"%s\", \"kind\": \"%s\",\n", i ? "," : "", r.target.c_str(), r.kind.c_str());
+            fprintf(f, "      \"exponent\": %.4f, \"r2\": %.4f, \"tailExponent\": %.4f, \"flagged\": %s,\n",
+                r.exponent, r.r2, r.tailExponent, r.flagged ? "true" : "false");
+            if (!r.error.empty())
+            {
+                fprintf(f, "      \"error\": ");
+                JsonString(f, r.error);
+                fprintf(f, ",\n");
+            }
+            fprintf(f, "      \"points\": [");
+            for (size_t k = 0; k < r.points.size(); k++)
+                fprintf(f, "%s{ \"vertices\": %zu, \"seconds\": %.6g }", k ? ", " : "", r.points[k].vertices, r.points[k].seconds);
+            fprintf(f, "] }");
+        }
+        fprintf(f, "\n  ]\n}\n");
+    }
+}
+
+int RunGenerate(int argc, char** argv)
+{
+    WorkloadKind kind = WorkloadKind::Star;
+    size_t vertices = 1000;
+    unsigned seed = 42;
+    std::string format = "wkt";
+    std::string side = "both";
+    const char* out = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "gen: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--kind")
+        {
+            if (!WorkloadGenerator::ParseKind(value, kind))
+            {
+                fprintf(stderr, "gen: unknown kind %s\n", value);
+                return 2;
+            }
+        }
+        else if (flag == "--vertices")
+            vertices = static_cast<size_t>(std::strtod(value, nullptr));
+        else if (flag == "--seed")
+            seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--format")
+            format = value;
+        else if (flag == "--side")
+            side = value;
+        else if (flag == "--out")
+            out = value;
+        else
+        {
+            fprintf(stderr, "gen: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+    if (format != "wkt" && format != "wkb" && format != "flat")
+    {
+        fprintf(stderr, "gen: --format must be wkt, wkb or flat\n");
+        return 2;
+    }
+
+    WorkloadGenerator gen(seed);
+    Workload w = gen.Generate(kind, vertices);
+
+    std::vector<Polygon> polys;
+    if (side != "b")
+        polys.insert(polys.end(), w.a.begin(), w.a.end());
+    if (side != "a")
+        polys.insert(polys.end(), w.b.begin(), w.b.end());
+
+    try
+    {
+        return WritePolygons(polys, format, out);
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "gen: %s\n", e.what());
+        return 1;
+    }
+}
+
+int RunSweep(int argc, char** argv)
+{
+    SweepOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "sweep: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--target")
+        {
+            std::vector<SweepTarget> targets = SweepTargets();
+            bool known = std::any_of(targets.begin(), targets.end(),
+                [&](const SweepTarget& t) { return t.name == value; });
+            if (!known)
+            {
+                fprintf(stderr, "sweep: unknown target %s\n", value);
+                return 2;
+            }
+            opt.targets.push_back(value);
+        }
+        else if (flag == "--kind")
+        {
+            WorkloadKind kind;
+            if (!WorkloadGenerator::ParseKind(value, kind))
+            {
+                fprintf(stderr, "sweep: unknown kind %s\n", value);
+                return 2;
+            }
+            opt.kinds.push_back(kind);
+        }
+        else if (flag == "--op")
+        {
+            std::string name = value;
+            bool found = false;
+            for (BoolOp op : { BoolOp::Union, BoolOp::Intersection, BoolOp::AminusB, BoolOp::BminusA })
+            {
+                if (name == OpName(op))
+                {
+                    opt.op = op;
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                fprintf(stderr, "sweep: unknown op %s\n", value);
+                return 2;
+            }
+        }
+        else if (flag == "--min")
+            opt.minVertices = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 3);
+        else if (flag == "--max")
+            opt.maxVertices = static_cast<size_t>(std::strtod(value, nullptr));
+        else if (flag == "--factor")
+            opt.factor = std::max(std::atof(value), 1.25);
+        else if (flag == "--min-time")
+            opt.minTime = std::atof(value);
+        else if (flag == "--max-call-sec")
+            opt.maxCallSec = std::atof(value);
+        else if (flag == "--max-exponent")
+            opt.maxExponent = std::atof(value);
+        else if (flag == "--seed")
+            opt.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--out")
+            opt.out = value;
+        else
+        {
+            fprintf(stderr, "sweep: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+    if (opt.kinds.empty())
+        opt.kinds = WorkloadGenerator::AllKinds();
+
+    std::vector<SweepResult> results;
+    for (const SweepTarget& target : SweepTargets())
+    {
+        bool wanted = opt.targets.empty()
+            ? target.byDefault
+            : std::find(opt.targets.begin(), opt.targets.end(), target.name) != opt.targets.end();
+        if (!wanted)
+            continue;
+        for (WorkloadKind kind : opt.kinds)
+        {
+            results.push_back(Sweep(target, kind, opt));
+            const SweepResult& r = results.back();
+            if (r.flagged)
+            {
+                fprintf(stderr, "FLAG %s on %s scales as n^%.2f (limit %.2f)\n",
+                    r.target.c_str(), r.kind.c_str(), r.exponent, opt.maxExponent);
+            }
+        }
+    }
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "sweep: cannot write %s\n", opt.out);
+        return 1;
+    }
+    WriteSweepJson(f, results, opt);
+    if (f != stdout)
+        fclose(f);
+
+    for (const SweepResult& r : results)
+    {
+        if (r.flagged)
+            return 3;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------
+// micro
+// ---------------------------------------------------------------
+
+namespace
+{
+    struct MicroOptions
+    {
+        std::vector<std::string> primitives;
+        size_t batch = 1 << 16;
+        size_t vertices = 64;
+        double minTime = 0.2;
+        unsigned seed = 42;
+        const char* out = nullptr;
+    };
+
+    // Inputs in every representation, built before any timing: segment
+    // tests read 4 points per call (p1 p2 q1 q2), point-in-polygon tests
+    // one point against ring
+    struct MicroData
+    {
+        std::vector<Point> segments;
+        std::vector<Point> points;
+        Ring ring;
+
+        std::vector<PolygonBoolean::Point> nativeSegments;
+        std::vector<PolygonBoolean::Point> nativePoints;
+        std::vector<PolygonBoolean::Point> nativeRing;
+    };
+
+    // A primitive run over the whole batch reps times; returns the number
+    // of true results so the calls cannot be optimized away
+    struct MicroPrimitive
+    {
+        const char* name;
+        const char* kind; // "segment" or "pointInPolygon"
+        size_t (*Run)(const MicroData& data, size_t reps);
+    };
+
+    double microSink = 0; // intersection coordinates land here, for the same reason
+
+    size_t RunUtilitySegment(const MicroData& d, size_t reps)
+    {
+        Polygonutility util;
+        size_t hits = 0;
+        double sum = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (size_t i = 0; i + 3 < d.segments.size(); i += 4)
+            {
+                Point ip;
+                if (util.SegmentIntersect(d.segments[i], d.segments[i + 1], d.segments[i + 2], d.segments[i + 3], ip))
+                {
+                    hits++;
+                    sum += ip.x;
+                }
+            }
+        }
+        microSink += sum;
+        return hits;
+    }
+
+    size_t RunExtensionSegment(const MicroData& d, size_t reps)
+    {
+        PolygonUtilityExtension gh;
+        size_t hits = 0;
+        double sum = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (size_t i = 0; i + 3 < d.segments.size(); i += 4)
+            {
+                Point ip;
+                double ta, tb;
+                if (gh.SegmentIntersect(d.segments[i], d.segments[i + 1], d.segments[i + 2], d.segments[i + 3], ip, ta, tb))
+                {
+                    hits++;
+                    sum += ip.x;
+                }
+            }
+        }
+        microSink += sum;
+        return hits;
+    }
+
+    size_t RunNativeSegment(const MicroData& d, size_t reps)
+    {
+        const std::vector<PolygonBoolean::Point>& s = d.nativeSegments;
+        size_t hits = 0;
+        double sum = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (size_t i = 0; i + 3 < s.size(); i += 4)
+            {
+                PolygonBoolean::Point ip;
+                double t1, t2;
+                if (PolygonBoolean::Polygon::lineSegmentIntersection(s[i], s[i + 1], s[i + 2], s[i + 3], ip, t1, t2))
+                {
+                    hits++;
+                    sum += ip.x;
+                }
+            }
+        }
+        microSink += sum;
+        return hits;
+    }
+
+    size_t RunUtilityPip(const MicroData& d, size_t reps)
+    {
+        Polygonutility util;
+        size_t hits = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (const Point& p : d.points)
+                hits += util.PointInRing(p, d.ring);
+        }
+        return hits;
+    }
+
+    size_t RunExtensionPip(const MicroData& d, size_t reps)
+    {
+        PolygonUtilityExtension gh;
+        RingView ring(d.ring);
+        size_t hits = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (const Point& p : d.points)
+                hits += gh.PointInsidePolygon(ring, p);
+        }
+        return hits;
+    }
+
+    size_t RunNativePip(const MicroData& d, size_t reps)
+    {
+        size_t hits = 0;
+        for (size_t r = 0; r < reps; r++)
+        {
+            for (const PolygonBoolean::Point& p : d.nativePoints)
+                hits += PolygonBoolean::Polygon::pointInPolygon(p, d.nativeRing) != 0;
+        }
+        return hits;
+    }
+
+    const std::vector<MicroPrimitive>& MicroPrimitives()
+    {
+        static const std::vector<MicroPrimitive> primitives = {
+            { "segment.utility", "segment", RunUtilitySegment },
+            { "segment.extension", "segment", RunExtensionSegment },
+            { "segment.native", "segment", RunNativeSegment },
+            { "pip.utility", "pointInPolygon", RunUtilityPip },
+            { "pip.extension", "pointInPolygon", RunExtensionPip },
+            { "pip.native", "pointInPolygon", RunNativePip },
+        };
+        return primitives;
+    }
+
+    // Segment endpoints uniform in the unit square (roughly a fifth of the
+    // pairs cross); query points uniform over the star's bounding box
+    MicroData MakeMicroData(const MicroOptions& opt)
+    {
+        std::mt19937_64 rng(opt.seed);
+        auto uniform = [&](double lo, double hi)
+            {
+                return lo + (hi - lo) * (static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0));
+            };
+
+        MicroData d;
+        d.segments.resize(opt.batch * 4);
+        for (Point& p : d.segments)
+            p = { uniform(0, 1), uniform(0, 1) };
+        d.points.resize(opt.batch);
+        for (Point& p : d.points)
+            p = { uniform(-1, 1), uniform(-1, 1) };
+        d.ring = WorkloadGenerator(opt.seed).Star(opt.vertices, { 0, 0 }, 1).outer;
+
+        for (const Point& p : d.segments)
+            d.nativeSegments.emplace_back(p.x, p.y);
+        for (const Point& p : d.points)
+            d.nativePoints.emplace_back(p.x, p.y);
+        for (const Point& p : d.ring.vertices)
+            d.nativeRing.emplace_back(p.x, p.y);
+        return d;
+    }
+
+    struct MicroResult
+    {
+        const char* name;
+        const char* kind;
+        size_t calls = 0;
+        double hitRate = 0;
+        double nsPerCall = 0;
+        double perCall[PerfCounters::CounterCount] = {};
+    };
+
+    // Doubles the repetitions until one run lasts minTime; the counters
+    // and clock cover that last run only
+    MicroResult RunMicroPrimitive(const MicroPrimitive& prim, const MicroData& data, PerfCounters& counters,
+        const MicroOptions& opt)
+    {
+        size_t batch = prim.kind[0] == 's' ? data.segments.size() / 4 : data.points.size();
+        prim.Run(data, 1); // warm caches and branch predictors
+
+        size_t reps = 1;
+        for (;;)
+        {
+            counters.Start();
+            Clock::time_point start = Clock::now();
+            size_t hits = prim.Run(data, reps);
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            counters.Stop();
+
+            if (seconds >= opt.minTime || reps >= (size_t(1) << 30))
+            {
+                MicroResult r;
+                r.name = prim.name;
+                r.kind = prim.kind;
+                r.calls = reps * batch;
+                r.hitRate = static_cast<double>(hits) / r.calls;
+                r.nsPerCall = seconds * 1e9 / r.calls;
+                for (int c = 0; c < PerfCounters::CounterCount; c++)
+                    r.perCall[c] = counters.Value(static_cast<PerfCounters::Counter>(c)) / r.calls;
+                return r;
+            }
+            reps *= 2;
+        }
+    }
+
+    void WriteMicroJson(FILE* f, const std::vector<MicroResult>& results, const PerfCounters& counters,
+        const MicroOptions& opt)
+    {
+        fprintf(f, "{\n  \"seed\": %u,\n  \"batch\": %zu,\n  \"ringVertices\": %zu,\n",
+            opt.seed, opt.batch, opt.vertices);
+        if (!counters.Error().empty())
+            fprintf(f, "  \"counterError\": \"%s\",\n", counters.Error().c_str());
+        fprintf(f, "  \"results\": [");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const MicroResult& r = results[i];
+            fprintf(f, "%s\n    { \"primitive\": \"%s\", \"kind\": \"%s\", \"calls\": %zu, \"hitRate\": %.4f,\n",
+                i ? "," : "", r.name, r.kind, r.calls, r.hitRate);
+            fprintf(f, "      \"nsPerCall\": %.4g", r.nsPerCall);
+            for (int c = 0; c < PerfCounters::CounterCount; c++)
+            {
+                PerfCounters::Counter counter = static_cast<PerfCounters::Counter>(c);
+                if (counters.Available(counter))
+                    fprintf(f, ", \"%sPerCall\": %.4g", PerfCounters::Name(counter), r.perCall[c]);
+            }
+            if (counters.Available(PerfCounters::Cycles) && counters.Available(PerfCounters::Instructions)
+                && r.perCall[PerfCounters::Cycles] > 0)
+                fprintf(f, ", \"ipc\": %.3f", r.perCall[PerfCounters::Instructions] / r.perCall[PerfCounters::Cycles]);
+            fprintf(f, " }");
+        }
+        fprintf(f, "\n  ]\n}\n");
+    }
+}
+
+int RunMicro(int argc, char** argv)
+{
+    MicroOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "micro: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--primitive")
+            opt.primitives.push_back(value);
+        else if (flag == "--batch")
+            opt.batch = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 1);
+        else if (flag == "--vertices")
+            opt.vertices = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 3);
+        else if (flag == "--min-time")
+            opt.minTime = std::atof(value);
+        else if (flag == "--seed")
+            opt.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--out")
+            opt.out = value;
+        else
+        {
+            fprintf(stderr, "micro: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+
+    MicroData data = MakeMicroData(opt);
+    PerfCounters counters;
+    if (!counters.Error().empty())
+        fprintf(stderr, "micro: %s; reporting wall time only for missing counters\n", counters.Error().c_str());
+
+    std::vector<MicroResult> results;
+    for (const MicroPrimitive& prim : MicroPrimitives())
+    {
+        bool wanted = opt.primitives.empty() || std::any_of(opt.primitives.begin(), opt.primitives.end(),
+            [&](const std::string& p) { return std::string(prim.name).compare(0, p.size(), p) == 0; });
+        if (!wanted)
+            continue;
+
+        results.push_back(RunMicroPrimitive(prim, data, counters, opt));
+        const MicroResult& r = results.back();
+        if (counters.Available(PerfCounters::Cycles))
+            fprintf(stderr, "%-18s %8.2f ns/call %8.1f cycles/call\n", r.name, r.nsPerCall, r.perCall[PerfCounters::Cycles]);
+        else
+            fprintf(stderr, "%-18s %8.2f ns/call\n", r.name, r.nsPerCall);
+    }
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "micro: cannot write %s\n", opt.out);
+        return 1;
+    }
+    WriteMicroJson(f, results, counters, opt);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
+
+// ---------------------------------------------------------------
+// replay
+// ---------------------------------------------------------------
+
+namespace
+{
+    struct ReplayOptions
+    {
+        const char* log = nullptr;
+        const char* engine = "recorded";
+        size_t reps = 5;
+        double areaTolerance = 1e-9;
+        const char* out = nullptr;
+    };
+
+    struct ReplayResult
+    {
+        size_t index;
+        CallEngine engine;
+        BoolOp op;
+        size_t inputVertices;
+        double recordedUs;
+        double replayUs; // fastest of reps
+        CallOutput recorded;
+        CallOutput replayed;
+        bool changed;
+        std::string error;
+    };
+
+    CallOutput ReplayCall(CallEngine engine, const CallRecord& rec)
+    {
+        BooleanOps ops;
+        CallOutput out;
+        if (engine == CallEngine::SutherlandHodgman)
+            out.Add(ops.ComputeBoolean(rec.a, rec.b, rec.op));
+        else
+            ops.ComputeBoolean2(rec.a, rec.b, rec.op, [&](RingView loop) { out.Add(loop); });
+        return out;
+    }
+
+    bool OutputChanged(const CallOutput& a, const CallOutput& b, double tolerance)
+    {
+        double scale = std::max({ std::fabs(a.area), std::fabs(b.area), 1e-300 });
+        return a.rings != b.rings || a.vertices != b.vertices || std::fabs(a.area - b.area) > tolerance * scale;
+    }
+
+    void WriteReplayJson(FILE* f, const std::vector<ReplayResult>& results, double medianRatio, size_t changed,
+        const ReplayOptions& opt)
+    {
+        fprintf(f, "{\n  \"log\": ");
+        JsonString(f, opt.log);
+        fprintf(f, ",\n  \"engine\": \"%s\",\n  \"calls\": %zu,\n  \"changed\": %zu,\n"
+            "  \"medianLatencyRatio\": %.4g,\n  \"results\": [",
+            opt.engine, results.size(), changed, medianRatio);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const ReplayResult& r = results[i];
+            fprintf(f, "%s\n    { \"index\": %zu, \"engine\": \"%s\", \"op\": \"%s\", \"inputVertices\": %zu,\n",
+                i ? "," : "", r.index, CallRecorder::EngineName(r.engine), OpName(r.op), r.inputVertices);
+            if (!r.error.empty())
+            {
+                fprintf(f, "      \"error\": ");
+                JsonString(f, r.error);
+                fprintf(f, " }");
+                continue;
+            }
+            fprintf(f, "      \"recordedUs\": %.6g, \"replayUs\": %.6g, \"latencyRatio\": %.4g,\n",
+                r.recordedUs, r.replayUs, r.recordedUs > 0 ? r.replayUs / r.recordedUs : 0.0);
+            fprintf(f, "      \"ringsDelta\": %lld, \"verticesDelta\": %lld, \"areaDelta\": %.6g, \"changed\": %s }",
+                static_cast<long long>(r.replayed.rings) - static_cast<long long>(r.recorded.rings),
+                static_cast<long long>(r.replayed.vertices) - static_cast<long long>(r.recorded.vertices),
+                r.replayed.area - r.recorded.area, r.changed ? "true" : "false");
+        }
+        fprintf(f, "\n  ]\n}\n");
+    }
+}
+
+int RunReplay(int argc, char** argv)
+{
+    ReplayOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "replay: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--log")
+            opt.log = value;
+        else if (flag == "--engine")
+            opt.engine = value;
+        else if (flag == "--reps")
+            opt.reps = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        else if (flag == "--area-tolerance")
+            opt.areaTolerance = std::atof(value);
+        else if (flag == "--out")
+            opt.out = value;
+        else
+        {
+            fprintf(stderr, "replay: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+    if (!opt.log)
+    {
+        fprintf(stderr, "replay: --log is required\n");
+        return 2;
+    }
+
+    std::string engineName = opt.engine;
+    bool useRecorded = engineName == "recorded";
+    CallEngine override = CallEngine::SutherlandHodgman;
+    if (!useRecorded)
+    {
+        if (engineName == CallRecorder::EngineName(CallEngine::GreinerHormann))
+            override = CallEngine::GreinerHormann;
+        else if (engineName != CallRecorder::EngineName(CallEngine::SutherlandHodgman))
+        {
+            fprintf(stderr, "replay: unknown engine %s\n", opt.engine);
+            return 2;
+        }
+    }
+
+    std::vector<CallRecord> records;
+    try
+    {
+        records = ReadCallLog(opt.log);
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "replay: %s\n", e.what());
+        return 1;
+    }
+
+    std::vector<ReplayResult> results;
+    std::vector<double> ratios;
+    size_t changed = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const CallRecord& rec = records[i];
+        ReplayResult r;
+        r.index = i;
+        r.engine = useRecorded ? rec.engine : override;
+        r.op = rec.op;
+        r.inputVertices = MakeBenchPair("", rec.a, rec.b, false).VertexCount();
+        r.recordedUs = rec.latencyNs / 1e3;
+        r.replayUs = 0;
+        r.recorded = rec.output;
+        r.changed = false;
+
+        try
+        {
+            double best = HUGE_VAL;
+            for (size_t k = 0; k < opt.reps; k++)
+            {
+                Clock::time_point start = Clock::now();
+                r.replayed = ReplayCall(r.engine, rec);
+                best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+            r.replayUs = best;
+            r.changed = OutputChanged(r.recorded, r.replayed, opt.areaTolerance);
+            if (r.recordedUs > 0)
+                ratios.push_back(r.replayUs / r.recordedUs);
+        }
+        catch (const std::exception& e)
+        {
+            r.error = e.what();
+            r.changed = true;
+        }
+
+        changed += r.changed;
+        if (r.changed)
+        {
+            fprintf(stderr, "CHANGED call %zu (%s %s): rings %u -> %u, vertices %llu -> %llu, area %.9g -> %.9g\n",
+                i, CallRecorder::EngineName(r.engine), OpName(r.op), r.recorded.rings, r.replayed.rings,
+                static_cast<unsigned long long>(r.recorded.vertices), static_cast<unsigned long long>(r.replayed.vertices),
+                r.recorded.area, r.replayed.area);
+        }
+        results.push_back(std::move(r));
+    }
+
+    double medianRatio = 0;
+    if (!ratios.empty())
+    {
+        std::nth_element(ratios.begin(), ratios.begin() + ratios.size() / 2, ratios.end());
+        medianRatio = ratios[ratios.size() / 2];
+    }
+    fprintf(stderr, "replayed %zu calls: %zu changed, median latency ratio %.3f\n",
+        results.size(), changed, medianRatio);
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "replay: cannot write %s\n", opt.out);
+        return 1;
+    }
+    WriteReplayJson(f, results, medianRatio, changed, opt);
+    if (f != stdout)
+        fclose(f);
+    return changed ? 3 : 0;
+}
+
+// ---------------------------------------------------------------
+// calibrate
+// ---------------------------------------------------------------
+
+int RunCalibrate(int argc, char** argv)
+{
+    unsigned seed = 1;
+    const char* out = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "calibrate: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--seed")
+            seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--out")
+            out = value;
+        else
+        {
+            fprintf(stderr, "calibrate: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+
+    BooleanEngine& engine = BenchDispatcher();
+    Clock::time_point start = Clock::now();
+    engine.Calibrate(seed);
+    fprintf(stderr, "calibrated in %.2f s\n", std::chrono::duration<double>(Clock::now() - start).count());
+
+    FILE* f = out ? fopen(out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "calibrate: cannot write %s\n", out);
+        return 1;
+    }
+
+    fprintf(f, "{\n  \"seed\": %u,\n  \"engines\": [", seed);
+    for (size_t i = 0; i < static_cast<size_t>(EngineKind::Count); i++)
+    {
+        EngineKind kind = static_cast<EngineKind>(i);
+        const EngineCost& cost = engine.Cost(kind);
+        fprintf(f, "%s\n    { \"name\": \"%s\", \"allowed\": %s, \"fixedNs\": %.1f, \"unitNs\": %.4g }",
+            i ? "," : "", BooleanEngine::EngineName(kind), engine.Allowed(kind) ? "true" : "false",
+            cost.fixedNs, cost.unitNs);
+    }
+
+    // What the fitted model picks for the default workloads
+    const BoolOp ops[] = { BoolOp::Union, BoolOp::Intersection, BoolOp::AminusB, BoolOp::BminusA };
+    fprintf(f, "\n  ],\n  \"choices\": [");
+    bool first = true;
+    for (const BenchPair& pair : DefaultWorkloads(42))
+    {
+        for (BoolOp op : ops)
+        {
+            BooleanFeatures features = BooleanFeatures::Of(pair.a, pair.b, op);
+            EngineKind choice = engine.Choose(features);
+            fprintf(f, "%s\n    { \"workload\": \"%s\", \"op\": \"%s\", \"engine\": \"%s\", \"predictedUs\": %.4g }",
+                first ? "" : ",", pair.name.c_str(), OpName(op), BooleanEngine::EngineName(choice),
+                engine.PredictNs(choice, features) / 1e3);
+            first = false;
+        }
+    }
+    fprintf(f, "\n  ]\n}\n");
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
+
+// ---------------------------------------------------------------
+// session
+// ---------------------------------------------------------------
+
+namespace
+{
+    struct SessionOptions
+    {
+        WorkloadKind kind = WorkloadKind::Coastline;
+        size_t vertices = 4096;
+        BoolOp op = BoolOp::Intersection;
+        size_t edits = 200;
+        unsigned seed = 42;
+        const char* out = nullptr;
+    };
+
+    double Percentile(std::vector<double> v, double q)
+    {
+        if (v.empty())
+            return 0;
+        size_t k = std::min(static_cast<size_t>(q * v.size()), v.size() - 1);
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k];
+    }
+}
+
+int RunSession(int argc, char** argv)
+{
+    SessionOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "session: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--kind")
+        {
+            if (!WorkloadGenerator::ParseKind(value, opt.kind))
+            {
+                fprintf(stderr, "session: unknown kind %s\n", value);
+                return 2;
+            }
+        }
+        else if (flag == "--op")
+        {
+            std::string name = value;
+            bool found = false;
+            for (BoolOp op : { BoolOp::Union, BoolOp::Intersection, BoolOp::AminusB, BoolOp::BminusA })
+            {
+                if (name == OpName(op))
+                {
+                    opt.op = op;
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                fprintf(stderr, "session: unknown op %s\n", value);
+                return 2;
+            }
+        }
+        else if (flag == "--vertices")
+            opt.vertices = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 4);
+        else if (flag == "--edits")
+            opt.edits = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 1);
+        else if (flag == "--seed")
+            opt.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--out")
+            opt.out = value;
+        else
+        {
+            fprintf(stderr, "session: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+
+    WorkloadGenerator gen(opt.seed);
+    Workload w = gen.Generate(opt.kind, opt.vertices);
+    Polygon a{ w.a[0].outer, {} };
+    Polygon b{ w.b[0].outer, {} };
+
+    IncrementalBooleanSession session(a, b, opt.op);
+    BooleanEngine& engine = BenchDispatcher();
+
+    // Small drags, a fraction of an edge, like a mouse move would make
+    std::mt19937_64 rng(opt.seed);
+    double step = 0.25 * 6.2832 / static_cast<double>(opt.vertices);
+    std::uniform_real_distribution<double> jitter(-step, step);
+
+    std::vector<double> editUs, fullUs;
+    double ringsChanged = 0, segmentTests = 0;
+    for (size_t k = 0; k < opt.edits; k++)
+    {
+        BooleanOperand which = k % 2 ? BooleanOperand::B : BooleanOperand::A;
+        Polygon& target = which == BooleanOperand::A ? a : b;
+        size_t index = static_cast<size_t>(rng() % target.outer.vertices.size());
+        Point& p = target.outer.vertices[index];
+        p = { p.x + jitter(rng), p.y + jitter(rng) };
+
+        Clock::time_point start = Clock::now();
+        SessionChange change = session.MoveVertex(which, index, p);
+        editUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        ringsChanged += static_cast<double>(change.added.size() + change.removed.size());
+        segmentTests += static_cast<double>(change.edgesTested);
+
+        start = Clock::now();
+        std::vector<Polygon> full = engine.Compute(a, b, opt.op);
+        fullUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    double editP50 = Percentile(editUs, 0.5);
+    double fullP50 = Percentile(fullUs, 0.5);
+    fprintf(stderr, "%s %zu %s: edit p50 %.1f us, full recompute p50 %.1f us (%.0fx)\n",
+        WorkloadGenerator::KindName(opt.kind), opt.vertices, OpName(opt.op), editP50, fullP50,
+        editP50 > 0 ? fullP50 / editP50 : 0.0);
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "session: cannot write %s\n", opt.out);
+        return 1;
+    }
+    fprintf(f, "{\n  \"kind\": \"%s\",\n  \"vertices\": %zu,\n  \"op\": \"%s\",\n  \"edits\": %zu,\n"
+        "  \"crossings\": %zu,\n  \"resultRings\": %zu,\n",
+        WorkloadGenerator::KindName(opt.kind), opt.vertices, OpName(opt.op), opt.edits,
+        session.CrossingCount(), session.Rings().size());
+    fprintf(f, "  \"editUs\": { \"p50\": %.3f, \"p99\": %.3f },\n", editP50, Percentile(editUs, 0.99));
+    fprintf(f, "  \"fullUs\": { \"p50\": %.3f, \"p99\": %.3f },\n", fullP50, Percentile(fullUs, 0.99));
+    fprintf(f, "  \"ringsChangedPerEdit\": %.3f,\n  \"segmentTestsPerEdit\": %.1f\n}\n",
+        ringsChanged / opt.edits, segmentTests / opt.edits);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
+
+// ---------------------------------------------------------------
+// cache
+// ---------------------------------------------------------------
+
+namespace
+{
+    struct CacheOptions
+    {
+        WorkloadKind kind = WorkloadKind::Coastline;
+        size_t vertices = 256;
+        size_t tiles = 64;
+        size_t calls = 4000;
+        size_t maxBytes = size_t(64) << 20;
+        unsigned threads = 4;
+        unsigned seed = 42;
+        const char* out = nullptr;
+    };
+
+    // Runs calls[t], calls[t + threads], ... on thread t and returns the
+    // wall time of the whole batch in seconds
+    template <typename Fn>
+    double RunSplit(const std::vector<size_t>& calls, unsigned threads, Fn fn)
+    {
+        Clock::time_point start = Clock::now();
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++)
+        {
+            pool.emplace_back([&, t] {
+                for (size_t k = t; k < calls.size(); k += threads)
+                    fn(calls[k]);
+            });
+        }
+        for (std::thread& th : pool)
+            th.join();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+int RunCache(int argc, char** argv)
+{
+    CacheOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string flag;
+        const char* value;
+        if (!NextArg(argc, argv, i, flag, value))
+        {
+            fprintf(stderr, "cache: bad argument %s\n", argv[i]);
+            return 2;
+        }
+        if (flag == "--kind")
+        {
+            if (!WorkloadGenerator::ParseKind(value, opt.kind))
+            {
+                fprintf(stderr, "cache: unknown kind %s\n", value);
+                return 2;
+            }
+        }
+        else if (flag == "--vertices")
+            opt.vertices = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 4);
+        else if (flag == "--tiles")
+            opt.tiles = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 1);
+        else if (flag == "--calls")
+            opt.calls = std::max<size_t>(static_cast<size_t>(std::strtod(value, nullptr)), 1);
+        else if (flag == "--max-bytes")
+            opt.maxBytes = static_cast<size_t>(std::strtod(value, nullptr));
+        else if (flag == "--threads")
+            opt.threads = std::max(static_cast<unsigned>(std::strtoul(value, nullptr, 10)), 1u);
+        else if (flag == "--seed")
+            opt.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (flag == "--out")
+            opt.out = value;
+        else
+        {
+            fprintf(stderr, "cache: unknown argument %s\n", flag.c_str());
+            return 2;
+        }
+    }
+
+    // One clip window against a set of tiles, every call an intersection
+    WorkloadGenerator gen(opt.seed);
+    Polygon window = gen.Generate(opt.kind, opt.vertices).a[0];
+    std::vector<Polygon> tiles;
+    for (size_t t = 0; t < opt.tiles; t++)
+        tiles.push_back(gen.Generate(opt.kind, opt.vertices).b[0]);
+
+    // Skewed like a real pipeline: a few tiles come back far more often
+    std::mt19937_64 rng(opt.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<size_t> calls(opt.calls);
+    for (size_t& c : calls)
+    {
+        double u = unit(rng);
+        c = std::min(static_cast<size_t>(u * u * static_cast<double>(opt.tiles)), opt.tiles - 1);
+    }
+
+    const BooleanEngine& engine = BenchDispatcher();
+    double direct = RunSplit(calls, opt.threads, [&](size_t t) {
+        engine.Compute(window, tiles[t], BoolOp::Intersection);
+    });
+
+    BooleanCache cache(engine, opt.maxBytes);
+    double cached = RunSplit(calls, opt.threads, [&](size_t t) {
+        cache.ComputeShared(window, tiles[t], BoolOp::Intersection);
+    });
+    BooleanCacheStats stats = cache.Stats();
+
+    fprintf(stderr, "%s %zu x %zu tiles: hit rate %.1f%%, %.3f s cached vs %.3f s direct\n",
+        WorkloadGenerator::KindName(opt.kind), opt.vertices, opt.tiles, 100.0 * stats.HitRate(),
+        cached, direct);
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "cache: cannot write %s\n", opt.out);
+        return 1;
+    }
+    fprintf(f, "{\n  \"kind\": \"%s\",\n  \"vertices\": %zu,\n  \"tiles\": %zu,\n  \"calls\": %zu,\n"
+        "  \"threads\": %u,\n",
+        WorkloadGenerator::KindName(opt.kind), opt.vertices, opt.tiles, opt.calls, opt.threads);
+    fprintf(f, "  \"hits\": %llu,\n  \"misses\": %llu,\n  \"hitRate\": %.4f,\n  \"evictions\": %llu,\n",
+        static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+        stats.HitRate(), static_cast<unsigned long long>(stats.evictions));
+    fprintf(f, "  \"entries\": %zu,\n  \"bytes\": %zu,\n  \"maxBytes\": %zu,\n",
+        stats.entries, stats.bytes, stats.maxBytes);
+    fprintf(f, "  \"directSeconds\": %.6f,\n  \"cachedSeconds\": %.6f\n}\n", direct, cached);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
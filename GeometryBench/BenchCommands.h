@@ -0,0 +1,32 @@
+#pragma once
+
+// GeometryBench subcommands; argv[0] is the subcommand name.
+// Both return the process exit code.
+
+// gen: writes a generated workload as WKT, WKB or a flat polygon file
+int RunGenerate(int argc, char** argv);
+
+// sweep: times targets over growing input sizes and fits the scaling
+// exponent; exits with 3 when a fit exceeds --max-exponent
+int RunSweep(int argc, char** argv);
+
+// micro: runs each segment-intersection and point-in-polygon primitive
+// over a random batch and reports ns, cycles, instructions, branch and
+// cache misses per call (hardware counters on Linux only)
+int RunMicro(int argc, char** argv);
+
+// replay: re-runs a CallRecorder log with this build and reports latency
+// and output differences per call; exits with 3 when any output changed
+int RunReplay(int argc, char** argv);
+
+// calibrate: refits the dispatcher's cost model on this host and prints
+// it, with the engine it picks for each default workload
+int RunCalibrate(int argc, char** argv);
+
+// session: drags random vertices through an IncrementalBooleanSession and
+// compares each edit's latency with a full recompute
+int RunSession(int argc, char** argv);
+
+// cache: one clip window against a skewed stream of tiles, with and
+// without a BooleanCache in front of the dispatcher
+int RunCache(int argc, char** argv);
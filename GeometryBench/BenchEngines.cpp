@@ -0,0 +1,241 @@
+#include "BenchEngines.h"
+#include "../BooleanNative/RingSpan.h"
+#include "../BooleanNative/WindingOverlay.h"
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+    PolygonBoolean::Polygon ToNative(const Polygon& poly)
+    {
+        std::vector<PolygonBoolean::Point> pts;
+        pts.reserve(poly.outer.vertices.size());
+        for (const Point& p : poly.outer.vertices)
+            pts.emplace_back(p.x, p.y);
+        return PolygonBoolean::Polygon(pts);
+    }
+
+    size_t Count(const std::vector<Polygon>& result)
+    {
+        size_t n = 0;
+        for (const Polygon& p : result)
+        {
+            n += p.outer.vertices.size();
+            for (const Ring& h : p.holes)
+                n += h.vertices.size();
+        }
+        return n;
+    }
+
+    size_t Count(const std::vector<std::vector<PolygonBoolean::Point>>& rings)
+    {
+        size_t n = 0;
+        for (const auto& r : rings)
+            n += r.size();
+        return n;
+    }
+
+    size_t RunSutherlandHodgman(const BenchPair& pair, BoolOp op)
+    {
+        BooleanOps ops;
+        return Count(ops.ComputeBoolean(pair.a, pair.b, op));
+    }
+
+    size_t RunGreinerHormann(const BenchPair& pair, BoolOp op)
+    {
+        BooleanOps ops;
+        return Count(ops.ComputeBoolean2(pair.a, pair.b, op));
+    }
+
+    size_t RunNative(const BenchPair& pair, BoolOp op)
+    {
+        using PolygonBoolean::BooleanOperations;
+        std::vector<PolygonBoolean::Polygon> result;
+        switch (op)
+        {
+        case BoolOp::Union:
+            result = BooleanOperations::compute(pair.nativeA, pair.nativeB, BooleanOperations::UNION);
+            break;
+        case BoolOp::Intersection:
+            result = BooleanOperations::compute(pair.nativeA, pair.nativeB, BooleanOperations::INTERSECTION);
+            break;
+        case BoolOp::AminusB:
+            result = BooleanOperations::compute(pair.nativeA, pair.nativeB, BooleanOperations::DIFFERENCE);
+            break;
+        case BoolOp::BminusA:
+            result = BooleanOperations::compute(pair.nativeB, pair.nativeA, BooleanOperations::DIFFERENCE);
+            break;
+        }
+        size_t n = 0;
+        for (const auto& p : result)
+            n += p.vertexCount();
+        return n;
+    }
+
+    size_t RunDispatch(const BenchPair& pair, BoolOp op)
+    {
+        return Count(BenchDispatcher().Compute(pair.a, pair.b, op));
+    }
+
+    // Both inputs as one ring set: union is winding >= 1, intersection >= 2,
+    // a difference adds the reversed subtrahend
+    size_t RunWindingOverlay(const BenchPair& pair, BoolOp op)
+    {
+        using PolygonBoolean::RingSpan;
+        static_assert(sizeof(Point) == sizeof(PolygonBoolean::Point), "layouts match");
+
+        auto span = [](const Polygon& p) {
+            const auto* pts = reinterpret_cast<const PolygonBoolean::Point*>(p.outer.vertices.data());
+            return RingSpan(pts, p.outer.vertices.size()).ccw();
+        };
+        RingSpan a = span(pair.a);
+        RingSpan b = span(pair.b);
+
+        std::vector<RingSpan> rings;
+        switch (op)
+        {
+        case BoolOp::Union:
+        case BoolOp::Intersection:
+            rings = { a, b };
+            break;
+        case BoolOp::AminusB:
+            rings = { a, b.reverse() };
+            break;
+        case BoolOp::BminusA:
+            rings = { b, a.reverse() };
+            break;
+        }
+        return Count(PolygonBoolean::WindingOverlay::resolve(rings, op == BoolOp::Intersection ? 2 : 1));
+    }
+}
+
+size_t BenchPair::VertexCount() const
+{
+    size_t n = a.outer.vertices.size() + b.outer.vertices.size();
+    for (const Ring& h : a.holes)
+        n += h.vertices.size();
+    for (const Ring& h : b.holes)
+        n += h.vertices.size();
+    return n;
+}
+
+BenchPair MakeBenchPair(const std::string& name, const Polygon& a, const Polygon& b, bool withNative)
+{
+    BenchPair pair;
+    pair.name = name;
+    pair.a = a;
+    pair.b = b;
+    if (withNative)
+    {
+        pair.nativeA = ToNative(a);
+        pair.nativeB = ToNative(b);
+    }
+    return pair;
+}
+
+std::vector<BenchPair> MakeBenchPairs(const std::string& name, const Workload& w, bool withNative)
+{
+    std::vector<BenchPair> pairs;
+    pairs.reserve(w.PairCount());
+    for (size_t i = 0; i < w.PairCount(); i++)
+        pairs.push_back(MakeBenchPair(name, w.a[i % w.a.size()], w.b[i % w.b.size()], withNative));
+    return pairs;
+}
+
+std::vector<BenchPair> DefaultWorkloads(unsigned seed)
+{
+    struct Entry { WorkloadKind kind; size_t vertices; };
+    const Entry entries[] = {
+        { WorkloadKind::Convex, 16 }, { WorkloadKind::Convex, 256 }, { WorkloadKind::Convex, 4096 },
+        { WorkloadKind::Star, 64 }, { WorkloadKind::Star, 1024 },
+        { WorkloadKind::Coastline, 1024 },
+        { WorkloadKind::Collinear, 256 },
+    };
+
+    WorkloadGenerator gen(seed);
+    std::vector<BenchPair> pairs;
+    for (const Entry& e : entries)
+    {
+        Workload w = gen.Generate(e.kind, e.vertices);
+        std::string name = std::string(WorkloadGenerator::KindName(e.kind)) + "-" + std::to_string(e.vertices);
+        pairs.push_back(MakeBenchPair(name, w.a[0], w.b[0]));
+    }
+    return pairs;
+}
+
+std::vector<CallRecord> ReadCallLog(const char* path)
+{
+    std::unique_ptr<FILE, int (*)(FILE*)> file(fopen(path, "rb"), fclose);
+    if (!file)
+        throw std::runtime_error(std::string("cannot read ") + path);
+#ifdef _WIN32
+    ByteSource source = ByteSource::FromFd(_fileno(file.get()));
+#else
+    ByteSource source = ByteSource::FromFd(fileno(file.get()));
+#endif
+
+    CallLogReader reader(source);
+    std::vector<CallRecord> records;
+    CallRecord record;
+    while (reader.Next(record))
+        records.push_back(record);
+    return records;
+}
+
+std::vector<BenchPair> LogWorkloads(const std::vector<CallRecord>& records)
+{
+    std::vector<BenchPair> pairs;
+    pairs.reserve(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+        pairs.push_back(MakeBenchPair("log-" + std::to_string(i), records[i].a, records[i].b));
+    return pairs;
+}
+
+const std::vector<BenchEngine>& BenchEngines()
+{
+    static const std::vector<BenchEngine> engines = {
+        { "sutherland-hodgman", RunSutherlandHodgman, true, false },
+        { "greiner-hormann", RunGreinerHormann, true, false },
+        // Polygon::findIntersections accepts segment endpoints as hits, so it
+        // re-finds every vertex it inserts and never returns once two edges
+        // cross; opt-in until that is fixed
+        { "native", RunNative, false, true },
+        { "winding-overlay", RunWindingOverlay, true, false },
+        { "dispatch", RunDispatch, true, false },
+    };
+    return engines;
+}
+
+const char* OpName(BoolOp op)
+{
+    switch (op)
+    {
+    case BoolOp::Union: return "union";
+    case BoolOp::Intersection: return "intersection";
+    case BoolOp::AminusB: return "a-minus-b";
+    case BoolOp::BminusA: return "b-minus-a";
+    }
+    return "unknown";
+}
+
+void JsonString(FILE* f, const std::string& s)
+{
+    fputc('"', f);
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            fprintf(f, "\\%c", c);
+        else if (static_cast<unsigned char>(c) < 0x20)
+            fprintf(f, "\\u%04x", c);
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+BooleanEngine& BenchDispatcher()
+{
+    static BooleanEngine engine;
+    return engine;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../GeometryCore/Polygonutility.h"
+#include "../GeometryCore/BooleanOps.h"
+#include "../GeometryCore/BooleanEngine.h"
+#include "../GeometryCore/CallRecorder.h"
+#include "../GeometryCore/WorkloadGenerator.h"
+#include "../BooleanNative/Polygon.h"
+
+// One benchmark input pair, kept in the representation of every engine so
+// conversion never lands inside a timed call
+struct BenchPair
+{
+    std::string name;
+    Polygon a;
+    Polygon b;
+    PolygonBoolean::Polygon nativeA;
+    PolygonBoolean::Polygon nativeB;
+
+    size_t VertexCount() const;
+};
+
+// withNative = false skips the PolygonBoolean copies (only the native
+// engine reads them)
+BenchPair MakeBenchPair(const std::string& name, const Polygon& a, const Polygon& b,
+    bool withNative = true);
+
+// a[i] with b[i] for every pair of a generated workload
+std::vector<BenchPair> MakeBenchPairs(const std::string& name, const Workload& w,
+    bool withNative = true);
+
+// Default workload set: single-pair families from WorkloadGenerator at a
+// few sizes, seeded so every run times the same coordinates
+std::vector<BenchPair> DefaultWorkloads(unsigned seed);
+
+// Every record of a CallRecorder log; throws std::runtime_error if the
+// file cannot be read or is malformed
+std::vector<CallRecord> ReadCallLog(const char* path);
+
+// One pair per logged call, named log-<index>, so captured production
+// inputs run alongside the generated ones
+std::vector<BenchPair> LogWorkloads(const std::vector<CallRecord>& records);
+
+// A boolean engine behind a common signature. Run returns the number of
+// output vertices so the work cannot be optimized away.
+struct BenchEngine
+{
+    const char* name;
+    size_t (*Run)(const BenchPair& pair, BoolOp op);
+    bool byDefault;  // false: only run when named with --engine
+    bool usesNative; // reads BenchPair::nativeA/nativeB
+};
+
+const std::vector<BenchEngine>& BenchEngines();
+
+// The dispatcher behind the "dispatch" engine; calibrate it before timing
+// to use this host's costs instead of the built-in ones
+BooleanEngine& BenchDispatcher();
+
+const char* OpName(BoolOp op);
+
+// Writes s as a quoted JSON string; for text the bench does not control
+// (exception messages, paths)
+void JsonString(FILE* f, const std::string& s);
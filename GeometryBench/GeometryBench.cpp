@@ -0,0 +1,367 @@
+﻿// GeometryBench: runs every boolean engine on the same workloads for every
+// operation and reports throughput, latency percentiles and peak RSS as JSON.
+//
+//   GeometryBench [--engine NAME] [--workload NAME] [--min-time SEC]
+//                 [--min-iters N] [--max-iters N] [--seed N] [--out FILE]
+//                 [--trace FILE] [--log FILE] [--calibrate] [--list]
+//
+// --engine and --workload may repeat; a name matches by prefix. Engines
+// marked opt-in in BenchEngines() only run when named explicitly.
+// --trace writes a Chrome trace of the run (open in ui.perfetto.dev).
+// --log adds the calls of a CallRecorder log as workloads log-0, log-1, ...
+// --calibrate fits the "dispatch" engine's cost model on this host first.
+//
+//   GeometryBench gen --kind KIND --vertices N [--seed N] [--side a|b|both]
+//                     [--format wkt|wkb|flat] [--out FILE]
+//
+// Writes a WorkloadGenerator workload (kinds: star, coastline, square-grid,
+// holes, collinear, convex).
+//
+//   GeometryBench sweep [--target NAME] [--kind KIND] [--op OP] [--min N]
+//                       [--max N] [--factor F] [--min-time SEC]
+//                       [--max-call-sec SEC] [--max-exponent E] [--out FILE]
+//
+// Times each target (engines, plus kernels such as remove-duplicates) on
+// sizes min, min * factor, ... up to max, stopping early once one call
+// takes longer than --max-call-sec. It fits time ~ n^e and flags fits
+// above --max-exponent (default 1.5, i.e. worse than n log n by a clear
+// margin), exiting with 3 so a CI job fails on a quadratic regression.
+//
+//   GeometryBench micro [--primitive NAME] [--batch N] [--vertices N]
+//                       [--min-time SEC] [--seed N] [--out FILE]
+//
+// Runs each segment-intersection and point-in-polygon routine over a random
+// batch and reports cost per call: ns always, and cycles, instructions,
+// IPC, branch and cache misses where perf_event_open is allowed.
+//
+//   GeometryBench replay --log FILE [--engine recorded|sutherland-hodgman|
+//                        greiner-hormann] [--reps N] [--area-tolerance REL]
+//                        [--out FILE]
+//
+// Re-runs every call of a CallRecorder log with this build, by default on
+// the engine it was recorded with, and reports the latency ratio and the
+// ring, vertex and area deltas per call. Exits with 3 if any output changed.
+//
+//   GeometryBench calibrate [--seed N] [--out FILE]
+//
+// Fits the BooleanEngine cost model on this host and prints each engine's
+// fixed and per-unit cost, plus the engine it picks for every default
+// workload and operation.
+//
+//   GeometryBench session [--kind KIND] [--vertices N] [--op OP]
+//                         [--edits N] [--seed N] [--out FILE]
+//
+// Drags random vertices of a generated pair through an
+// IncrementalBooleanSession and reports edit latency next to a full
+// recompute by the dispatcher after every edit.
+//
+//   GeometryBench cache [--kind KIND] [--vertices N] [--tiles N]
+//                       [--calls N] [--max-bytes N] [--threads N]
+//                       [--seed N] [--out FILE]
+//
+// Clips one window against a skewed stream of tiles twice, straight
+// through the dispatcher and through a BooleanCache, and reports the hit
+// rate, evictions and bytes held next to both times.
+
+#include "BenchCommands.h"
+#include "BenchEngines.h"
+#include "../GeometryCore/TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::vector<std::string> engines;
+        std::vector<std::string> workloads;
+        double minTime = 0.25;
+        size_t minIters = 5;
+        size_t maxIters = 100000;
+        unsigned seed = 42;
+        const char* out = nullptr;
+        const char* trace = nullptr;
+        std::vector<std::string> logs;
+        bool calibrate = false;
+        bool list = false;
+    };
+
+    struct CaseResult
+    {
+        std::string workload;
+        const char* engine;
+        const char* op;
+        size_t inputVertices = 0;
+        size_t outputVertices = 0;
+        size_t calls = 0;
+        double seconds = 0;
+        double p50 = 0, p90 = 0, p99 = 0, max = 0; // microseconds
+        std::string error;
+    };
+
+    // Process-wide high-water mark; it never goes down, so it is only
+    // reported once for the whole run
+    size_t PeakRssKb()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return pmc.PeakWorkingSetSize / 1024;
+        return 0;
+#else
+        struct rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) != 0)
+            return 0;
+#ifdef __APPLE__
+        return static_cast<size_t>(ru.ru_maxrss) / 1024;
+#else
+        return static_cast<size_t>(ru.ru_maxrss);
+#endif
+#endif
+    }
+
+    bool Selected(const std::vector<std::string>& filters, const std::string& name)
+    {
+        if (filters.empty())
+            return true;
+        for (const std::string& f : filters)
+        {
+            if (name.compare(0, f.size(), f) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    double Percentile(const std::vector<double>& sorted, double q)
+    {
+        if (sorted.empty())
+            return 0;
+        size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+
+    // Calls the engine until both the iteration and time minimums are met;
+    // the first call is a warm-up and is not recorded
+    CaseResult RunCase(const BenchEngine& engine, const BenchPair& pair, BoolOp op, const Options& opt)
+    {
+        TraceScope trace("bench.case", pair.VertexCount());
+        CaseResult r;
+        r.workload = pair.name;
+        r.engine = engine.name;
+        r.op = OpName(op);
+        r.inputVertices = pair.VertexCount();
+
+        std::vector<double> samples;
+        try
+        {
+            r.outputVertices = engine.Run(pair, op);
+
+            Clock::time_point start = Clock::now();
+            while (samples.size() < opt.maxIters)
+            {
+                Clock::time_point t0 = Clock::now();
+                size_t out = engine.Run(pair, op);
+                Clock::time_point t1 = Clock::now();
+                samples.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+                r.outputVertices = out;
+
+                double elapsed = std::chrono::duration<double>(t1 - start).count();
+                if (samples.size() >= opt.minIters && elapsed >= opt.minTime)
+                    break;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            r.error = e.what();
+        }
+
+        r.calls = samples.size();
+        for (double s : samples)
+            r.seconds += s * 1e-6;
+        std::sort(samples.begin(), samples.end());
+        r.p50 = Percentile(samples, 0.50);
+        r.p90 = Percentile(samples, 0.90);
+        r.p99 = Percentile(samples, 0.99);
+        r.max = samples.empty() ? 0 : samples.back();
+        return r;
+    }
+
+    void WriteJson(FILE* f, const std::vector<CaseResult>& results, const Options& opt)
+    {
+        fprintf(f, "{\n  \"seed\": %u,\n  \"minTimeSec\": %g,\n  \"peakRssKb\": %zu,\n  \"results\": [",
+            opt.seed, opt.minTime, PeakRssKb());
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const CaseResult& r = results[i];
+            double opsPerSec = r.seconds > 0 ? r.calls / r.seconds : 0;
+            fprintf(f, "%s\n    { \"workload\": ", i ? "," : "");
+            JsonString(f, r.workload);
+            fprintf(f, ", \"engine\": \"%s\", \"op\": \"%s\",\n", r.engine, r.op);
+            fprintf(f, "      \"inputVertices\": %zu, \"outputVertices\": %zu, \"calls\": %zu,\n",
+                r.inputVertices, r.outputVertices, r.calls);
+            fprintf(f, "      \"opsPerSec\": %.6g, \"verticesPerSec\": %.6g,\n",
+                opsPerSec, opsPerSec * r.inputVertices);
+            fprintf(f, "      \"latencyUs\": { \"p50\": %.6g, \"p90\": %.6g, \"p99\": %.6g, \"max\": %.6g }",
+                r.p50, r.p90, r.p99, r.max);
+            if (!r.error.empty())
+            {
+                fprintf(f, ", \"error\": ");
+                JsonString(f, r.error);
+            }
+            fprintf(f, " }");
+        }
+        fprintf(f, "\n  ]\n}\n");
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--list")
+                opt.list = true;
+            else if (arg == "--calibrate")
+                opt.calibrate = true;
+            else if (arg == "--engine" && hasValue)
+                opt.engines.push_back(argv[++i]);
+            else if (arg == "--workload" && hasValue)
+                opt.workloads.push_back(argv[++i]);
+            else if (arg == "--min-time" && hasValue)
+                opt.minTime = std::atof(argv[++i]);
+            else if (arg == "--min-iters" && hasValue)
+                opt.minIters = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--max-iters" && hasValue)
+                opt.maxIters = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--seed" && hasValue)
+                opt.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--out" && hasValue)
+                opt.out = argv[++i];
+            else if (arg == "--trace" && hasValue)
+                opt.trace = argv[++i];
+            else if (arg == "--log" && hasValue)
+                opt.logs.push_back(argv[++i]);
+            else
+            {
+                fprintf(stderr, "GeometryBench: unknown or incomplete argument %s\n", arg.c_str());
+                return false;
+            }
+        }
+        opt.maxIters = std::max<size_t>(opt.maxIters, 1);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "gen") == 0)
+        return RunGenerate(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "sweep") == 0)
+        return RunSweep(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "micro") == 0)
+        return RunMicro(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "replay") == 0)
+        return RunReplay(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "calibrate") == 0)
+        return RunCalibrate(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "session") == 0)
+        return RunSession(argc - 1, argv + 1);
+    if (argc > 1 && std::strcmp(argv[1], "cache") == 0)
+        return RunCache(argc - 1, argv + 1);
+
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+        return 2;
+
+    if (opt.calibrate)
+        BenchDispatcher().Calibrate(opt.seed);
+
+    std::vector<BenchPair> workloads = DefaultWorkloads(opt.seed);
+    for (const std::string& log : opt.logs)
+    {
+        try
+        {
+            std::vector<BenchPair> logged = LogWorkloads(ReadCallLog(log.c_str()));
+            workloads.insert(workloads.end(), logged.begin(), logged.end());
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "GeometryBench: %s: %s\n", log.c_str(), e.what());
+            return 1;
+        }
+    }
+    if (opt.list)
+    {
+        for (const BenchEngine& e : BenchEngines())
+            printf("engine   %s%s\n", e.name, e.byDefault ? "" : " (opt-in)");
+        for (const BenchPair& w : workloads)
+            printf("workload %s (%zu vertices)\n", w.name.c_str(), w.VertexCount());
+        return 0;
+    }
+
+    const BoolOp ops[] = { BoolOp::Union, BoolOp::Intersection, BoolOp::AminusB, BoolOp::BminusA };
+
+    if (opt.trace)
+    {
+        TraceRecorder::Instance().Start();
+        TraceRecorder::Instance().SetThreadName("bench");
+    }
+
+    std::vector<CaseResult> results;
+    for (const BenchPair& pair : workloads)
+    {
+        if (!Selected(opt.workloads, pair.name))
+            continue;
+        for (const BenchEngine& engine : BenchEngines())
+        {
+            if (opt.engines.empty() ? !engine.byDefault : !Selected(opt.engines, engine.name))
+                continue;
+            for (BoolOp op : ops)
+            {
+                results.push_back(RunCase(engine, pair, op, opt));
+                const CaseResult& r = results.back();
+                fprintf(stderr, "%-12s %-20s %-13s %10.1f us p50\n",
+                    r.workload.c_str(), r.engine, r.op, r.p50);
+            }
+        }
+    }
+
+    FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "GeometryBench: cannot write %s\n", opt.out);
+        return 1;
+    }
+    WriteJson(f, results, opt);
+    if (f != stdout)
+        fclose(f);
+
+    if (opt.trace)
+    {
+        TraceRecorder::Instance().Stop();
+        try
+        {
+            TraceRecorder::Instance().Write(opt.trace);
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "GeometryBench: %s\n", e.what());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "PerfCounters.h"
+#ifdef __linux__
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char* PerfCounters::Name(Counter c)
+{
+    switch (c)
+    {
+    case Cycles: return "cycles";
+    case Instructions: return "instructions";
+    case BranchMisses: return "branchMisses";
+    case CacheMisses: return "cacheMisses";
+    default: return "unknown";
+    }
+}
+
+#ifdef __linux__
+
+PerfCounters::PerfCounters()
+{
+    const uint64_t configs[CounterCount] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES };
+
+    for (int c = 0; c < CounterCount; c++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[c] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[c] < 0 && error.empty())
+            error = std::string("perf_event_open(") + Name(static_cast<Counter>(c)) + "): " + std::strerror(errno);
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+void PerfCounters::Start()
+{
+    for (int fd : fds)
+    {
+        if (fd < 0)
+            continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCounters::Stop()
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int c = 0; c < CounterCount; c++)
+    {
+        values[c] = 0;
+        uint64_t data[3]; // value, time enabled, time running
+        if (fds[c] < 0 || read(fds[c], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+            continue;
+        values[c] = static_cast<double>(data[0]);
+        if (data[2] > 0 && data[2] < data[1])
+            values[c] *= static_cast<double>(data[1]) / data[2];
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters()
+    : error("hardware counters need perf_event_open (Linux)")
+{
+    for (int& fd : fds)
+        fd = -1;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Start()
+{
+}
+
+void PerfCounters::Stop()
+{
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+
+// Hardware counters of the calling thread, read through perf_event_open.
+// Each counter is opened on its own, so a CPU that lacks one still reports
+// the others. Off Linux, or when the kernel refuses (perf_event_paranoid,
+// no PMU inside a VM), Available() is false and callers fall back to wall
+// time.
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        BranchMisses,
+        CacheMisses,
+        CounterCount
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool Available(Counter c) const { return fds[c] >= 0; }
+
+    // Why the first unavailable counter could not be opened; empty if all opened
+    const std::string& Error() const { return error; }
+
+    void Start();
+    void Stop();
+
+    // Count between the last Start and Stop, scaled up when the kernel
+    // multiplexed the counter; 0 when unavailable
+    double Value(Counter c) const { return values[c]; }
+
+    static const char* Name(Counter c);
+
+private:
+    int fds[CounterCount];
+    double values[CounterCount] = {};
+    std::string error;
+};
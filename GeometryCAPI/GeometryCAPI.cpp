@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "GeometryCAPI.h"
+#include "../BooleanNative/Minkowski.h"
+#include "../BooleanNative/OffsetEngine.h"
+#include "../BooleanNative/RingNesting.h"
+#include "../BooleanNative/WindingOverlay.h"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using PolygonBoolean::Minkowski;
+using PolygonBoolean::OffsetEngine;
+using PolygonBoolean::OffsetOptions;
+using PolygonBoolean::Point;
+using PolygonBoolean::RingNesting;
+using PolygonBoolean::RingSpan;
+using PolygonBoolean::WindingOverlay;
+
+// Caller coordinates are viewed as Points without copying
+static_assert(sizeof(Point) == 2 * sizeof(double), "Point must be two packed doubles");
+static_assert(offsetof(Point, x) == 0 && offsetof(Point, y) == sizeof(double), "Point layout");
+
+struct gc_result
+{
+    std::vector<double> xy;
+    std::vector<uint64_t> ringOffsets;
+    std::vector<uint64_t> polygonOffsets;
+};
+
+namespace
+{
+    using Rings = std::vector<std::vector<Point>>;
+
+    thread_local std::string lastError;
+
+    gc_status Fail(gc_status status, const char* message)
+    {
+        lastError = message;
+        return status;
+    }
+
+    // Input rings grouped per polygon, outer CCW and holes CW; the spans
+    // point straight into the caller's xy array
+    struct InputPolygons
+    {
+        std::vector<std::vector<RingSpan>> polygons;
+
+        size_t RingTotal() const
+        {
+            size_t n = 0;
+            for (const auto& p : polygons) n += p.size();
+            return n;
+        }
+    };
+
+    void Read(const gc_polygons* in, const char* name, InputPolygons& out)
+    {
+        std::string what = std::string(name) + ": ";
+        if (!in)
+            throw std::invalid_argument(what + "null polygon set");
+        if (in->ring_count > 0 && (!in->ring_offsets || !in->xy))
+            throw std::invalid_argument(what + "missing xy or ring_offsets");
+
+        const uint64_t* rings = in->ring_offsets;
+        for (uint64_t r = 0; r < in->ring_count; r++)
+        {
+            if (rings[r] > rings[r + 1] || rings[r + 1] > in->point_count)
+                throw std::invalid_argument(what + "ring_offsets out of order or past point_count");
+        }
+
+        uint64_t polygonCount = in->polygon_offsets ? in->polygon_count : (in->ring_count > 0 ? 1 : 0);
+        const Point* points = reinterpret_cast<const Point*>(in->xy);
+
+        out.polygons.clear();
+        out.polygons.reserve(static_cast<size_t>(polygonCount));
+        for (uint64_t p = 0; p < polygonCount; p++)
+        {
+            uint64_t first = in->polygon_offsets ? in->polygon_offsets[p] : 0;
+            uint64_t last = in->polygon_offsets ? in->polygon_offsets[p + 1] : in->ring_count;
+            if (first > last || last > in->ring_count)
+                throw std::invalid_argument(what + "polygon_offsets out of order or past ring_count");
+
+            std::vector<RingSpan>& polygon = out.polygons.emplace_back();
+            for (uint64_t r = first; r < last; r++)
+            {
+                RingSpan ring(points + rings[r], static_cast<size_t>(rings[r + 1] - rings[r]));
+                if (ring.size() < 3)
+                    continue;
+                ring = ring.ccw();
+                polygon.push_back(r == first ? ring : ring.reverse());
+            }
+            if (polygon.empty())
+                out.polygons.pop_back();
+        }
+    }
+
+    // One ring list for a side. Several polygons may overlap each other, so
+    // they are merged first to keep the winding of the side at 0 or 1.
+    std::vector<RingSpan> Region(const InputPolygons& in, Rings& storage)
+    {
+        std::vector<RingSpan> spans;
+        spans.reserve(in.RingTotal());
+        for (const auto& polygon : in.polygons)
+            spans.insert(spans.end(), polygon.begin(), polygon.end());
+
+        if (in.polygons.size() > 1)
+        {
+            storage = WindingOverlay::resolve(spans, 1);
+            spans = RingSpan::of(storage);
+        }
+        return spans;
+    }
+
+    // Engine output, flattened one polygon (outer, then holes) at a time
+    gc_result* Assemble(const Rings& rings)
+    {
+        std::vector<std::vector<size_t>> groups = RingNesting::group(RingSpan::of(rings));
+
+        auto* result = new gc_result();
+        size_t points = 0;
+        for (const auto& ring : rings)
+            points += ring.size();
+        result->xy.reserve(points * 2);
+        result->ringOffsets.reserve(rings.size() + 1);
+        result->polygonOffsets.reserve(groups.size() + 1);
+
+        auto emit = [&](const std::vector<Point>& ring) {
+            result->ringOffsets.push_back(result->xy.size() / 2);
+            for (const Point& p : ring)
+            {
+                result->xy.push_back(p.x);
+                result->xy.push_back(p.y);
+            }
+        };
+
+        for (const auto& group : groups)
+        {
+            result->polygonOffsets.push_back(result->ringOffsets.size());
+            for (size_t i : group)
+                emit(rings[i]);
+        }
+        result->ringOffsets.push_back(result->xy.size() / 2);
+        result->polygonOffsets.push_back(result->ringOffsets.size() - 1);
+        return result;
+    }
+
+    // Runs fn at the boundary: no exception crosses into the caller
+    template <typename Fn>
+    gc_status Guard(gc_result** out, Fn&& fn)
+    {
+        if (!out)
+            return Fail(GC_INVALID_ARGUMENT, "null result pointer");
+        *out = nullptr;
+        try
+        {
+            *out = Assemble(fn());
+            lastError.clear();
+            return GC_OK;
+        }
+        catch (const std::invalid_argument& e)
+        {
+            return Fail(GC_INVALID_ARGUMENT, e.what());
+        }
+        catch (const std::bad_alloc&)
+        {
+            return Fail(GC_OUT_OF_MEMORY, "out of memory");
+        }
+        catch (const std::exception& e)
+        {
+            return Fail(GC_INTERNAL_ERROR, e.what());
+        }
+        catch (...)
+        {
+            return Fail(GC_INTERNAL_ERROR, "unknown error");
+        }
+    }
+}
+
+extern "C" {
+
+GC_API gc_status gc_boolean(const gc_polygons* a, const gc_polygons* b,
+    gc_boolean_op op, gc_result** out)
+{
+    return Guard(out, [&]() {
+        if (op < GC_UNION || op > GC_B_MINUS_A)
+            throw std::invalid_argument("invalid boolean operation");
+
+        InputPolygons inA, inB;
+        Read(a, "a", inA);
+        Read(b, "b", inB);
+
+        Rings storeA, storeB;
+        std::vector<RingSpan> rings = Region(inA, storeA);
+        std::vector<RingSpan> other = Region(inB, storeB);
+        if (op == GC_B_MINUS_A)
+            std::swap(rings, other);
+
+        // Each side has winding 0 or 1: the union is winding >= 1, the
+        // intersection >= 2, and a difference adds the reversed subtrahend
+        bool difference = op == GC_A_MINUS_B || op == GC_B_MINUS_A;
+        rings.reserve(rings.size() + other.size());
+        for (const RingSpan& ring : other)
+            rings.push_back(difference ? ring.reverse() : ring);
+
+        return WindingOverlay::resolve(rings, op == GC_INTERSECTION ? 2 : 1);
+    });
+}
+
+GC_API gc_status gc_offset(const gc_polygons* a, double distance,
+    gc_join_type join, double miter_limit, double arc_tolerance, gc_result** out)
+{
+    return Guard(out, [&]() {
+        OffsetOptions options;
+        switch (join)
+        {
+        case GC_JOIN_MITER: options.join = PolygonBoolean::JoinType::MITER; break;
+        case GC_JOIN_ROUND: options.join = PolygonBoolean::JoinType::ROUND; break;
+        case GC_JOIN_SQUARE: options.join = PolygonBoolean::JoinType::SQUARE; break;
+        default: throw std::invalid_argument("invalid join type");
+        }
+        if (miter_limit > 0)
+            options.miterLimit = miter_limit;
+        if (arc_tolerance > 0)
+            options.arcTolerance = arc_tolerance;
+
+        InputPolygons in;
+        Read(a, "a", in);
+        Rings storage;
+        return OffsetEngine::offset(Region(in, storage), distance, options);
+    });
+}
+
+namespace
+{
+    Rings MinkowskiOf(const gc_polygons* a, const gc_polygons* b, bool difference)
+    {
+        InputPolygons inA, inB;
+        Read(a, "a", inA);
+        Read(b, "b", inB);
+
+        // Pairwise per polygon, then one union when there is more than one pair
+        Rings all;
+        size_t pairs = 0;
+        for (const auto& pa : inA.polygons)
+        {
+            for (const auto& pb : inB.polygons)
+            {
+                Rings part = difference ? Minkowski::difference(pa, pb) : Minkowski::sum(pa, pb);
+                all.insert(all.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+                pairs++;
+            }
+        }
+        return pairs > 1 ? WindingOverlay::resolve(all, 1) : all;
+    }
+}
+
+GC_API gc_status gc_minkowski_sum(const gc_polygons* a, const gc_polygons* b, gc_result** out)
+{
+    return Guard(out, [&]() { return MinkowskiOf(a, b, false); });
+}
+
+GC_API gc_status gc_minkowski_difference(const gc_polygons* a, const gc_polygons* b, gc_result** out)
+{
+    return Guard(out, [&]() { return MinkowskiOf(a, b, true); });
+}
+
+GC_API void gc_result_view(const gc_result* result, gc_polygons* view)
+{
+    if (!view)
+        return;
+    std::memset(view, 0, sizeof(*view));
+    if (!result)
+        return;
+
+    view->xy = result->xy.data();
+    view->ring_offsets = result->ringOffsets.data();
+    view->polygon_offsets = result->polygonOffsets.data();
+    view->point_count = result->xy.size() / 2;
+    view->ring_count = result->ringOffsets.size() - 1;
+    view->polygon_count = result->polygonOffsets.size() - 1;
+}
+
+GC_API gc_status gc_result_copy(const gc_result* result,
+    double* xy, uint64_t xy_capacity,
+    uint64_t* ring_offsets, uint64_t ring_capacity,
+    uint64_t* polygon_offsets, uint64_t polygon_capacity,
+    uint64_t* xy_needed, uint64_t* ring_needed, uint64_t* polygon_needed)
+{
+    if (!result)
+        return Fail(GC_INVALID_ARGUMENT, "null result");
+
+    if (xy_needed) *xy_needed = result->xy.size();
+    if (ring_needed) *ring_needed = result->ringOffsets.size();
+    if (polygon_needed) *polygon_needed = result->polygonOffsets.size();
+
+    if (xy_capacity < result->xy.size()
+        || ring_capacity < result->ringOffsets.size()
+        || polygon_capacity < result->polygonOffsets.size())
+        return Fail(GC_BUFFER_TOO_SMALL, "output buffers too small");
+    if ((!xy && !result->xy.empty()) || !ring_offsets || !polygon_offsets)
+        return Fail(GC_INVALID_ARGUMENT, "null output buffer");
+
+    if (!result->xy.empty())
+        std::memcpy(xy, result->xy.data(), result->xy.size() * sizeof(double));
+    std::memcpy(ring_offsets, result->ringOffsets.data(), result->ringOffsets.size() * sizeof(uint64_t));
+    std::memcpy(polygon_offsets, result->polygonOffsets.data(), result->polygonOffsets.size() * sizeof(uint64_t));
+    lastError.clear();
+    return GC_OK;
+}
+
+GC_API void gc_result_free(gc_result* result)
+{
+    delete result;
+}
+
+GC_API const char* gc_last_error(void)
+{
+    return lastError.c_str();
+}
+
+} // extern "C"
@@ -0,0 +1,116 @@
+#pragma once
+#ifndef GEOMETRYCAPI_H
+#define GEOMETRYCAPI_H
+
+/*
+ * Flat C interface to the native geometry engines, for language bindings
+ * (.NET P/Invoke with pinned arrays, Python ctypes/cffi, Rust FFI).
+ *
+ * Geometry crosses the boundary as three flat arrays:
+ *
+ *   xy               x0, y0, x1, y1, ...           (point_count pairs)
+ *   ring_offsets     first point of each ring      (ring_count + 1 entries)
+ *   polygon_offsets  first ring of each polygon    (polygon_count + 1 entries)
+ *
+ * The last entry of each offset table is the total count. The first ring
+ * of a polygon is its outer boundary and the rest are holes, in any
+ * winding. Rings are implicitly closed, so do not repeat the first point.
+ * This is the same layout FlatPolygonStore keeps on disk.
+ *
+ * Input coordinates are read in place and never copied. Results are owned
+ * by the library: read them through gc_result_view without copying, or
+ * copy them into caller buffers with gc_result_copy. Result outer rings
+ * are counter-clockwise and holes clockwise.
+ *
+ * Every function is thread-safe and returns a gc_status. On failure,
+ * gc_last_error() describes the error for the calling thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  ifdef GEOMETRYCAPI_EXPORTS
+#    define GC_API __declspec(dllexport)
+#  else
+#    define GC_API __declspec(dllimport)
+#  endif
+#else
+#  define GC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum gc_status {
+    GC_OK = 0,
+    GC_INVALID_ARGUMENT = 1,
+    GC_BUFFER_TOO_SMALL = 2,
+    GC_OUT_OF_MEMORY = 3,
+    GC_INTERNAL_ERROR = 4
+} gc_status;
+
+/* Same values as GeometryCLI::BooleanOperation */
+typedef enum gc_boolean_op {
+    GC_UNION = 0,
+    GC_INTERSECTION = 1,
+    GC_A_MINUS_B = 2,
+    GC_B_MINUS_A = 3
+} gc_boolean_op;
+
+typedef enum gc_join_type {
+    GC_JOIN_MITER = 0,
+    GC_JOIN_ROUND = 1,
+    GC_JOIN_SQUARE = 2
+} gc_join_type;
+
+/* A set of polygons in the flat layout above. polygon_offsets may be NULL
+ * when every ring belongs to one polygon (polygon_count is then ignored). */
+typedef struct gc_polygons {
+    const double* xy;
+    const uint64_t* ring_offsets;
+    const uint64_t* polygon_offsets;
+    uint64_t point_count;
+    uint64_t ring_count;
+    uint64_t polygon_count;
+} gc_polygons;
+
+typedef struct gc_result gc_result;
+
+/* Boolean operation between the regions covered by a and b */
+GC_API gc_status gc_boolean(const gc_polygons* a, const gc_polygons* b,
+    gc_boolean_op op, gc_result** out);
+
+/* Buffer by a signed distance; miter_limit and arc_tolerance <= 0 select
+ * the defaults (2.0 and |distance| / 100) */
+GC_API gc_status gc_offset(const gc_polygons* a, double distance,
+    gc_join_type join, double miter_limit, double arc_tolerance, gc_result** out);
+
+/* Minkowski sum a + b and difference a - b (the no-fit polygon) */
+GC_API gc_status gc_minkowski_sum(const gc_polygons* a, const gc_polygons* b, gc_result** out);
+GC_API gc_status gc_minkowski_difference(const gc_polygons* a, const gc_polygons* b, gc_result** out);
+
+/* Zero-copy view of a result; valid until gc_result_free */
+GC_API void gc_result_view(const gc_result* result, gc_polygons* view);
+
+/* Copies a result into caller buffers (capacities in elements: xy_capacity
+ * counts doubles, the offset capacities count entries including the final
+ * total). The required sizes are always stored in the *_needed outputs
+ * (any of which may be NULL); GC_BUFFER_TOO_SMALL means nothing was copied. */
+GC_API gc_status gc_result_copy(const gc_result* result,
+    double* xy, uint64_t xy_capacity,
+    uint64_t* ring_offsets, uint64_t ring_capacity,
+    uint64_t* polygon_offsets, uint64_t polygon_capacity,
+    uint64_t* xy_needed, uint64_t* ring_needed, uint64_t* polygon_needed);
+
+GC_API void gc_result_free(gc_result* result);
+
+/* Message for the last failed call on this thread, or "" */
+GC_API const char* gc_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOMETRYCAPI_H */
@@ -0,0 +1,216 @@
+/*
+ * Tests the flat C API through the shared library, as a binding would
+ * call it: plain C, public header only.
+ */
+
+#include "../GeometryCAPI.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,      \
+                __LINE__, #cond);                                        \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                          \
+    do {                                                                 \
+        double a_ = (actual), e_ = (expected);                           \
+        if (fabs(a_ - e_) > (tolerance)) {                               \
+            fprintf(stderr, "%s:%d: %s = %.9g, expected %.9g\n",         \
+                __FILE__, __LINE__, #actual, a_, e_);                    \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+/* Signed area of every ring: outers count positive and holes negative */
+static double Area(const gc_polygons* p)
+{
+    double total = 0;
+    uint64_t r, i;
+    for (r = 0; r < p->ring_count; r++)
+    {
+        uint64_t first = p->ring_offsets[r], last = p->ring_offsets[r + 1];
+        double a = 0;
+        for (i = first; i < last; i++)
+        {
+            uint64_t j = i + 1 < last ? i + 1 : first;
+            a += p->xy[2 * i] * p->xy[2 * j + 1] - p->xy[2 * j] * p->xy[2 * i + 1];
+        }
+        total += a / 2;
+    }
+    return total;
+}
+
+static double ResultArea(const gc_result* result)
+{
+    gc_polygons view;
+    gc_result_view(result, &view);
+    return Area(&view);
+}
+
+/* A: 4 x 4 square with a 2 x 2 hole (area 12), B: 4 x 4 square
+ * overlapping A's right column (area 16); the overlap is 1 x 3 */
+static const double squareWithHole[] = {
+    0, 0, 4, 0, 4, 4, 0, 4,
+    1, 1, 1, 3, 3, 3, 3, 1
+};
+static const uint64_t squareWithHoleRings[] = { 0, 4, 8 };
+static const double shifted[] = { 3, 1, 7, 1, 7, 5, 3, 5 };
+static const uint64_t singleRing[] = { 0, 4 };
+
+static gc_polygons A(void)
+{
+    gc_polygons p = { squareWithHole, squareWithHoleRings, NULL, 8, 2, 0 };
+    return p;
+}
+
+static gc_polygons B(void)
+{
+    gc_polygons p = { shifted, singleRing, NULL, 4, 1, 0 };
+    return p;
+}
+
+static void TestBoolean(void)
+{
+    static const struct { gc_boolean_op op; double area; } cases[] = {
+        { GC_UNION, 25 },
+        { GC_INTERSECTION, 3 },
+        { GC_A_MINUS_B, 9 },
+        { GC_B_MINUS_A, 13 },
+    };
+    gc_polygons a = A(), b = B();
+    size_t i;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        gc_result* result = NULL;
+        CHECK(gc_boolean(&a, &b, cases[i].op, &result) == GC_OK);
+        CHECK(result != NULL);
+        if (result)
+            CHECK_NEAR(ResultArea(result), cases[i].area, 1e-9);
+        gc_result_free(result);
+    }
+}
+
+static void TestOffset(void)
+{
+    /* The 2 x 2 square in the middle of A's hole */
+    static const double square[] = { 1, 1, 3, 1, 3, 3, 1, 3 };
+    gc_polygons p = { square, singleRing, NULL, 4, 1, 0 };
+    gc_result* result = NULL;
+
+    CHECK(gc_offset(&p, 1.0, GC_JOIN_MITER, 0, 0, &result) == GC_OK);
+    if (result)
+        CHECK_NEAR(ResultArea(result), 16, 1e-9);
+    gc_result_free(result);
+
+    result = NULL;
+    CHECK(gc_offset(&p, -0.5, GC_JOIN_MITER, 0, 0, &result) == GC_OK);
+    if (result)
+        CHECK_NEAR(ResultArea(result), 1, 1e-9);
+    gc_result_free(result);
+
+    /* Round joins add a quarter disc per corner, up to the arc tolerance */
+    result = NULL;
+    CHECK(gc_offset(&p, 1.0, GC_JOIN_ROUND, 0, 0.001, &result) == GC_OK);
+    if (result)
+        CHECK_NEAR(ResultArea(result), 12 + 3.14159265358979, 0.01);
+    gc_result_free(result);
+
+    result = NULL;
+    CHECK(gc_offset(&p, 1.0, (gc_join_type)7, 0, 0, &result) == GC_INVALID_ARGUMENT);
+    CHECK(result == NULL);
+}
+
+static void TestResultCopy(void)
+{
+    gc_polygons a = A(), b = B();
+    gc_result* result = NULL;
+    uint64_t xyNeeded = 0, ringNeeded = 0, polygonNeeded = 0;
+    double* xy;
+    uint64_t* rings;
+    uint64_t* polygons;
+
+    CHECK(gc_boolean(&a, &b, GC_UNION, &result) == GC_OK);
+    if (!result)
+        return;
+
+    /* Sizing call: nothing to copy into, every size reported */
+    CHECK(gc_result_copy(result, NULL, 0, NULL, 0, NULL, 0,
+        &xyNeeded, &ringNeeded, &polygonNeeded) == GC_BUFFER_TOO_SMALL);
+    CHECK(*gc_last_error() != '\0');
+    CHECK(xyNeeded > 0 && xyNeeded % 2 == 0);
+    CHECK(ringNeeded == 3);    /* outer, A's hole, final total */
+    CHECK(polygonNeeded == 2); /* one polygon, final total */
+
+    xy = malloc(xyNeeded * sizeof(double));
+    rings = malloc(ringNeeded * sizeof(uint64_t));
+    polygons = malloc(polygonNeeded * sizeof(uint64_t));
+
+    /* One element short in a single buffer is still too small */
+    CHECK(gc_result_copy(result, xy, xyNeeded, rings, ringNeeded - 1, polygons, polygonNeeded,
+        NULL, NULL, NULL) == GC_BUFFER_TOO_SMALL);
+
+    CHECK(gc_result_copy(result, xy, xyNeeded, rings, ringNeeded, polygons, polygonNeeded,
+        NULL, NULL, NULL) == GC_OK);
+    CHECK(*gc_last_error() == '\0');
+    {
+        gc_polygons copy = { xy, rings, polygons, xyNeeded / 2, ringNeeded - 1, polygonNeeded - 1 };
+        CHECK_NEAR(Area(&copy), 25, 1e-9);
+        CHECK(rings[ringNeeded - 1] == xyNeeded / 2);
+        CHECK(polygons[0] == 0 && polygons[1] == ringNeeded - 1);
+    }
+
+    free(xy);
+    free(rings);
+    free(polygons);
+    gc_result_free(result);
+}
+
+static void TestBadInput(void)
+{
+    static const uint64_t outOfOrder[] = { 0, 6, 4 };
+    static const uint64_t pastEnd[] = { 0, 4, 9 };
+    gc_polygons a = A(), b = B();
+    gc_result* result = (gc_result*)&a; /* must be reset to NULL */
+
+    a.ring_offsets = outOfOrder;
+    CHECK(gc_boolean(&a, &b, GC_UNION, &result) == GC_INVALID_ARGUMENT);
+    CHECK(result == NULL);
+    CHECK(*gc_last_error() != '\0');
+
+    a.ring_offsets = pastEnd;
+    CHECK(gc_boolean(&a, &b, GC_UNION, &result) == GC_INVALID_ARGUMENT);
+    CHECK(result == NULL);
+
+    a.ring_offsets = NULL;
+    CHECK(gc_boolean(&a, &b, GC_UNION, &result) == GC_INVALID_ARGUMENT);
+
+    a = A();
+    CHECK(gc_boolean(&a, &b, (gc_boolean_op)9, &result) == GC_INVALID_ARGUMENT);
+    CHECK(gc_boolean(&a, NULL, GC_UNION, &result) == GC_INVALID_ARGUMENT);
+    CHECK(gc_boolean(&a, &b, GC_UNION, NULL) == GC_INVALID_ARGUMENT);
+}
+
+int main(void)
+{
+    TestBoolean();
+    TestOffset();
+    TestResultCopy();
+    TestBadInput();
+
+    if (failures)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("GeometryCAPI: all checks passed\n");
+    return 0;
+}
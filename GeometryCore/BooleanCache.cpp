@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "BooleanCache.h"
+#include "GeometryFingerprint.h"
+
+namespace
+{
+    size_t VertexCount(const PolygonView& p)
+    {
+        size_t n = 0;
+        for (size_t r = 0; r < p.RingCount(); r++)
+            n += p.RingAt(r).size();
+        return n;
+    }
+
+    // List node, hash node and bucket slot of one entry, roughly
+    const size_t EntryOverhead = 128;
+}
+
+BooleanCache::BooleanCache(const BooleanEngine& engine, size_t maxBytes)
+    : engine(engine), maxBytes(maxBytes)
+{
+}
+
+BooleanCache::Key BooleanCache::MakeKey(const PolygonView& A, const PolygonView& B, uint32_t call)
+{
+    return Key{ GeometryFingerprint(A), GeometryFingerprint(B), VertexCount(A), VertexCount(B), call };
+}
+
+size_t BooleanCache::ResultBytes(const std::vector<Polygon>& result)
+{
+    size_t n = sizeof(result) + result.capacity() * sizeof(Polygon);
+    for (const Polygon& p : result)
+    {
+        n += p.outer.vertices.capacity() * sizeof(Point) + p.holes.capacity() * sizeof(Ring);
+        for (const Ring& h : p.holes)
+            n += h.vertices.capacity() * sizeof(Point);
+    }
+    return n;
+}
+
+bool BooleanCache::Find(const Key& key, Entry& found)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        misses++;
+        return false;
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    found = *it->second;
+    return true;
+}
+
+void BooleanCache::Insert(Entry entry)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entry.bytes > maxBytes || index.count(entry.key))
+        return;
+    EvictTo(maxBytes - entry.bytes);
+    bytes += entry.bytes;
+    lru.push_front(std::move(entry));
+    index.emplace(lru.front().key, lru.begin());
+}
+
+void BooleanCache::EvictTo(size_t budget)
+{
+    while (bytes > budget && !lru.empty())
+    {
+        bytes -= lru.back().bytes;
+        index.erase(lru.back().key);
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+BooleanCache::Result BooleanCache::ComputeShared(const PolygonView& A, const PolygonView& B,
+    BoolOp operation, BooleanStats* stats)
+{
+    Key key = MakeKey(A, B, static_cast<uint32_t>(operation));
+    Entry entry;
+    if (Find(key, entry))
+        return entry.result;
+
+    auto result = std::make_shared<const std::vector<Polygon>>(engine.Compute(A, B, operation, stats));
+    Insert(Entry{ key, result, 0.0, EntryOverhead + ResultBytes(*result) });
+    return result;
+}
+
+std::vector<Polygon> BooleanCache::Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+    BooleanStats* stats)
+{
+    return *ComputeShared(A, B, operation, stats);
+}
+
+double BooleanCache::Predicate(const PolygonView& A, const PolygonView& B, Call call)
+{
+    Key key = MakeKey(A, B, call);
+    Entry entry;
+    if (Find(key, entry))
+        return entry.value;
+
+    BooleanOps ops;
+    double value = call == CallIoU ? ops.IoU(A, B) : ops.IntersectionArea(A, B);
+    Insert(Entry{ key, nullptr, value, EntryOverhead });
+    return value;
+}
+
+double BooleanCache::IntersectionArea(const PolygonView& A, const PolygonView& B)
+{
+    return Predicate(A, B, CallIntersectionArea);
+}
+
+double BooleanCache::IoU(const PolygonView& A, const PolygonView& B)
+{
+    return Predicate(A, B, CallIoU);
+}
+
+BooleanCacheStats BooleanCache::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    BooleanCacheStats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.evictions = evictions;
+    s.entries = lru.size();
+    s.bytes = bytes;
+    s.maxBytes = maxBytes;
+    return s;
+}
+
+void BooleanCache::ResetCounters()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hits = misses = evictions = 0;
+}
+
+void BooleanCache::SetMaxBytes(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    maxBytes = budget;
+    EvictTo(maxBytes);
+}
+
+void BooleanCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+    bytes = 0;
+}
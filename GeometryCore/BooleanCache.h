@@ -0,0 +1,129 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "BooleanEngine.h"
+
+// Memoizes boolean results and overlap predicates in front of a
+// BooleanEngine, for pipelines that repeat the same (A, B, operation)
+// calls: one clip window against the same tiles, an editor recomputing an
+// unchanged pair.
+//
+// Inputs are keyed by GeometryFingerprint plus their vertex counts, so a
+// lookup hashes both inputs (a few GB/s) and never compares coordinates;
+// two different inputs would have to collide on all 64 bits to be
+// confused. Entries are evicted least recently used first once the bytes
+// held pass the budget. A result larger than the whole budget is returned
+// but not kept.
+//
+// All members are safe to call from several threads. The lock is held for
+// the lookup and the list splice only: engines run and hits are copied
+// outside it, so two threads missing on the same key both compute it.
+
+struct BooleanCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;    // estimated heap held by the entries
+    size_t maxBytes = 0;
+
+    double HitRate() const
+    {
+        uint64_t calls = hits + misses;
+        return calls ? static_cast<double>(hits) / static_cast<double>(calls) : 0.0;
+    }
+};
+
+class BooleanCache
+{
+public:
+    using Result = std::shared_ptr<const std::vector<Polygon>>;
+
+    // The engine must outlive the cache. Clear the cache after changing
+    // which engines the engine may pick, or earlier answers stay in it.
+    explicit BooleanCache(const BooleanEngine& engine, size_t maxBytes = size_t(64) << 20);
+
+    // stats only collects phases on a miss; hits do not touch it
+    std::vector<Polygon> Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // Shares the cached result instead of copying it
+    Result ComputeShared(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // BooleanOps::IntersectionArea and BooleanOps::IoU, cached
+    double IntersectionArea(const PolygonView& A, const PolygonView& B);
+    double IoU(const PolygonView& A, const PolygonView& B);
+
+    BooleanCacheStats Stats() const;
+    void ResetCounters(); // hits, misses and evictions; keeps the entries
+
+    // Evicts down to the new budget right away
+    void SetMaxBytes(size_t maxBytes);
+    void Clear();
+
+private:
+    // Boolean operations use the BoolOp value; predicates come after them
+    enum Call : uint32_t
+    {
+        CallIntersectionArea = 16,
+        CallIoU
+    };
+
+    struct Key
+    {
+        uint64_t a;
+        uint64_t b;
+        uint64_t verticesA;
+        uint64_t verticesB;
+        uint32_t call;
+
+        bool operator==(const Key& o) const
+        {
+            return a == o.a && b == o.b && verticesA == o.verticesA && verticesB == o.verticesB &&
+                call == o.call;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const
+        {
+            return static_cast<size_t>(k.a ^ (k.b * 0x9E3779B97F4A7C15ULL) ^ k.call);
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        Result result; // null for predicates
+        double value;
+        size_t bytes;
+    };
+
+    static Key MakeKey(const PolygonView& A, const PolygonView& B, uint32_t call);
+    static size_t ResultBytes(const std::vector<Polygon>& result);
+
+    bool Find(const Key& key, Entry& found);
+    void Insert(Entry entry);
+    void EvictTo(size_t budget); // caller holds mutex
+
+    double Predicate(const PolygonView& A, const PolygonView& B, Call call);
+
+    const BooleanEngine& engine;
+
+    mutable std::mutex mutex;
+    std::list<Entry> lru; // most recent first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    size_t bytes = 0;
+    size_t maxBytes;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
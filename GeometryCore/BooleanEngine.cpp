@@ -0,0 +1,344 @@
+#include "pch.h"
+#include "BooleanEngine.h"
+#include "MetricsRegistry.h"
+#include "NativeRings.h"
+#include "TraceRecorder.h"
+#include "WorkloadGenerator.h"
+#include "../BooleanNative/WindingOverlay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    struct Box
+    {
+        double minX = HUGE_VAL, minY = HUGE_VAL;
+        double maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    };
+
+    Box Bounds(RingView ring)
+    {
+        Box b;
+        for (const Point& p : ring)
+        {
+            b.minX = std::min(b.minX, p.x);
+            b.minY = std::min(b.minY, p.y);
+            b.maxX = std::max(b.maxX, p.x);
+            b.maxY = std::max(b.maxY, p.y);
+        }
+        return b;
+    }
+
+    // Same turn test as PolygonBoolean::Polygon::isConvex, on the ring in place
+    bool IsConvex(RingView ring)
+    {
+        const double eps = 1e-10;
+        size_t n = ring.size();
+        if (n < 3)
+            return true;
+
+        bool hasPositive = false;
+        bool hasNegative = false;
+        for (size_t i = 0; i < n; i++)
+        {
+            const Point& a = ring[(i + n - 1) % n];
+            const Point& b = ring[i];
+            const Point& c = ring[(i + 1) % n];
+            double cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+            if (cross > eps)
+                hasPositive = true;
+            if (cross < -eps)
+                hasNegative = true;
+            if (hasPositive && hasNegative)
+                return false;
+        }
+        return true;
+    }
+
+    size_t VertexTotal(const PolygonView& poly)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < poly.RingCount(); i++)
+            n += poly.RingAt(i).size();
+        return n;
+    }
+
+    // Outer ring CCW and holes CW, or the other way round when reversed;
+    // a reversed operand subtracts from the winding
+    void AddRings(const PolygonView& poly, bool reversed, std::vector<PolygonBoolean::RingSpan>& rings)
+    {
+        for (size_t i = 0; i < poly.RingCount(); i++)
+        {
+            PolygonBoolean::RingSpan ring = ToRingSpan(poly.RingAt(i)).ccw();
+            rings.push_back((i > 0) != reversed ? ring.reverse() : ring);
+        }
+    }
+
+    void CountOutput(BooleanStats* stats, const std::vector<Polygon>& result)
+    {
+        if (!stats)
+            return;
+        stats->calls++;
+        for (const Polygon& p : result)
+        {
+            stats->outputRings += 1 + p.holes.size();
+            stats->outputVertices += p.outer.vertices.size();
+            for (const Ring& h : p.holes)
+                stats->outputVertices += h.vertices.size();
+        }
+        stats->allocations += result.size();
+    }
+
+    // Fits y = a + b x minimizing relative error, so small inputs weigh as
+    // much as large ones; both terms are clamped at zero
+    EngineCost Fit(const std::vector<std::pair<double, double>>& samples)
+    {
+        double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (const auto& [x, y] : samples)
+        {
+            double w = 1.0 / (y * y);
+            sw += w;
+            sx += w * x;
+            sy += w * y;
+            sxx += w * x * x;
+            sxy += w * x * y;
+        }
+
+        EngineCost cost;
+        double det = sw * sxx - sx * sx;
+        if (samples.size() < 2 || det <= 0)
+        {
+            cost.fixedNs = sw > 0 ? sy / sw : 0;
+            return cost;
+        }
+        cost.unitNs = std::max((sw * sxy - sx * sy) / det, 0.0);
+        cost.fixedNs = std::max((sy - cost.unitNs * sx) / sw, 0.0);
+        return cost;
+    }
+}
+
+BooleanFeatures BooleanFeatures::Of(const PolygonView& A, const PolygonView& B, BoolOp op)
+{
+    BooleanFeatures f;
+    f.op = op;
+    f.verticesA = VertexTotal(A);
+    f.verticesB = VertexTotal(B);
+    f.holes = A.HoleCount() + B.HoleCount();
+
+    RingView outerA = A.Outer();
+    RingView outerB = B.Outer();
+    if (outerA.size() < 3 || outerB.size() < 3)
+    {
+        f.disjoint = true;
+        return f;
+    }
+    f.convexA = A.HoleCount() == 0 && IsConvex(outerA);
+    f.convexB = B.HoleCount() == 0 && IsConvex(outerB);
+
+    Box a = Bounds(outerA);
+    Box b = Bounds(outerB);
+    f.disjoint = std::max(a.minX, b.minX) > std::min(a.maxX, b.maxX) ||
+        std::max(a.minY, b.minY) > std::min(a.maxY, b.maxY);
+    return f;
+}
+
+BooleanEngine::BooleanEngine()
+{
+    SetCost(EngineKind::ConvexClip, { 400, 6.0 });
+    SetCost(EngineKind::GreinerHormann, { 600, 11.0 });
+    SetCost(EngineKind::WindingOverlay, { 10000, 100.0 });
+
+    for (bool& on : allowed)
+        on = true;
+    Allow(EngineKind::GreinerHormann, false);
+}
+
+bool BooleanEngine::Supports(EngineKind engine, const BooleanFeatures& f)
+{
+    switch (engine)
+    {
+    case EngineKind::ConvexClip:
+        return f.op == BoolOp::Intersection && f.convexA && f.convexB;
+    case EngineKind::GreinerHormann:
+        return f.holes == 0;
+    case EngineKind::WindingOverlay:
+        return true;
+    default:
+        return false;
+    }
+}
+
+double BooleanEngine::Work(EngineKind engine, const BooleanFeatures& f)
+{
+    if (engine == EngineKind::WindingOverlay)
+    {
+        double n = static_cast<double>(f.verticesA + f.verticesB);
+        return n * std::log2(std::max(n, 2.0));
+    }
+    return static_cast<double>(f.verticesA) * static_cast<double>(f.verticesB);
+}
+
+double BooleanEngine::PredictNs(EngineKind engine, const BooleanFeatures& f) const
+{
+    const EngineCost& c = Cost(engine);
+    return c.fixedNs + c.unitNs * Work(engine, f);
+}
+
+EngineKind BooleanEngine::Choose(const BooleanFeatures& f) const
+{
+    EngineKind best = EngineKind::WindingOverlay;
+    double bestNs = PredictNs(best, f);
+    for (size_t i = 0; i < static_cast<size_t>(EngineKind::Count); i++)
+    {
+        EngineKind engine = static_cast<EngineKind>(i);
+        if (!Allowed(engine) || !Supports(engine, f))
+            continue;
+        double ns = PredictNs(engine, f);
+        if (ns < bestNs)
+        {
+            best = engine;
+            bestNs = ns;
+        }
+    }
+    return best;
+}
+
+std::vector<Polygon> BooleanEngine::Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+    BooleanStats* stats) const
+{
+    TraceScope trace("engine.dispatch");
+    BooleanFeatures f = BooleanFeatures::Of(A, B, operation);
+    if (!f.disjoint)
+        return Run(A, B, operation, Choose(f), stats);
+
+    // Nothing to clip: each operand survives whole or not at all
+    PhaseTimer timer(stats, BooleanStats::Assemble);
+    std::vector<Polygon> result;
+    bool keepA = operation == BoolOp::Union || operation == BoolOp::AminusB;
+    bool keepB = operation == BoolOp::Union || operation == BoolOp::BminusA;
+    if (keepA && A.Outer().size() >= 3)
+        result.push_back(A.ToPolygon());
+    if (keepB && B.Outer().size() >= 3)
+        result.push_back(B.ToPolygon());
+    CountOutput(stats, result);
+    return result;
+}
+
+std::vector<Polygon> BooleanEngine::Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+    EngineKind engine, BooleanStats* stats) const
+{
+    if (!Supports(engine, BooleanFeatures::Of(A, B, operation)))
+        throw std::invalid_argument(std::string(EngineName(engine)) + " does not support this input");
+    return Run(A, B, operation, engine, stats);
+}
+
+std::vector<Polygon> BooleanEngine::Run(const PolygonView& A, const PolygonView& B, BoolOp operation,
+    EngineKind engine, BooleanStats* stats) const
+{
+    switch (engine)
+    {
+    case EngineKind::ConvexClip:
+    {
+        Polygonutility util;
+        std::vector<Point> subject(A.Outer().begin(), A.Outer().end());
+        std::vector<Point> clip(B.Outer().begin(), B.Outer().end());
+
+        std::vector<Polygon> result;
+        {
+            PhaseTimer timer(stats, BooleanStats::Clip);
+            std::vector<Point> clipped = util.ClipPolygon(subject, clip, util);
+            if (clipped.size() >= 3)
+                result.emplace_back().outer.vertices = std::move(clipped);
+        }
+        CountOutput(stats, result);
+        return result;
+    }
+
+    case EngineKind::GreinerHormann:
+    {
+        BooleanOps ops;
+        return ops.ComputeBoolean2(A, B, operation, stats);
+    }
+
+    case EngineKind::WindingOverlay:
+    {
+        // Union is winding >= 1 and intersection >= 2; a difference adds
+        // the subtrahend reversed
+        ScopedLatency latency(MetricOp::WindingOverlay, VertexTotal(A) + VertexTotal(B));
+        TraceScope trace("windingOverlay", VertexTotal(A) + VertexTotal(B));
+        std::vector<PolygonBoolean::RingSpan> rings;
+        AddRings(A, operation == BoolOp::BminusA, rings);
+        AddRings(B, operation == BoolOp::AminusB, rings);
+        int minWinding = operation == BoolOp::Intersection ? 2 : 1;
+
+        std::vector<NativeRing> resolved = PolygonBoolean::WindingOverlay::resolve(rings, minWinding);
+        PhaseTimer timer(stats, BooleanStats::Assemble);
+        std::vector<Polygon> result = AssembleNativeRings(resolved);
+        CountOutput(stats, result);
+        return result;
+    }
+
+    default:
+        return {};
+    }
+}
+
+void BooleanEngine::Calibrate(uint64_t seed)
+{
+    using Clock = std::chrono::steady_clock;
+    const WorkloadKind kinds[] = { WorkloadKind::Convex, WorkloadKind::Star };
+    const size_t sizes[] = { 8, 32, 128, 512 };
+    const double minNs = 2e6; // per engine and pair
+
+    std::vector<std::pair<double, double>> samples[static_cast<size_t>(EngineKind::Count)];
+    WorkloadGenerator gen(seed);
+    for (WorkloadKind kind : kinds)
+    {
+        for (size_t n : sizes)
+        {
+            Workload w = gen.Generate(kind, n);
+            const Polygon& a = w.a[0];
+            const Polygon& b = w.b[0];
+            BooleanFeatures f = BooleanFeatures::Of(a, b, BoolOp::Intersection);
+
+            for (size_t i = 0; i < static_cast<size_t>(EngineKind::Count); i++)
+            {
+                EngineKind engine = static_cast<EngineKind>(i);
+                if (!Supports(engine, f))
+                    continue;
+
+                // Fastest of repeated calls, at least three and at least minNs
+                double best = HUGE_VAL;
+                double spent = 0;
+                for (int rep = 0; rep < 3 || spent < minNs; rep++)
+                {
+                    Clock::time_point start = Clock::now();
+                    Run(a, b, BoolOp::Intersection, engine, nullptr);
+                    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                    best = std::min(best, ns);
+                    spent += ns;
+                }
+                samples[i].push_back({ Work(engine, f), std::max(best, 1.0) });
+            }
+        }
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(EngineKind::Count); i++)
+    {
+        if (!samples[i].empty())
+            costs[i] = Fit(samples[i]);
+    }
+}
+
+const char* BooleanEngine::EngineName(EngineKind engine)
+{
+    switch (engine)
+    {
+    case EngineKind::ConvexClip:        return "convex-clip";
+    case EngineKind::GreinerHormann:    return "greiner-hormann";
+    case EngineKind::WindingOverlay:    return "winding-overlay";
+    default:                            return "unknown";
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BooleanOps.h"
+#include "GeometryViews.h"
+
+// Front door for boolean operations: picks the engine expected to be
+// fastest for each input pair, so callers do not have to know which one
+// wins where.
+//
+// The choice is made from cheap features (vertex counts, convexity, holes,
+// operation). Engines that cannot give an exact answer for an input are
+// never considered, nor are engines not allowed (Greiner–Hormann by
+// default, see Allow); among the rest, the one with the lowest predicted
+// time runs. Predictions come from a per-engine
+// linear model, fixed cost plus cost per unit of work, which Calibrate
+// refits on the host. Pairs whose bounding boxes do not overlap are
+// answered without running any engine.
+
+// BooleanOps::ComputeBoolean (Sutherland–Hodgman) is not an engine here:
+// on the inputs it is exact for, two convex rings, it runs the same
+// ClipPolygon as ConvexClip after containment tests and copies of both
+// inputs, so the model could never prefer it.
+enum class EngineKind
+{
+    ConvexClip,     // Polygonutility::ClipPolygon alone; intersection of two convex rings
+    GreinerHormann, // BooleanOps::ComputeBoolean2; any operation, outer rings only (opt-in)
+    WindingOverlay, // PolygonBoolean::WindingOverlay sweep; any operation, holes included
+    Count
+};
+
+struct BooleanFeatures
+{
+    BoolOp op = BoolOp::Union;
+    size_t verticesA = 0; // all rings
+    size_t verticesB = 0;
+    size_t holes = 0;     // both inputs
+    bool convexA = false;
+    bool convexB = false;
+    bool disjoint = false; // bboxes neither overlap nor touch, or an input is empty
+
+    static BooleanFeatures Of(const PolygonView& A, const PolygonView& B, BoolOp op);
+};
+
+// Predicted ns = fixedNs + unitNs * work, where work is verticesA *
+// verticesB for the edge-pair engines and n log2 n of the total vertex
+// count for the sweep
+struct EngineCost
+{
+    double fixedNs = 0;
+    double unitNs = 0;
+};
+
+class BooleanEngine
+{
+public:
+    // Starts from costs measured on a reference x64 machine
+    BooleanEngine();
+
+    // When stats is set, the engines that report phases add to it
+    std::vector<Polygon> Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        BooleanStats* stats = nullptr) const;
+
+    // Runs the given engine regardless of the model; throws
+    // std::invalid_argument if it does not support the input
+    std::vector<Polygon> Compute(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        EngineKind engine, BooleanStats* stats = nullptr) const;
+
+    EngineKind Choose(const BooleanFeatures& features) const;
+    double PredictNs(EngineKind engine, const BooleanFeatures& features) const;
+
+    static bool Supports(EngineKind engine, const BooleanFeatures& features);
+    static double Work(EngineKind engine, const BooleanFeatures& features);
+
+    // Times every engine, allowed or not, on seeded convex and concave
+    // pairs of a few sizes and refits the model by least squares; takes a
+    // fraction of a second. Not safe to run while other threads call
+    // Compute on this engine.
+    void Calibrate(uint64_t seed = 1);
+
+    // Whether Choose may pick the engine. Greiner–Hormann starts out
+    // disallowed: it has no fallback for rings that do not cross (it
+    // returns nothing for containment) and loses track of entry/exit when
+    // edges cross many times, so its output is only right for simple
+    // overlaps.
+    void Allow(EngineKind engine, bool on = true) { allowed[static_cast<size_t>(engine)] = on; }
+    bool Allowed(EngineKind engine) const { return allowed[static_cast<size_t>(engine)]; }
+
+    const EngineCost& Cost(EngineKind engine) const { return costs[static_cast<size_t>(engine)]; }
+    void SetCost(EngineKind engine, const EngineCost& cost) { costs[static_cast<size_t>(engine)] = cost; }
+
+    static const char* EngineName(EngineKind engine);
+
+private:
+    std::vector<Polygon> Run(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        EngineKind engine, BooleanStats* stats) const;
+
+    EngineCost costs[static_cast<size_t>(EngineKind::Count)];
+    bool allowed[static_cast<size_t>(EngineKind::Count)];
+};
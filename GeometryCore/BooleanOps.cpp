@@ -1,5 +1,38 @@
 ﻿#include "pch.h"
 #include "BooleanOps.h"
+#include "CallRecorder.h"
+#include "MetricsRegistry.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    size_t VertexTotal(const std::vector<Polygon>& polys)
+    {
+        size_t n = 0;
+        for (const Polygon& p : polys)
+        {
+            n += p.outer.vertices.size();
+            for (const Ring& h : p.holes)
+                n += h.vertices.size();
+        }
+        return n;
+    }
+
+    void CountOutput(BooleanStats* stats, const std::vector<Polygon>& result)
+    {
+        if (!stats)
+            return;
+        size_t rings = 0;
+        for (const Polygon& p : result)
+            rings += 1 + p.holes.size();
+        stats->calls++;
+        stats->outputRings += rings;
+        stats->outputVertices += VertexTotal(result);
+        stats->allocations += rings;
+    }
+}
 
 bool BooleanOps::KeepSegment(bool inA, bool inB, BoolOp op)
 {
@@ -12,12 +45,16 @@ bool BooleanOps::KeepSegment(bool inA, bool inB, BoolOp op)
     return false;
 }
 
-std::vector<Polygon> BooleanOps::ComputeBoolean(
-    const Polygon& A,
-    const Polygon& B,
-    BoolOp operation)
+BooleanOps::ClipOutcome BooleanOps::ClassifyInputs(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    BooleanStats* stats)
 {
-    std::vector<Polygon> result;
+    // Clipping is charged to its own phase; the rest is classification
+    PhaseTimer timer(stats, BooleanStats::Classify);
+    TraceScope trace("sh.classify");
+    ClipOutcome result;
     Polygonutility util;
 
     switch (operation)
@@ -33,7 +70,7 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
 
         // Case 1: A fully inside B
         bool allInside = true;
-        for (const Point& p : A.outer.vertices)
+        for (const Point& p : A.Outer())
         {
             if (!util.PointInPolygon(p, B))
             {
@@ -43,13 +80,13 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         }
         if (allInside)
         {
-            result.push_back(A);
+            result.keepA = true;
             return result;
         }
 
         // Case 2: B fully inside A
         allInside = true;
-        for (const Point& p : B.outer.vertices)
+        for (const Point& p : B.Outer())
         {
             if (!util.PointInPolygon(p, A))
             {
@@ -59,21 +96,19 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         }
         if (allInside)
         {
-            result.push_back(B);
+            result.keepB = true;
             return result;
         }
 
         // Case 3: Partial overlap (CLIPPING)
-        std::vector<Point> clipped =
-            util.ClipPolygon(A.outer.vertices, B.outer.vertices, util);
-
-        if (clipped.size() < 3)
-            return result;
-
-        Polygon intersectionPoly;
-        intersectionPoly.outer.vertices = clipped;
+        std::vector<Point> clipped;
+        {
+            PhaseTimer clip(stats, BooleanStats::Clip);
+            clipped = util.ClipPolygon(A.Outer(), B.Outer(), util);
+        }
 
-        result.push_back(intersectionPoly);
+        if (clipped.size() >= 3)
+            result.clipped = std::move(clipped);
         return result;
     }
 
@@ -85,14 +120,14 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         // No overlap → union is both polygons
         if (!util.PolygonsOverlap(A, B))
         {
-            result.push_back(A);
-            result.push_back(B);
+            result.keepA = true;
+            result.keepB = true;
             return result;
         }
 
         // A fully inside B → union is B
         bool allInside = true;
-        for (const Point& p : A.outer.vertices)
+        for (const Point& p : A.Outer())
         {
             if (!util.PointInPolygon(p, B))
             {
@@ -102,13 +137,13 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         }
         if (allInside)
         {
-            result.push_back(B);
+            result.keepB = true;
             return result;
         }
 
         // B fully inside A → union is A
         allInside = true;
-        for (const Point& p : B.outer.vertices)
+        for (const Point& p : B.Outer())
         {
             if (!util.PointInPolygon(p, A))
             {
@@ -118,14 +153,14 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         }
         if (allInside)
         {
-            result.push_back(A);
+            result.keepA = true;
             return result;
         }
 
         // Partial overlap (approximate union)
         // Strategy: return both boundaries (visual union)
-        result.push_back(A);
-        result.push_back(B);
+        result.keepA = true;
+        result.keepB = true;
         return result;
     }
 
@@ -138,13 +173,13 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         // No overlap → A remains unchanged
         if (!util.PolygonsOverlap(A, B))
         {
-            result.push_back(A);
+            result.keepA = true;
             return result;
         }
 
         // A fully inside B → empty
         bool allInside = true;
-        for (const Point& p : A.outer.vertices)
+        for (const Point& p : A.Outer())
         {
             if (!util.PointInPolygon(p, B))
             {
@@ -156,16 +191,14 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
             return result; // empty
 
         // Partial overlap → subtract B from A
-        std::vector<Point> clipped =
-            util.ClipPolygonOutside(A.outer.vertices, B.outer.vertices, util);
-
-        if (clipped.size() < 3)
-            return result;
-
-        Polygon diff;
-        diff.outer.vertices = clipped;
+        std::vector<Point> clipped;
+        {
+            PhaseTimer clip(stats, BooleanStats::Clip);
+            clipped = util.ClipPolygonOutside(A.Outer(), B.Outer(), util);
+        }
 
-        result.push_back(diff);
+        if (clipped.size() >= 3)
+            result.clipped = std::move(clipped);
         return result;
     }
 
@@ -178,13 +211,13 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
         // No overlap → B remains unchanged
         if (!util.PolygonsOverlap(A, B))
         {
-            result.push_back(B);
+            result.keepB = true;
             return result;
         }
 
         // B fully inside A → empty
         bool allInside = true;
-        for (const Point& p : B.outer.vertices)
+        for (const Point& p : B.Outer())
         {
             if (!util.PointInPolygon(p, A))
             {
@@ -196,16 +229,14 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
             return result; // empty
 
         // Partial overlap → subtract A from B
-        std::vector<Point> clipped =
-            util.ClipPolygonOutside(B.outer.vertices, A.outer.vertices, util);
-
-        if (clipped.size() < 3)
-            return result;
-
-        Polygon diff;
-        diff.outer.vertices = clipped;
+        std::vector<Point> clipped;
+        {
+            PhaseTimer clip(stats, BooleanStats::Clip);
+            clipped = util.ClipPolygonOutside(B.Outer(), A.Outer(), util);
+        }
 
-        result.push_back(diff);
+        if (clipped.size() >= 3)
+            result.clipped = std::move(clipped);
         return result;
     }
 
@@ -215,20 +246,110 @@ std::vector<Polygon> BooleanOps::ComputeBoolean(
     }
 }
 
-std::vector<Polygon>
-BooleanOps::ComputeBoolean2(
+std::vector<Polygon> BooleanOps::ComputeBoolean(
     const Polygon& A,
     const Polygon& B,
-    BoolOp operation)
+    BoolOp operation,
+    BooleanStats* stats)
+{
+    ScopedLatency latency(MetricOp::ShBoolean, A.outer.vertices.size() + B.outer.vertices.size());
+    TraceScope trace("sh.boolean", A.outer.vertices.size() + B.outer.vertices.size());
+    CallCapture capture(CallEngine::SutherlandHodgman, operation, A, B);
+    ClipOutcome outcome = ClassifyInputs(A, B, operation, stats);
+
+    PhaseTimer timer(stats, BooleanStats::Assemble);
+    std::vector<Polygon> result;
+    if (outcome.keepA)
+        result.push_back(A);
+    if (outcome.keepB)
+        result.push_back(B);
+    if (!outcome.clipped.empty())
+        result.emplace_back().outer.vertices = std::move(outcome.clipped);
+    CountOutput(stats, result);
+    capture.Finish(result);
+    return result;
+}
+
+// Inputs that survive unchanged are moved into the result, not copied
+std::vector<Polygon> BooleanOps::ComputeBoolean(
+    Polygon&& A,
+    Polygon&& B,
+    BoolOp operation,
+    BooleanStats* stats)
+{
+    ScopedLatency latency(MetricOp::ShBoolean, A.outer.vertices.size() + B.outer.vertices.size());
+    TraceScope trace("sh.boolean", A.outer.vertices.size() + B.outer.vertices.size());
+    CallCapture capture(CallEngine::SutherlandHodgman, operation, A, B);
+    ClipOutcome outcome = ClassifyInputs(A, B, operation, stats);
+
+    PhaseTimer timer(stats, BooleanStats::Assemble);
+    std::vector<Polygon> result;
+    if (outcome.keepA)
+        result.push_back(std::move(A));
+    if (outcome.keepB)
+        result.push_back(std::move(B));
+    if (!outcome.clipped.empty())
+        result.emplace_back().outer.vertices = std::move(outcome.clipped);
+    CountOutput(stats, result);
+    capture.Finish(result);
+    return result;
+}
+
+// Read in place; only an input that survives whole is copied out
+std::vector<Polygon> BooleanOps::ComputeBoolean(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    BooleanStats* stats)
+{
+    ScopedLatency latency(MetricOp::ShBoolean, A.Outer().size() + B.Outer().size());
+    TraceScope trace("sh.boolean", A.Outer().size() + B.Outer().size());
+    CallCapture capture(CallEngine::SutherlandHodgman, operation, A, B);
+    ClipOutcome outcome = ClassifyInputs(A, B, operation, stats);
+
+    PhaseTimer timer(stats, BooleanStats::Assemble);
+    std::vector<Polygon> result;
+    if (outcome.keepA)
+        result.push_back(A.ToPolygon());
+    if (outcome.keepB)
+        result.push_back(B.ToPolygon());
+    if (!outcome.clipped.empty())
+        result.emplace_back().outer.vertices = std::move(outcome.clipped);
+    CountOutput(stats, result);
+    capture.Finish(result);
+    return result;
+}
+
+std::vector<Polygon>
+BooleanOps::ComputeBoolean2(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    BooleanStats* stats)
 {
+    // Building the Polygons happens inside the sink and so counts as Trace
     std::vector<Polygon> result;
+    ComputeBoolean2(A, B, operation, [&](RingView loop) {
+        result.emplace_back().outer.vertices.assign(loop.begin(), loop.end());
+    }, stats);
+    if (stats)
+        stats->allocations += result.size();
+    return result;
+}
 
+size_t BooleanOps::ComputeBoolean2(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    const RingSink& sink,
+    BooleanStats* stats)
+{
     // ---------------------------------
-    // Extract outer rings only
+    // Outer rings only, read in place
     // (GH does NOT handle holes)
     // ---------------------------------
-    std::vector<Point> polyA = A.outer.vertices;
-    std::vector<Point> polyB = B.outer.vertices;
+    RingView polyA = A.Outer();
+    RingView polyB = B.Outer();
 
     PolygonUtilityExtension gh;
 
@@ -255,31 +376,313 @@ BooleanOps::ComputeBoolean2(
         break;
 
     default:
-        return result;
+        return 0;
     }
 
     // ---------------------------------
-    // Single GH compute call
+    // Single GH compute call; loops go
+    // straight to the sink (GH only
+    // emits loops of 3+ points)
     // ---------------------------------
-    std::vector<std::vector<Point>> ghResult =
-        gh.Compute(polyA, polyB, ghOp);
+    CallCapture capture(CallEngine::GreinerHormann, operation, A, B);
+    if (!capture.Active())
+        return gh.Compute(polyA, polyB, ghOp, sink, stats);
+
+    size_t emitted = gh.Compute(polyA, polyB, ghOp, [&](RingView loop) {
+        capture.AddRing(loop);
+        sink(loop);
+    }, stats);
+    capture.Finish();
+    return emitted;
+}
+
 
-    // ---------------------------------
-    // Convert GH loops → Polygon
-    // ---------------------------------
-    for (const auto& loop : ghResult)
-    {
-        if (loop.size() < 3)
-            continue;
 
-        Polygon p;
-        p.outer.vertices = loop;
-        result.push_back(p);
-    }
 
+
+
+// =====================================================
+// Result simplification
+// =====================================================
+std::vector<Polygon> BooleanOps::ComputeBoolean(
+    const Polygon& A,
+    const Polygon& B,
+    BoolOp operation,
+    const SimplifyOptions& simplify,
+    BooleanStats* stats)
+{
+    std::vector<Polygon> result = ComputeBoolean(A, B, operation, stats);
+    SimplifyResult(result, simplify, stats);
+    return result;
+}
+
+std::vector<Polygon> BooleanOps::ComputeBoolean(
+    Polygon&& A,
+    Polygon&& B,
+    BoolOp operation,
+    const SimplifyOptions& simplify,
+    BooleanStats* stats)
+{
+    std::vector<Polygon> result = ComputeBoolean(std::move(A), std::move(B), operation, stats);
+    SimplifyResult(result, simplify, stats);
+    return result;
+}
+
+std::vector<Polygon> BooleanOps::ComputeBoolean(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    const SimplifyOptions& simplify,
+    BooleanStats* stats)
+{
+    std::vector<Polygon> result = ComputeBoolean(A, B, operation, stats);
+    SimplifyResult(result, simplify, stats);
     return result;
 }
 
+std::vector<Polygon> BooleanOps::ComputeBoolean2(
+    const PolygonView& A,
+    const PolygonView& B,
+    BoolOp operation,
+    const SimplifyOptions& simplify,
+    BooleanStats* stats)
+{
+    std::vector<Polygon> result = ComputeBoolean2(A, B, operation, stats);
+    SimplifyResult(result, simplify, stats);
+    return result;
+}
+
+void BooleanOps::SimplifyResult(std::vector<Polygon>& result, const SimplifyOptions& options,
+    BooleanStats* stats)
+{
+    PhaseTimer timer(stats, BooleanStats::Simplify);
+    if (stats)
+        stats->outputVertices -= VertexTotal(result);
+    TraceScope trace("simplify", result.size());
+    Polygonutility util;
+
+    auto cleanRing = [&](std::vector<Point>& ring)
+        {
+            if (options.removeRedundant)
+                util.RemoveRedundantVertices(ring);
+            if (options.tolerance > 0)
+                util.SimplifyRing(ring, options.tolerance);
+        };
+
+    for (Polygon& poly : result)
+    {
+        cleanRing(poly.outer.vertices);
+        for (Ring& hole : poly.holes)
+            cleanRing(hole.vertices);
+    }
+
+    // Output vertices are the ones left after simplification
+    if (stats)
+        stats->outputVertices += VertexTotal(result);
+}
+
+// =====================================================
+// Overlap area (no output geometry)
+// =====================================================
+namespace
+{
+    enum class EdgeSide { Outside, Inside, SameEdge, OppositeEdge };
+
+    struct RingInfo
+    {
+        RingView pts;
+        double sign; // +1 if the ring already has its canonical orientation
+    };
 
+    double RingArea2(RingView pts)
+    {
+        double area = 0.0;
+        for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+            area += pts[j].x * pts[i].y - pts[i].x * pts[j].y;
+        return area;
+    }
 
+    // Outer rings are canonical when CCW, holes when CW.
+    void CollectRings(const PolygonView& P, std::vector<RingInfo>& rings)
+    {
+        rings.clear();
+        for (size_t i = 0; i < P.RingCount(); i++)
+        {
+            RingView r = P.RingAt(i);
+            if (r.size() < 3)
+                continue;
+            double area2 = RingArea2(r);
+            rings.push_back({ r, (i == 0 ? area2 >= 0 : area2 <= 0) ? 1.0 : -1.0 });
+        }
+    }
 
+    double PolygonArea(const std::vector<RingInfo>& rings)
+    {
+        double area = 0.0;
+        for (const RingInfo& r : rings)
+            area += r.sign * RingArea2(r.pts);
+        return area * 0.5;
+    }
+
+    void Bounds(RingView pts, double& minX, double& minY, double& maxX, double& maxY)
+    {
+        minX = minY = HUGE_VAL;
+        maxX = maxY = -HUGE_VAL;
+        for (const Point& p : pts)
+        {
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+        }
+    }
+
+    // Classify a boundary piece (midpoint m, canonical direction d) against
+    // the other polygon. Pieces lying on the other boundary are reported
+    // separately so shared edges are counted exactly once.
+    EdgeSide Classify(const Point& m, const Point& d, const std::vector<RingInfo>& other)
+    {
+        bool inside = false;
+        for (const RingInfo& r : other)
+        {
+            RingView pts = r.pts;
+            for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+            {
+                const Point& a = pts[j];
+                const Point& b = pts[i];
+                double ex = b.x - a.x, ey = b.y - a.y;
+                double len2 = ex * ex + ey * ey;
+                double cross = ex * (m.y - a.y) - ey * (m.x - a.x);
+                double dot = ex * (m.x - a.x) + ey * (m.y - a.y);
+
+                if (len2 > 0 && std::fabs(cross) <= 1e-9 * len2 && dot >= 0 && dot <= len2)
+                    return (d.x * ex + d.y * ey) * r.sign > 0 ? EdgeSide::SameEdge : EdgeSide::OppositeEdge;
+
+                if ((a.y > m.y) != (b.y > m.y))
+                {
+                    double x = ex * (m.y - a.y) / ey + a.x;
+                    if (m.x < x)
+                        inside = !inside;
+                }
+            }
+        }
+        return inside ? EdgeSide::Inside : EdgeSide::Outside;
+    }
+
+    // Sum of (x dy - y dx) over the parts of `ring` that bound the
+    // intersection, i.e. the parts inside `other`.
+    double BoundaryInside(const RingInfo& ring, const std::vector<RingInfo>& other,
+        bool keepShared, std::vector<double>& params)
+    {
+        RingView pts = ring.pts;
+        double sum = 0.0;
+
+        for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+        {
+            const Point& p = pts[j];
+            const Point& q = pts[i];
+            double rx = q.x - p.x, ry = q.y - p.y;
+            double rr = rx * rx + ry * ry;
+            if (rr == 0.0)
+                continue;
+
+            // Split points along p→q where the other boundary crosses or touches
+            params.clear();
+            params.push_back(0.0);
+            params.push_back(1.0);
+            for (const RingInfo& o : other)
+            {
+                RingView op = o.pts;
+                for (size_t k = 0, l = op.size() - 1; k < op.size(); l = k++)
+                {
+                    const Point& a = op[l];
+                    const Point& b = op[k];
+                    double sx = b.x - a.x, sy = b.y - a.y;
+                    double det = rx * sy - ry * sx;
+                    double qx = a.x - p.x, qy = a.y - p.y;
+
+                    if (std::fabs(det) < 1e-12 * rr)
+                    {
+                        // Collinear overlap: split at the other edge's endpoints
+                        if (std::fabs(qx * ry - qy * rx) <= 1e-9 * rr)
+                        {
+                            params.push_back((qx * rx + qy * ry) / rr);
+                            params.push_back(((b.x - p.x) * rx + (b.y - p.y) * ry) / rr);
+                        }
+                        continue;
+                    }
+
+                    double t = (qx * sy - qy * sx) / det;
+                    double u = (qx * ry - qy * rx) / det;
+                    if (u >= -1e-9 && u <= 1.0 + 1e-9)
+                        params.push_back(t);
+                }
+            }
+
+            std::sort(params.begin(), params.end());
+
+            Point d{ rx * ring.sign, ry * ring.sign };
+            double prevT = 0.0;
+            for (double t : params)
+            {
+                t = std::min(1.0, t);
+                if (t - prevT <= 1e-12)
+                    continue;
+
+                Point a{ p.x + prevT * rx, p.y + prevT * ry };
+                Point b{ p.x + t * rx, p.y + t * ry };
+                Point m{ (a.x + b.x) * 0.5, (a.y + b.y) * 0.5 };
+
+                EdgeSide side = Classify(m, d, other);
+                if (side == EdgeSide::Inside || (keepShared && side == EdgeSide::SameEdge))
+                    sum += ring.sign * (a.x * b.y - b.x * a.y);
+
+                prevT = t;
+            }
+        }
+        return sum;
+    }
+}
+
+double BooleanOps::IntersectionArea(const PolygonView& A, const PolygonView& B)
+{
+    ScopedLatency latency(MetricOp::IntersectionArea, A.Outer().size() + B.Outer().size());
+    if (A.Outer().size() < 3 || B.Outer().size() < 3)
+        return 0.0;
+
+    double aMinX, aMinY, aMaxX, aMaxY, bMinX, bMinY, bMaxX, bMaxY;
+    Bounds(A.Outer(), aMinX, aMinY, aMaxX, aMaxY);
+    Bounds(B.Outer(), bMinX, bMinY, bMaxX, bMaxY);
+    if (aMaxX <= bMinX || bMaxX <= aMinX || aMaxY <= bMinY || bMaxY <= aMinY)
+        return 0.0;
+
+    std::vector<RingInfo> ringsA, ringsB;
+    CollectRings(A, ringsA);
+    CollectRings(B, ringsB);
+
+    // ∂(A ∩ B) = (∂A inside B) + (∂B inside A); edges shared with the
+    // same orientation are taken from A only.
+    std::vector<double> params;
+    double twiceArea = 0.0;
+    for (const RingInfo& r : ringsA)
+        twiceArea += BoundaryInside(r, ringsB, true, params);
+    for (const RingInfo& r : ringsB)
+        twiceArea += BoundaryInside(r, ringsA, false, params);
+
+    return std::max(0.0, twiceArea * 0.5);
+}
+
+double BooleanOps::IoU(const PolygonView& A, const PolygonView& B)
+{
+    ScopedLatency latency(MetricOp::IoU, A.Outer().size() + B.Outer().size());
+    double inter = IntersectionArea(A, B);
+    if (inter <= 0.0)
+        return 0.0;
+
+    std::vector<RingInfo> rings;
+    CollectRings(A, rings);
+    double areaA = PolygonArea(rings);
+    CollectRings(B, rings);
+    double areaB = PolygonArea(rings);
+
+    double uni = areaA + areaB - inter;
+    return uni > 0.0 ? inter / uni : 0.0;
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
 #include "Polygonutility.h"
+#include "GeometryViews.h"
 #include "PolygonUtilityExtension.h"
+#include "BooleanStats.h"
 
 enum class BoolOp {
     Union,
@@ -10,6 +12,15 @@ enum class BoolOp {
     BminusA
 };
 
+// Optional clean-up applied to result rings
+struct SimplifyOptions
+{
+    bool removeRedundant = true; // duplicate and collinear vertices
+    double tolerance = 0.0;      // > 0 enables Douglas–Peucker
+};
+
+// Every entry point takes an optional BooleanStats*: phase times and
+// counters of the call are added to it, nullptr skips all bookkeeping.
 class BooleanOps
 {
 public:
@@ -17,8 +28,62 @@ public:
     std::vector<Polygon> ComputeBoolean(
         const Polygon& A,
         const Polygon& B,
-        BoolOp operation);
+        BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // Takes ownership: an input that survives unchanged is moved into the result
+    std::vector<Polygon> ComputeBoolean(
+        Polygon&& A,
+        Polygon&& B,
+        BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // Views (FlatPolygonStore, foreign buffers) are read in place; an
+    // input that survives unchanged is copied into the result
+    std::vector<Polygon> ComputeBoolean(
+        const PolygonView& A,
+        const PolygonView& B,
+        BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // Accepts Polygons or views (FlatPolygonStore, foreign buffers); the
+    // outer rings are read in place
+    std::vector<Polygon> ComputeBoolean2(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        BooleanStats* stats = nullptr);
+
+    // Streams each result ring to the sink as it is traced, without
+    // building Polygons; returns the number of rings emitted
+    size_t ComputeBoolean2(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        const RingSink& sink, BooleanStats* stats = nullptr);
+
+    // Same as above, followed by SimplifyResult
+    std::vector<Polygon> ComputeBoolean(const Polygon& A, const Polygon& B, BoolOp operation,
+        const SimplifyOptions& simplify, BooleanStats* stats = nullptr);
+    std::vector<Polygon> ComputeBoolean(Polygon&& A, Polygon&& B, BoolOp operation,
+        const SimplifyOptions& simplify, BooleanStats* stats = nullptr);
+    std::vector<Polygon> ComputeBoolean(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        const SimplifyOptions& simplify, BooleanStats* stats = nullptr);
+    std::vector<Polygon> ComputeBoolean2(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        const SimplifyOptions& simplify, BooleanStats* stats = nullptr);
+
+    void SimplifyResult(std::vector<Polygon>& result, const SimplifyOptions& options,
+        BooleanStats* stats = nullptr);
+
+    // Overlap measures computed straight from the edge arrangement
+    // (Green's theorem), without building or tracing result rings.
+    double IntersectionArea(const PolygonView& A, const PolygonView& B);
+    double IoU(const PolygonView& A, const PolygonView& B);
+
+private:
+    // Which inputs pass through unchanged, plus the clipped ring if any
+    struct ClipOutcome
+    {
+        bool keepA = false;
+        bool keepB = false;
+        std::vector<Point> clipped;
+    };
 
-    std::vector<Polygon> ComputeBoolean2(const Polygon& A, const Polygon& B, BoolOp operation);
+    ClipOutcome ClassifyInputs(const PolygonView& A, const PolygonView& B, BoolOp operation,
+        BooleanStats* stats);
 };
 
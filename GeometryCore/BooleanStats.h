@@ -0,0 +1,102 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Per-call phase timings and counters for the boolean engines.
+// Entry points take an optional BooleanStats*; with nullptr nothing is
+// timed and the only cost is a pointer test per phase. Values accumulate,
+// so one struct can sum a whole batch; Reset() between calls gives
+// per-call numbers. A BooleanStats is not thread-safe: use one per thread.
+struct BooleanStats
+{
+    enum Phase
+    {
+        Normalize,         // orientation of the inputs
+        BuildNodes,        // allocating the GH node lists
+        FindIntersections, // segment tests and intersection node insertion
+        MarkEntryExit,     // entry/exit flags and visited resets
+        Trace,             // walking result loops, including the sink
+        Cleanup,           // freeing the GH node lists
+        Classify,          // containment and overlap tests (Sutherland–Hodgman path)
+        Clip,              // ClipPolygon / ClipPolygonOutside
+        Assemble,          // building result Polygons
+        Simplify,          // SimplifyResult
+        PhaseCount
+    };
+
+    double seconds[PhaseCount] = {}; // exclusive: nested phases are not double counted
+
+    uint64_t calls = 0;
+    uint64_t segmentTests = 0;   // GH only; the SH clipper does not report its tests
+    uint64_t intersections = 0;
+    uint64_t allocations = 0;    // GH nodes plus one per result ring (vector regrowth not counted)
+    uint64_t outputRings = 0;
+    uint64_t outputVertices = 0;
+
+    void Reset() { *this = BooleanStats(); }
+
+    double TotalSeconds() const
+    {
+        double total = 0;
+        for (double s : seconds)
+            total += s;
+        return total;
+    }
+
+    static const char* PhaseName(Phase phase)
+    {
+        static const char* const names[PhaseCount] = {
+            "normalize", "buildNodes", "findIntersections", "markEntryExit", "trace",
+            "cleanup", "classify", "clip", "assemble", "simplify" };
+        return phase < PhaseCount ? names[phase] : "unknown";
+    }
+
+private:
+    friend class PhaseTimer;
+    using Clock = std::chrono::steady_clock;
+
+    int active = -1; // phase being timed, -1 if none
+    Clock::time_point activeSince;
+};
+
+// Charges the time until destruction to one phase of stats (no-op for
+// nullptr). Timers nest: an inner phase pauses the outer one, so every
+// interval is charged to exactly one phase.
+class PhaseTimer
+{
+public:
+    PhaseTimer(BooleanStats* stats, BooleanStats::Phase phase)
+        : stats(stats)
+    {
+        if (!stats)
+            return;
+        BooleanStats::Clock::time_point now = BooleanStats::Clock::now();
+        outer = stats->active;
+        if (outer >= 0)
+            stats->seconds[outer] += Elapsed(stats->activeSince, now);
+        stats->active = phase;
+        stats->activeSince = now;
+    }
+
+    ~PhaseTimer()
+    {
+        if (!stats)
+            return;
+        BooleanStats::Clock::time_point now = BooleanStats::Clock::now();
+        stats->seconds[stats->active] += Elapsed(stats->activeSince, now);
+        stats->active = outer;
+        stats->activeSince = now;
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    static double Elapsed(BooleanStats::Clock::time_point from, BooleanStats::Clock::time_point to)
+    {
+        return std::chrono::duration<double>(to - from).count();
+    }
+
+    BooleanStats* stats;
+    int outer = -1;
+};
@@ -0,0 +1,282 @@
+#include "pch.h"
+#include "CallRecorder.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const char LogMagic[8] = { 'G', 'C', 'C', 'A', 'L', 'L', 'S', 1 };
+    const size_t FixedBytes = 32; // record fields before the polygons
+
+    void PutU16(std::vector<char>& out, uint16_t v)
+    {
+        for (int i = 0; i < 2; i++)
+            out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+
+    void PutU32(std::vector<char>& out, uint32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+
+    void PutU64(std::vector<char>& out, uint64_t v)
+    {
+        for (int i = 0; i < 8; i++)
+            out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+
+    void PatchU32(std::vector<char>& out, size_t at, uint32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            out[at + i] = static_cast<char>(v >> (8 * i));
+    }
+
+    uint64_t GetLE(const char* p, int bytes)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++)
+            v |= uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+        return v;
+    }
+
+    // u32 length, then the polygon as WKB
+    void PutPolygon(std::vector<char>& out, const PolygonView& poly)
+    {
+        size_t at = out.size();
+        PutU32(out, 0);
+        {
+            ByteSink sink = ByteSink::ToMemory(out, 4096);
+            WkbWriter(sink).Write(poly);
+        }
+        PatchU32(out, at, static_cast<uint32_t>(out.size() - at - 4));
+    }
+
+    // An empty polygon is valid WKB that WkbReader skips, hence the clear
+    void GetPolygon(const char*& p, const char* end, Polygon& poly)
+    {
+        if (end - p < 4)
+            throw std::runtime_error("call log: truncated record");
+        size_t n = static_cast<size_t>(GetLE(p, 4));
+        p += 4;
+        if (static_cast<size_t>(end - p) < n)
+            throw std::runtime_error("call log: truncated record");
+
+        ByteSource source = ByteSource::FromMemory(p, n);
+        WkbReader reader(source);
+        if (!reader.Next(poly))
+        {
+            poly.outer.vertices.clear();
+            poly.holes.clear();
+        }
+        p += n;
+    }
+
+    double RingArea(RingView ring)
+    {
+        double area = 0;
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+            area += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+        return std::fabs(area) * 0.5;
+    }
+}
+
+// =====================================================
+// Output summary
+// =====================================================
+void CallOutput::Add(RingView ring, bool hole)
+{
+    if (ring.empty())
+        return;
+    rings++;
+    vertices += ring.size();
+    area += hole ? -RingArea(ring) : RingArea(ring);
+}
+
+void CallOutput::Add(const std::vector<Polygon>& result)
+{
+    for (const Polygon& poly : result)
+    {
+        Add(RingView(poly.outer));
+        for (const Ring& hole : poly.holes)
+            Add(RingView(hole), true);
+    }
+}
+
+// =====================================================
+// Recorder
+// =====================================================
+std::atomic<bool> CallRecorder::recording{ false };
+std::atomic<uint32_t> CallRecorder::sampleRate{ 1 };
+
+CallRecorder& CallRecorder::Instance()
+{
+    static CallRecorder* instance = new CallRecorder();
+    return *instance;
+}
+
+const char* CallRecorder::EngineName(CallEngine engine)
+{
+    switch (engine)
+    {
+    case CallEngine::SutherlandHodgman: return "sutherland-hodgman";
+    case CallEngine::GreinerHormann: return "greiner-hormann";
+    }
+    return "unknown";
+}
+
+void CallRecorder::Open(const std::string& path, uint32_t sampleEvery)
+{
+    Close();
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+        throw std::runtime_error("CallRecorder: cannot create " + path);
+    fwrite(LogMagic, 1, sizeof(LogMagic), file);
+    recorded.store(0, std::memory_order_relaxed);
+    sampleRate.store(sampleEvery ? sampleEvery : 1, std::memory_order_relaxed);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void CallRecorder::Close()
+{
+    recording.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+// Random rather than every Nth call, which would alias with callers that
+// repeat a fixed pattern of calls. xorshift64 per thread, seeded apart by
+// a splitmix64 step over a shared counter.
+bool CallRecorder::Sample()
+{
+    uint32_t rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate <= 1)
+        return true;
+
+    static std::atomic<uint64_t> seeds{ 0 };
+    thread_local uint64_t state = [] {
+        uint64_t z = seeds.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed) + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return z ? z : 1;
+    }();
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state % rate == 0;
+}
+
+// Flushed per record: the calls worth keeping are often the ones running
+// when the process is killed
+void CallRecorder::Append(const std::vector<char>& record)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (!file)
+        return;
+    fwrite(record.data(), 1, record.size(), file);
+    fflush(file);
+    recorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+// =====================================================
+// Capture
+// =====================================================
+void CallCapture::Begin(CallEngine engine, BoolOp op, const PolygonView& a, const PolygonView& b)
+{
+    PutU32(record, 0); // size, patched in Finish
+    record.push_back(static_cast<char>(engine));
+    record.push_back(static_cast<char>(op));
+    PutU16(record, 0);
+    record.resize(4 + FixedBytes); // output fields, filled in Finish
+    PutPolygon(record, a);
+    PutPolygon(record, b);
+    start = std::chrono::steady_clock::now();
+}
+
+void CallCapture::Finish(const std::vector<Polygon>& result)
+{
+    if (!active)
+        return;
+    output.Add(result);
+    Finish();
+}
+
+void CallCapture::Finish()
+{
+    if (!active)
+        return;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    active = false;
+
+    std::vector<char> fields;
+    PutU64(fields, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    PutU32(fields, output.rings);
+    PutU64(fields, output.vertices);
+    PutU64(fields, std::bit_cast<uint64_t>(output.area));
+    std::memcpy(record.data() + 8, fields.data(), fields.size());
+    PatchU32(record, 0, static_cast<uint32_t>(record.size() - 4));
+
+    CallRecorder::Instance().Append(record);
+}
+
+// =====================================================
+// Reader
+// =====================================================
+CallLogReader::CallLogReader(ByteSource& source)
+    : src(source)
+{
+    if (src.Ensure(sizeof(LogMagic)) < sizeof(LogMagic) || std::memcmp(src.Data(), LogMagic, sizeof(LogMagic)) != 0)
+        throw std::runtime_error("call log: bad header");
+    src.Skip(sizeof(LogMagic));
+}
+
+bool CallLogReader::Next(CallRecord& rec)
+{
+    size_t avail = src.Ensure(4);
+    if (avail == 0)
+        return false;
+    if (avail < 4)
+        throw std::runtime_error("call log: truncated record");
+    size_t size = static_cast<size_t>(GetLE(src.Data(), 4));
+    src.Skip(4);
+    if (size < FixedBytes)
+        throw std::runtime_error("call log: bad record size");
+
+    // Records may be larger than the source buffer: copy in pieces
+    buffer.resize(size);
+    for (size_t done = 0; done < size;)
+    {
+        size_t n = std::min(src.Ensure(1), size - done);
+        if (n == 0)
+            throw std::runtime_error("call log: truncated record");
+        std::memcpy(buffer.data() + done, src.Data(), n);
+        src.Skip(n);
+        done += n;
+    }
+
+    const char* p = buffer.data();
+    if (static_cast<unsigned char>(p[0]) > static_cast<unsigned>(CallEngine::GreinerHormann)
+        || static_cast<unsigned char>(p[1]) > static_cast<unsigned>(BoolOp::BminusA))
+        throw std::runtime_error("call log: unknown engine or operation");
+    rec.engine = static_cast<CallEngine>(p[0]);
+    rec.op = static_cast<BoolOp>(p[1]);
+    rec.latencyNs = GetLE(p + 4, 8);
+    rec.output.rings = static_cast<uint32_t>(GetLE(p + 12, 4));
+    rec.output.vertices = GetLE(p + 16, 8);
+    rec.output.area = std::bit_cast<double>(GetLE(p + 24, 8));
+
+    p += FixedBytes;
+    const char* end = buffer.data() + size;
+    GetPolygon(p, end, rec.a);
+    GetPolygon(p, end, rec.b);
+    return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BooleanOps.h"
+#include "GeometryIO.h"
+
+// Capture of production boolean calls for offline replay.
+//
+// While a CallRecorder is open, BooleanOps entry points append a random
+// one in N of their calls (operation, engine, both inputs, latency and a
+// summary of the output) to a binary log. A call that is not sampled costs
+// a thread-local xorshift step; with the recorder closed, one relaxed
+// load. GeometryBench replay re-runs a log and reports latency and output
+// differences per call; GeometryBench --log adds logged calls to the
+// benchmark corpus.
+//
+// Log layout, all little-endian:
+//   file   "GCCALLS" 0x01, then records back to back
+//   record u32 size of the rest of the record
+//          u8 engine, u8 op, u16 reserved
+//          u64 latency ns, u32 output rings, u64 output vertices,
+//          f64 output area
+//          u32 length + WKB polygon A, u32 length + WKB polygon B
+
+enum class CallEngine : uint8_t
+{
+    SutherlandHodgman, // BooleanOps::ComputeBoolean
+    GreinerHormann     // BooleanOps::ComputeBoolean2
+};
+
+// What a call produced, compact enough to log and compare
+struct CallOutput
+{
+    uint32_t rings = 0;
+    uint64_t vertices = 0;
+    double area = 0; // outer rings minus holes
+
+    void Add(RingView ring, bool hole = false);
+    void Add(const std::vector<Polygon>& result);
+};
+
+struct CallRecord
+{
+    CallEngine engine = CallEngine::SutherlandHodgman;
+    BoolOp op = BoolOp::Union;
+    uint64_t latencyNs = 0;
+    CallOutput output;
+    Polygon a;
+    Polygon b;
+};
+
+class CallRecorder
+{
+public:
+    // Never destroyed, so captures during static destruction stay safe
+    static CallRecorder& Instance();
+
+    static bool Enabled() { return recording.load(std::memory_order_relaxed); }
+
+    // Starts a new log at path (replacing any open one); each call is
+    // recorded with probability 1 / sampleEvery. Throws std::runtime_error if
+    // the file cannot be created.
+    void Open(const std::string& path, uint32_t sampleEvery = 1);
+    void Close();
+
+    uint64_t Recorded() const { return recorded.load(std::memory_order_relaxed); }
+
+    static const char* EngineName(CallEngine engine);
+
+private:
+    friend class CallCapture;
+
+    CallRecorder() = default;
+    CallRecorder(const CallRecorder&) = delete;
+    CallRecorder& operator=(const CallRecorder&) = delete;
+
+    static bool Sample();
+    void Append(const std::vector<char>& record);
+
+    static std::atomic<bool> recording;
+    static std::atomic<uint32_t> sampleRate;
+
+    std::mutex fileMutex;
+    FILE* file = nullptr;
+    std::atomic<uint64_t> recorded{ 0 };
+};
+
+// Records one call if the recorder is open and the call is sampled.
+// Inputs are serialized up front (they may be moved from by the call);
+// Finish adds the output and latency and appends the record. A capture
+// destroyed without Finish (the call threw) is dropped.
+class CallCapture
+{
+public:
+    CallCapture(CallEngine engine, BoolOp op, const PolygonView& a, const PolygonView& b)
+        : active(CallRecorder::Enabled() && CallRecorder::Sample())
+    {
+        if (active)
+            Begin(engine, op, a, b);
+    }
+
+    bool Active() const { return active; }
+
+    void AddRing(RingView ring, bool hole = false) { output.Add(ring, hole); }
+    void Finish(const std::vector<Polygon>& result);
+    void Finish();
+
+private:
+    void Begin(CallEngine engine, BoolOp op, const PolygonView& a, const PolygonView& b);
+
+    bool active;
+    std::vector<char> record;
+    CallOutput output;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Reads a call log from any ByteSource; malformed input throws
+// std::runtime_error
+class CallLogReader
+{
+public:
+    explicit CallLogReader(ByteSource& source);
+
+    // Returns false at the end of the log
+    bool Next(CallRecord& record);
+
+private:
+    ByteSource& src;
+    std::vector<char> buffer;
+};
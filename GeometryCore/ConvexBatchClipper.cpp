@@ -0,0 +1,372 @@
+#include "pch.h"
+#include "ConvexBatchClipper.h"
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Keeps GCC from unrolling a lane loop, so the vectorizer sees it whole
+#if defined(__GNUC__)
+#define LANE_LOOP _Pragma("GCC unroll 1")
+#else
+#define LANE_LOOP
+#endif
+
+namespace
+{
+    constexpr int L = ConvexBatchClipper::Lanes;
+    constexpr int MaxIn = SmallConvex::MaxVertices;
+
+    // Relative tolerance for an edge lying on a clip line
+    constexpr double OnLineEps = 1e-12;
+
+    // One polygon per lane, CCW, relative to the lane's origin. Edge i runs
+    // from (x, y)[i] by (dx, dy)[i]. Slots past a lane's count repeat edge
+    // 0: clipping by the same half-plane twice changes nothing, and the
+    // valid mask keeps the repeats out of the boundary sums.
+    struct LaneRings
+    {
+        double x[MaxIn][L];
+        double y[MaxIn][L];
+        double dx[MaxIn][L];
+        double dy[MaxIn][L];
+        double valid[MaxIn][L]; // 1 for a real edge, 0 for a repeat
+        int count[L];
+    };
+
+    double SignedArea(const SmallConvex& c)
+    {
+        double a = 0.0;
+        for (int i = 0, j = c.count - 1; i < c.count; j = i++)
+            a += c.vertices[j].x * c.vertices[i].y - c.vertices[i].x * c.vertices[j].y;
+        return a * 0.5;
+    }
+
+    // Load one polygon into a lane, normalised to CCW and moved by -origin
+    void LoadLane(LaneRings& rings, int lane, const SmallConvex& c, Point origin)
+    {
+        int n = std::min(c.count, MaxIn);
+        bool ccw = SignedArea(c) >= 0;
+        Point pts[MaxIn] = {};
+        for (int i = 0; i < n; i++)
+        {
+            const Point& p = c.vertices[ccw ? i : n - 1 - i];
+            pts[i] = { p.x - origin.x, p.y - origin.y };
+        }
+
+        for (int i = 0; i < MaxIn; i++)
+        {
+            int k = i < n ? i : 0;
+            const Point& a = pts[k];
+            const Point& b = pts[n > 0 && k + 1 < n ? k + 1 : 0];
+            rings.x[i][lane] = a.x;
+            rings.y[i][lane] = a.y;
+            rings.dx[i][lane] = b.x - a.x;
+            rings.dy[i][lane] = b.y - a.y;
+            rings.valid[i][lane] = i < n ? 1.0 : 0.0;
+        }
+        rings.count[lane] = n;
+    }
+
+    void LaneAreas(const LaneRings& rings, double* area)
+    {
+        for (int l = 0; l < L; l++)
+            area[l] = 0.0;
+
+        for (int i = 0; i < MaxIn; i++)
+        {
+            LANE_LOOP
+            for (int l = 0; l < L; l++)
+            {
+                double term = rings.x[i][l] * rings.dy[i][l] - rings.y[i][l] * rings.dx[i][l];
+                area[l] += rings.valid[i][l] * term;
+            }
+        }
+
+        for (int l = 0; l < L; l++)
+            area[l] = std::fabs(area[l]) * 0.5;
+    }
+
+    // Adds twice the signed area swept by the part of every subject edge
+    // that lies inside the clip polygon (Cyrus–Beck against each clip
+    // edge, then Green's theorem). Both passes together give the boundary
+    // of the intersection. An edge lying on a clip edge counts only when
+    // keepShared is set and the two run the same way, so a boundary the
+    // polygons share is counted once and a touching one not at all.
+    void InsideBoundary(const LaneRings& subject, const LaneRings& clip, const double* scale,
+        bool keepShared, double* area2)
+    {
+        // Parameter interval of every subject edge inside the clip polygon
+        double lo[MaxIn][L], hi[MaxIn][L];
+
+        for (int i = 0; i < MaxIn; i++)
+        {
+            for (int l = 0; l < L; l++)
+            {
+                lo[i][l] = 0.0;
+                hi[i][l] = 1.0;
+            }
+
+            for (int e = 0; e < MaxIn; e++)
+            {
+                // Where the interval ends if the edge lies on the clip line. In
+                // its own loop: folded into the one below, GCC moves the dot
+                // product under the on-line test and the loop no longer vectorizes.
+                double lineLeave[L];
+                for (int l = 0; l < L; l++)
+                {
+                    double dot = clip.dx[e][l] * subject.dx[i][l] + clip.dy[e][l] * subject.dy[i][l];
+                    lineLeave[l] = keepShared && dot > 0.0 ? 1.0 : -1.0;
+                }
+
+                for (int l = 0; l < L; l++)
+                {
+                    double px = subject.x[i][l], py = subject.y[i][l];
+                    double sx = subject.dx[i][l], sy = subject.dy[i][l];
+                    double cx = clip.dx[e][l], cy = clip.dy[e][l];
+
+                    // Side of the clip line at the edge start, and its rate along the edge
+                    double d0 = cx * (py - clip.y[e][l]) - cy * (px - clip.x[e][l]);
+                    double rate = cx * sy - cy * sx;
+                    double d1 = d0 + rate;
+                    // inf or NaN when rate == 0; the selects below never use it then.
+                    // Guarding the division would split the loop into branches.
+                    double t = -d0 / rate;
+
+                    // Masks and selects only, no branches: the edge enters the
+                    // half-plane at t when rate > 0 and leaves it when rate < 0
+                    bool parallelOut = (rate == 0.0) & (d0 < 0.0);
+                    double tol = OnLineEps * scale[l] * (std::fabs(cx) + std::fabs(cy));
+                    bool onLine = (std::fabs(d0) <= tol) & (std::fabs(d1) <= tol);
+                    // A zero-length clip edge has no line to clip by
+                    bool noLine = (cx == 0.0) & (cy == 0.0);
+
+                    double enter = rate > 0.0 ? t : 0.0;
+                    double leave = rate < 0.0 ? t : 1.0;
+                    leave = parallelOut ? -1.0 : leave;
+                    enter = onLine ? 0.0 : enter;
+                    leave = onLine ? lineLeave[l] : leave;
+                    leave = noLine ? 1.0 : leave;
+
+                    lo[i][l] = std::max(lo[i][l], enter);
+                    hi[i][l] = std::min(hi[i][l], leave);
+                }
+            }
+        }
+
+        // One pass over all edges: kept per edge, GCC unrolls this loop fully
+        // and leaves it scalar. Clamped so an empty interval (t past the
+        // edge, or -1) still gives a finite term for the weight to zero.
+        // The lane loop is kept whole so that it is the loop that vectorizes,
+        // one lane per element, rather than a reduction across the edges.
+        double sum[L] = {};
+        for (int i = 0; i < MaxIn; i++)
+        {
+            LANE_LOOP
+            for (int l = 0; l < L; l++)
+            {
+                double t0 = std::min(lo[i][l], 1.0);
+                double t1 = std::max(hi[i][l], 0.0);
+                double x0 = subject.x[i][l] + t0 * subject.dx[i][l];
+                double y0 = subject.y[i][l] + t0 * subject.dy[i][l];
+                double x1 = subject.x[i][l] + t1 * subject.dx[i][l];
+                double y1 = subject.y[i][l] + t1 * subject.dy[i][l];
+                double weight = hi[i][l] > lo[i][l] ? subject.valid[i][l] : 0.0;
+                sum[l] += weight * (x0 * y1 - x1 * y0);
+            }
+        }
+        for (int l = 0; l < L; l++)
+            area2[l] += sum[l];
+    }
+
+    bool SamePoint(const Point& a, const Point& b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    // Turns one way only, and one full turn in total
+    bool IsConvex(const std::vector<Point>& pts)
+    {
+        size_t n = pts.size();
+        int sign = 0;
+        double turn = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const Point& a = pts[i];
+            const Point& b = pts[(i + 1) % n];
+            const Point& c = pts[(i + 2) % n];
+            double e1x = b.x - a.x, e1y = b.y - a.y;
+            double e2x = c.x - b.x, e2y = c.y - b.y;
+            double cross = e1x * e2y - e1y * e2x;
+            if (cross != 0.0)
+            {
+                int s = cross > 0 ? 1 : -1;
+                if (sign != 0 && s != sign)
+                    return false;
+                sign = s;
+            }
+            turn += std::atan2(cross, e1x * e2x + e1y * e2y);
+        }
+        return sign != 0 && std::fabs(turn) < 7.0;
+    }
+}
+
+SmallConvex ConvexBatchClipper::RotatedBox(double cx, double cy, double width, double height, double angle)
+{
+    SmallConvex box;
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+    double hx = width * 0.5;
+    double hy = height * 0.5;
+
+    const double corners[4][2] = { { -hx, -hy }, { hx, -hy }, { hx, hy }, { -hx, hy } };
+    for (int i = 0; i < 4; i++)
+    {
+        box.vertices[i].x = cx + corners[i][0] * c - corners[i][1] * s;
+        box.vertices[i].y = cy + corners[i][0] * s + corners[i][1] * c;
+    }
+    box.count = 4;
+    return box;
+}
+
+SmallConvex ConvexBatchClipper::FromPoints(const std::vector<Point>& points)
+{
+    // Repeated vertices, a closing copy of the first included, would be
+    // zero-length edges with no turn for IsConvex to check
+    std::vector<Point> pts;
+    for (const Point& p : points)
+    {
+        if (pts.empty() || !SamePoint(p, pts.back()))
+            pts.push_back(p);
+    }
+    while (pts.size() > 1 && SamePoint(pts.back(), pts.front()))
+        pts.pop_back();
+
+    if (pts.size() < 3 || pts.size() > (size_t)SmallConvex::MaxVertices)
+        throw std::invalid_argument("ConvexBatchClipper: a SmallConvex needs 3 to 8 vertices");
+    if (!IsConvex(pts))
+        throw std::invalid_argument("ConvexBatchClipper: polygon is not convex");
+
+    SmallConvex poly;
+    poly.count = (int)pts.size();
+    for (int i = 0; i < poly.count; i++)
+        poly.vertices[i] = pts[i];
+    return poly;
+}
+
+// =====================================================
+// Lane kernel: boundary of A inside B plus boundary of B inside A
+// =====================================================
+void ConvexBatchClipper::ProcessBlock(
+    const SmallConvex* const* A,
+    const SmallConvex* const* B,
+    int lanes,
+    double* interOut,
+    double* iouOut)
+{
+    static const SmallConvex empty{};
+
+    LaneRings ringsA, ringsB;
+    double scale[L];
+    for (int l = 0; l < L; l++)
+    {
+        const SmallConvex& a = l < lanes ? *A[l] : empty;
+        const SmallConvex& b = l < lanes ? *B[l] : empty;
+
+        // Both polygons relative to A's first vertex, which keeps the
+        // boundary products small
+        Point origin = a.count > 0 ? a.vertices[0] : Point{ 0, 0 };
+        LoadLane(ringsA, l, a, origin);
+        LoadLane(ringsB, l, b, origin);
+
+        scale[l] = 0.0;
+        for (int i = 0; i < MaxIn; i++)
+        {
+            scale[l] = std::max({ scale[l], std::fabs(ringsA.x[i][l]), std::fabs(ringsA.y[i][l]),
+                std::fabs(ringsB.x[i][l]), std::fabs(ringsB.y[i][l]) });
+        }
+    }
+
+    double areaA[L], areaB[L];
+    LaneAreas(ringsA, areaA);
+    LaneAreas(ringsB, areaB);
+
+    double area2[L] = {};
+    InsideBoundary(ringsA, ringsB, scale, true, area2);
+    InsideBoundary(ringsB, ringsA, scale, false, area2);
+
+    for (int l = 0; l < lanes; l++)
+    {
+        double inter = ringsA.count[l] < 3 || ringsB.count[l] < 3 ? 0.0 : std::max(area2[l] * 0.5, 0.0);
+        if (interOut)
+            interOut[l] = inter;
+        if (iouOut)
+        {
+            double uni = areaA[l] + areaB[l] - inter;
+            iouOut[l] = uni > 0.0 ? inter / uni : 0.0;
+        }
+    }
+}
+
+void ConvexBatchClipper::IntersectionAreas(
+    const SmallConvex* A,
+    const SmallConvex* B,
+    size_t count,
+    double* out)
+{
+    ScopedLatency latency(MetricOp::ConvexBatch, count);
+    const SmallConvex* a[L];
+    const SmallConvex* b[L];
+    for (size_t base = 0; base < count; base += L)
+    {
+        int lanes = (int)std::min((size_t)L, count - base);
+        for (int l = 0; l < lanes; l++)
+        {
+            a[l] = &A[base + l];
+            b[l] = &B[base + l];
+        }
+        ProcessBlock(a, b, lanes, out + base, nullptr);
+    }
+}
+
+void ConvexBatchClipper::IoU(
+    const SmallConvex* A,
+    const SmallConvex* B,
+    size_t count,
+    double* out)
+{
+    ScopedLatency latency(MetricOp::ConvexBatch, count);
+    const SmallConvex* a[L];
+    const SmallConvex* b[L];
+    for (size_t base = 0; base < count; base += L)
+    {
+        int lanes = (int)std::min((size_t)L, count - base);
+        for (int l = 0; l < lanes; l++)
+        {
+            a[l] = &A[base + l];
+            b[l] = &B[base + l];
+        }
+        ProcessBlock(a, b, lanes, nullptr, out + base);
+    }
+}
+
+void ConvexBatchClipper::IoUOneToMany(
+    const SmallConvex& first,
+    const SmallConvex* B,
+    size_t count,
+    double* out)
+{
+    ScopedLatency latency(MetricOp::ConvexBatch, count);
+    const SmallConvex* a[L];
+    const SmallConvex* b[L];
+    for (int l = 0; l < L; l++)
+        a[l] = &first;
+
+    for (size_t base = 0; base < count; base += L)
+    {
+        int lanes = (int)std::min((size_t)L, count - base);
+        for (int l = 0; l < lanes; l++)
+            b[l] = &B[base + l];
+        ProcessBlock(a, b, lanes, nullptr, out + base);
+    }
+}
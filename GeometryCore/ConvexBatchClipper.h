@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Polygonutility.h"
+
+// Fixed-capacity convex polygon (rotated boxes, quads, small hulls).
+// Lives entirely on the stack so batches never touch the heap.
+struct SmallConvex
+{
+    static constexpr int MaxVertices = 8;
+
+    Point vertices[MaxVertices];
+    int count = 0;
+};
+
+// Batched intersection areas for small convex pairs.
+// Pairs are processed Lanes at a time in structure-of-arrays blocks,
+// one pair per lane. Instead of clipping (whose output compaction is a
+// per-lane scatter), each edge is cut to its interval inside the other
+// polygon and the intervals are summed by Green's theorem: fixed trip
+// counts, stride-1 loads and blends only, so the lane loops vectorize.
+class ConvexBatchClipper
+{
+public:
+    static constexpr int Lanes = 8;
+
+    static SmallConvex RotatedBox(double cx, double cy, double width, double height, double angle);
+    // Throws std::invalid_argument unless pts is a convex ring of 3 to
+    // MaxVertices points, once repeated vertices are dropped; larger or
+    // concave rings belong on the general path (BooleanOps::IntersectionArea)
+    static SmallConvex FromPoints(const std::vector<Point>& pts);
+
+    // out[i] = area(A[i] ∩ B[i])
+    void IntersectionAreas(
+        const SmallConvex* A,
+        const SmallConvex* B,
+        size_t count,
+        double* out);
+
+    // out[i] = IoU(A[i], B[i])
+    void IoU(
+        const SmallConvex* A,
+        const SmallConvex* B,
+        size_t count,
+        double* out);
+
+    // out[i] = IoU(a, B[i]); the usual shape of a suppression pass
+    void IoUOneToMany(
+        const SmallConvex& a,
+        const SmallConvex* B,
+        size_t count,
+        double* out);
+
+private:
+    void ProcessBlock(
+        const SmallConvex* const* A,
+        const SmallConvex* const* B,
+        int lanes,
+        double* interOut,
+        double* iouOut);
+};
@@ -0,0 +1,313 @@
+#include "pch.h"
+#include "FlatPolygonStore.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char Magic[8] = { 'G', 'C', 'F', 'L', 'A', 'T', '1', '\0' };
+    const uint32_t Version = 1;
+    const size_t WriteBuffer = size_t(1) << 20;
+
+    int OpenForWrite(const char* path)
+    {
+#ifdef _WIN32
+        int fd = _open(path, _O_CREAT | _O_TRUNC | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+#endif
+        if (fd < 0)
+            throw std::runtime_error(std::string("FlatPolygonWriter: cannot create ") + path);
+        return fd;
+    }
+
+    void CloseFd(int fd)
+    {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    // Rewrite the header in place once the tables are known
+    bool WriteAt0(int fd, const FlatHeader& h)
+    {
+#ifdef _WIN32
+        if (_lseeki64(fd, 0, SEEK_SET) != 0)
+            return false;
+        return _write(fd, &h, sizeof(h)) == static_cast<int>(sizeof(h));
+#else
+        return ::pwrite(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h));
+#endif
+    }
+
+    // a + b * c without wrapping, for offsets read from an untrusted file
+    bool FitsIn(uint64_t offset, uint64_t count, uint64_t width, uint64_t size)
+    {
+        if (offset > size || offset % 8 != 0)
+            return false;
+        return count <= (size - offset) / width;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FlatPolygonStore
+// ---------------------------------------------------------------------------
+
+FlatPolygonStore::~FlatPolygonStore()
+{
+    Close();
+}
+
+FlatPolygonStore::FlatPolygonStore(FlatPolygonStore&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+FlatPolygonStore& FlatPolygonStore::operator=(FlatPolygonStore&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        base = other.base;
+        length = other.length;
+        header = other.header;
+        coords = other.coords;
+        ringTable = other.ringTable;
+        polygonTable = other.polygonTable;
+#ifdef _WIN32
+        file = other.file;
+        mapping = other.mapping;
+        other.file = nullptr;
+        other.mapping = nullptr;
+#endif
+        other.base = nullptr;
+        other.length = 0;
+        other.header = nullptr;
+    }
+    return *this;
+}
+
+void FlatPolygonStore::Close()
+{
+    if (base)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(const_cast<char*>(base), length);
+#endif
+    }
+#ifdef _WIN32
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#endif
+    base = nullptr;
+    length = 0;
+    header = nullptr;
+    coords = nullptr;
+    ringTable = nullptr;
+    polygonTable = nullptr;
+}
+
+FlatPolygonStore FlatPolygonStore::Open(const char* path)
+{
+    if (std::endian::native != std::endian::little)
+        throw std::runtime_error("FlatPolygonStore: big-endian hosts are not supported");
+
+    FlatPolygonStore store;
+    std::string what = std::string("FlatPolygonStore: cannot map ") + path;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(what);
+    store.file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+        throw std::runtime_error(what);
+    store.length = static_cast<size_t>(size.QuadPart);
+    if (store.length < sizeof(FlatHeader))
+        throw std::runtime_error("FlatPolygonStore: file too small");
+
+    store.mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!store.mapping)
+        throw std::runtime_error(what);
+    store.base = static_cast<const char*>(MapViewOfFile(store.mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!store.base)
+        throw std::runtime_error(what);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(what);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error(what);
+    }
+    store.length = static_cast<size_t>(st.st_size);
+    if (store.length < sizeof(FlatHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("FlatPolygonStore: file too small");
+    }
+
+    // The mapping keeps the file alive; the descriptor is not needed after this
+    void* p = mmap(nullptr, store.length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error(what);
+    store.base = static_cast<const char*>(p);
+#endif
+
+    store.Validate(store.length);
+    return store;
+}
+
+// Header and table placement only; touching every table entry here would
+// page in the whole file, so per-polygon entries are checked in Get()
+void FlatPolygonStore::Validate(size_t size)
+{
+    const FlatHeader* h = reinterpret_cast<const FlatHeader*>(base);
+    if (std::memcmp(h->magic, Magic, sizeof(Magic)) != 0)
+        throw std::runtime_error("FlatPolygonStore: not a flat polygon file");
+    if (h->version != Version)
+        throw std::runtime_error("FlatPolygonStore: unsupported version");
+
+    if (!FitsIn(h->coordOffset, h->pointCount, sizeof(Point), size)
+        || h->ringCount == UINT64_MAX || h->polygonCount == UINT64_MAX
+        || !FitsIn(h->ringTableOffset, h->ringCount + 1, 8, size)
+        || !FitsIn(h->polygonTableOffset, h->polygonCount + 1, 8, size))
+        throw std::runtime_error("FlatPolygonStore: corrupt header");
+
+    header = h;
+    coords = reinterpret_cast<const Point*>(base + h->coordOffset);
+    ringTable = reinterpret_cast<const uint64_t*>(base + h->ringTableOffset);
+    polygonTable = reinterpret_cast<const uint64_t*>(base + h->polygonTableOffset);
+}
+
+PolygonView FlatPolygonStore::Get(size_t id) const
+{
+    if (id >= PolygonCount())
+        throw std::out_of_range("FlatPolygonStore: polygon id out of range");
+
+    uint64_t first = polygonTable[id];
+    uint64_t last = polygonTable[id + 1];
+    if (first > last || last > header->ringCount)
+        throw std::out_of_range("FlatPolygonStore: corrupt polygon table");
+
+    for (uint64_t r = first; r < last; r++)
+    {
+        if (ringTable[r] > ringTable[r + 1] || ringTable[r + 1] > header->pointCount)
+            throw std::out_of_range("FlatPolygonStore: corrupt ring table");
+    }
+
+    return PolygonView(coords, ringTable + first, static_cast<size_t>(last - first));
+}
+
+// ---------------------------------------------------------------------------
+// FlatPolygonWriter
+// ---------------------------------------------------------------------------
+
+FlatPolygonWriter::FlatPolygonWriter(const char* path)
+    : fd(OpenForWrite(path)), sink(ByteSink::ToFd(fd, WriteBuffer))
+{
+    // Placeholder header; coordinates follow directly at offset 64
+    FlatHeader h = {};
+    sink.Write(&h, sizeof(h));
+    ringTable.push_back(0);
+    polygonTable.push_back(0);
+}
+
+FlatPolygonWriter::~FlatPolygonWriter()
+{
+    try
+    {
+        Finish();
+    }
+    catch (const std::exception&)
+    {
+    }
+    if (fd >= 0)
+        CloseFd(fd);
+}
+
+size_t FlatPolygonWriter::Add(const PolygonView& poly)
+{
+    if (finished)
+        throw std::logic_error("FlatPolygonWriter: Add after Finish");
+
+    for (size_t i = 0; i < poly.RingCount(); i++)
+    {
+        RingView ring = poly.RingAt(i);
+        if (!ring.IsReversed())
+        {
+            sink.Write(ring.Data(), ring.size() * sizeof(Point));
+        }
+        else
+        {
+            for (const Point& p : ring)
+                sink.Write(&p, sizeof(Point));
+        }
+        points += ring.size();
+        ringTable.push_back(points);
+    }
+    polygonTable.push_back(ringTable.size() - 1);
+    return polygonTable.size() - 2;
+}
+
+size_t FlatPolygonWriter::Add(const std::vector<Polygon>& polys)
+{
+    size_t first = PolygonCount();
+    for (const Polygon& poly : polys)
+        Add(PolygonView(poly));
+    return first;
+}
+
+void FlatPolygonWriter::Finish()
+{
+    if (finished)
+        return;
+    finished = true;
+
+    FlatHeader h = {};
+    std::memcpy(h.magic, Magic, sizeof(Magic));
+    h.version = Version;
+    h.polygonCount = polygonTable.size() - 1;
+    h.ringCount = ringTable.size() - 1;
+    h.pointCount = points;
+    h.coordOffset = sizeof(FlatHeader);
+    h.ringTableOffset = h.coordOffset + points * sizeof(Point);
+    h.polygonTableOffset = h.ringTableOffset + ringTable.size() * sizeof(uint64_t);
+
+    sink.Write(ringTable.data(), ringTable.size() * sizeof(uint64_t));
+    sink.Write(polygonTable.data(), polygonTable.size() * sizeof(uint64_t));
+    sink.Flush();
+
+    if (!WriteAt0(fd, h))
+        throw std::runtime_error("FlatPolygonWriter: cannot write header");
+    CloseFd(fd);
+    fd = -1;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GeometryIO.h"
+#include "GeometryViews.h"
+
+// Flat binary polygon file, little-endian, every section 8-byte aligned:
+//
+//   FlatHeader          64 bytes
+//   coordinates         pointCount x { double x, double y }
+//   ring table          ringCount + 1 uint64: first point of each ring
+//   polygon table       polygonCount + 1 uint64: first ring of each polygon
+//
+// The first ring of a polygon is its outer ring, the rest are holes.
+// Rings are stored without the repeated closing vertex, as in Ring.
+// Each table ends with a sentinel holding the total count, so
+// polygon i owns rings [polygons[i], polygons[i + 1]).
+
+struct FlatHeader
+{
+    char magic[8];           // "GCFLAT1\0"
+    uint32_t version;        // 1
+    uint32_t flags;          // reserved, 0
+    uint64_t polygonCount;
+    uint64_t ringCount;
+    uint64_t pointCount;
+    uint64_t coordOffset;    // byte offsets from the start of the file
+    uint64_t ringTableOffset;
+    uint64_t polygonTableOffset;
+};
+
+static_assert(sizeof(FlatHeader) == 64, "FlatHeader layout");
+static_assert(sizeof(Point) == 16, "Point must be two packed doubles");
+
+// Read-only memory mapping of a flat polygon file. Polygons are handed out
+// as views into the mapping: opening is O(1) regardless of file size, and
+// processes reading the same file share the page cache.
+class FlatPolygonStore
+{
+public:
+    FlatPolygonStore() = default;
+    ~FlatPolygonStore();
+
+    FlatPolygonStore(FlatPolygonStore&& other) noexcept;
+    FlatPolygonStore& operator=(FlatPolygonStore&& other) noexcept;
+    FlatPolygonStore(const FlatPolygonStore&) = delete;
+    FlatPolygonStore& operator=(const FlatPolygonStore&) = delete;
+
+    // Maps the file and checks the header; throws std::runtime_error
+    static FlatPolygonStore Open(const char* path);
+
+    void Close();
+
+    size_t PolygonCount() const { return header ? static_cast<size_t>(header->polygonCount) : 0; }
+    size_t RingCount() const { return header ? static_cast<size_t>(header->ringCount) : 0; }
+    size_t PointCount() const { return header ? static_cast<size_t>(header->pointCount) : 0; }
+
+    // Polygon by id; its table entries are bounds-checked (throws std::out_of_range)
+    PolygonView Get(size_t id) const;
+
+    PolygonView operator[](size_t id) const { return Get(id); }
+
+private:
+    void Validate(size_t size);
+
+    const char* base = nullptr;
+    size_t length = 0;
+    const FlatHeader* header = nullptr;
+    const Point* coords = nullptr;
+    const uint64_t* ringTable = nullptr;
+    const uint64_t* polygonTable = nullptr;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+// Streams polygons into a flat file. Coordinates go straight to disk; only
+// the ring and polygon tables (8 bytes per ring and per polygon) are held
+// until Finish() appends them and writes the header.
+class FlatPolygonWriter
+{
+public:
+    // Creates or truncates path; throws std::runtime_error
+    explicit FlatPolygonWriter(const char* path);
+
+    // Finishes the file if Finish() was not called (errors are swallowed)
+    ~FlatPolygonWriter();
+
+    FlatPolygonWriter(const FlatPolygonWriter&) = delete;
+    FlatPolygonWriter& operator=(const FlatPolygonWriter&) = delete;
+
+    // Returns the id of the added polygon
+    size_t Add(const PolygonView& poly);
+
+    // Boolean results; returns the id of the first polygon
+    size_t Add(const std::vector<Polygon>& polys);
+
+    size_t PolygonCount() const { return polygonTable.size() - 1; }
+
+    void Finish();
+
+private:
+    int fd = -1;
+    ByteSink sink;
+    bool finished = false;
+    uint64_t points = 0;
+    std::vector<uint64_t> ringTable;
+    std::vector<uint64_t> polygonTable;
+};
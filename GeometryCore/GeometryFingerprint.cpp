@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "GeometryFingerprint.h"
+#include <cstring>
+
+namespace
+{
+    const uint64_t Prime1 = 11400714785074694791ULL;
+    const uint64_t Prime2 = 14029467366897019727ULL;
+    const uint64_t Prime3 = 1609587929392839161ULL;
+    const uint64_t Prime4 = 9650029242287828579ULL;
+    const uint64_t Prime5 = 2870177450012600261ULL;
+
+    uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    uint64_t Read64(const unsigned char* p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof v);
+        return v;
+    }
+
+    uint32_t Read32(const unsigned char* p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof v);
+        return v;
+    }
+
+    uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * Prime2;
+        acc = Rotl(acc, 31);
+        return acc * Prime1;
+    }
+
+    uint64_t MergeRound(uint64_t acc, uint64_t val)
+    {
+        acc ^= Round(0, val);
+        return acc * Prime1 + Prime4;
+    }
+}
+
+XxHash64::XxHash64(uint64_t seed)
+    : seed(seed)
+{
+    v[0] = seed + Prime1 + Prime2;
+    v[1] = seed + Prime2;
+    v[2] = seed;
+    v[3] = seed - Prime1;
+}
+
+void XxHash64::Update(const void* data, size_t bytes)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + bytes;
+    total += bytes;
+
+    if (buffered + bytes < sizeof buffer)
+    {
+        if (bytes)
+            std::memcpy(buffer + buffered, p, bytes);
+        buffered += bytes;
+        return;
+    }
+
+    if (buffered)
+    {
+        size_t fill = sizeof buffer - buffered;
+        std::memcpy(buffer + buffered, p, fill);
+        for (int i = 0; i < 4; i++)
+            v[i] = Round(v[i], Read64(buffer + 8 * i));
+        p += fill;
+        buffered = 0;
+    }
+
+    // Whole stripes straight from the input
+    for (; end - p >= 32; p += 32)
+    {
+        for (int i = 0; i < 4; i++)
+            v[i] = Round(v[i], Read64(p + 8 * i));
+    }
+
+    buffered = static_cast<size_t>(end - p);
+    if (buffered)
+        std::memcpy(buffer, p, buffered);
+}
+
+uint64_t XxHash64::Digest() const
+{
+    uint64_t h;
+    if (total >= 32)
+    {
+        h = Rotl(v[0], 1) + Rotl(v[1], 7) + Rotl(v[2], 12) + Rotl(v[3], 18);
+        for (int i = 0; i < 4; i++)
+            h = MergeRound(h, v[i]);
+    }
+    else
+    {
+        h = seed + Prime5;
+    }
+    h += total;
+
+    const unsigned char* p = buffer;
+    const unsigned char* end = buffer + buffered;
+    for (; end - p >= 8; p += 8)
+        h = Rotl(h ^ Round(0, Read64(p)), 27) * Prime1 + Prime4;
+    if (end - p >= 4)
+    {
+        h = Rotl(h ^ (Read32(p) * Prime1), 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    for (; p < end; p++)
+        h = Rotl(h ^ (*p * Prime5), 11) * Prime1;
+
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t GeometryFingerprint(const PolygonView& polygon, uint64_t seed)
+{
+    XxHash64 hash(seed);
+    hash.Update(static_cast<uint64_t>(polygon.RingCount()));
+    for (size_t r = 0; r < polygon.RingCount(); r++)
+    {
+        RingView ring = polygon.RingAt(r);
+        hash.Update(static_cast<uint64_t>(ring.size()));
+        if (!ring.IsReversed())
+        {
+            hash.Update(ring.Data(), ring.size() * sizeof(Point));
+            continue;
+        }
+        for (const Point& p : ring)
+            hash.Update(&p, sizeof p);
+    }
+    return hash.Digest();
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "GeometryViews.h"
+
+// Streaming XXH64 (Yann Collet's xxHash, 64-bit variant). Bytes can arrive
+// in any split; the digest equals one-shot XXH64 of their concatenation.
+class XxHash64
+{
+public:
+    explicit XxHash64(uint64_t seed = 0);
+
+    void Update(const void* data, size_t bytes);
+    void Update(uint64_t value) { Update(&value, sizeof value); }
+    uint64_t Digest() const;
+
+private:
+    uint64_t v[4];
+    uint64_t seed;
+    uint64_t total = 0;
+    unsigned char buffer[32];
+    size_t buffered = 0;
+};
+
+// Content hash of a polygon: ring count, then each ring's vertex count
+// and raw coordinates in iteration order. Equal coordinates give equal
+// fingerprints whether they live in a Polygon, a FlatPolygonStore or a
+// foreign buffer. Doubles are hashed bit for bit, so -0.0 and 0.0 differ,
+// and the value depends on the host's byte order: fingerprints are for
+// in-process lookups, not for storing.
+uint64_t GeometryFingerprint(const PolygonView& polygon, uint64_t seed = 0);
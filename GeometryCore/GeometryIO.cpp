@@ -0,0 +1,733 @@
+#include "pch.h"
+#include "GeometryIO.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Longest number token the text reader accepts; also the smallest buffer
+    const size_t MaxToken = 128;
+
+    // Reserving more than this up front needs the count to be trustworthy;
+    // larger rings still grow normally
+    const size_t MaxReserve = size_t(1) << 20;
+
+    const uint32_t WkbPolygon = 3;
+    const uint32_t WkbMultiPolygon = 6;
+
+    const bool HostLittle = std::endian::native == std::endian::little;
+
+    long ReadFd(int fd, char* data, size_t n)
+    {
+#ifdef _WIN32
+        return _read(fd, data, static_cast<unsigned>(std::min<size_t>(n, 1u << 30)));
+#else
+        return static_cast<long>(::read(fd, data, n));
+#endif
+    }
+
+    long WriteFd(int fd, const char* data, size_t n)
+    {
+#ifdef _WIN32
+        return _write(fd, data, static_cast<unsigned>(std::min<size_t>(n, 1u << 30)));
+#else
+        return static_cast<long>(::write(fd, data, n));
+#endif
+    }
+
+    uint32_t Swap32(uint32_t v)
+    {
+        return (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24);
+    }
+
+    uint64_t Swap64(uint64_t v)
+    {
+        return (uint64_t(Swap32(uint32_t(v))) << 32) | Swap32(uint32_t(v >> 32));
+    }
+
+    uint32_t LoadU32(const char* p, bool swap)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return swap ? Swap32(v) : v;
+    }
+
+    double LoadF64(const char* p, bool swap)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        if (swap)
+            v = Swap64(v);
+        return std::bit_cast<double>(v);
+    }
+
+    bool IsSpace(int c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool IsAlpha(int c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    bool SameWord(const char* word, size_t len, const char* keyword)
+    {
+        return len == std::strlen(keyword) && std::memcmp(word, keyword, len) == 0;
+    }
+
+    // Drop the repeated closing vertex; GeometryCore rings are implicitly closed
+    void Open(Ring& ring)
+    {
+        auto& v = ring.vertices;
+        if (v.size() > 1 && v.front().x == v.back().x && v.front().y == v.back().y)
+            v.pop_back();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ByteSource / ByteSink
+// ---------------------------------------------------------------------------
+
+ByteSource ByteSource::FromMemory(const void* data, size_t size)
+{
+    ByteSource s;
+    s.cur = static_cast<const char*>(data);
+    s.end = s.cur + size;
+    return s;
+}
+
+ByteSource ByteSource::FromFd(int fd, size_t bufferSize)
+{
+    ByteSource s;
+    s.fd = fd;
+    s.eof = false;
+    s.buffer.resize(std::max(bufferSize, MaxToken));
+    s.cur = s.end = s.buffer.data();
+    return s;
+}
+
+size_t ByteSource::Refill(size_t n)
+{
+    if (eof)
+        return Available();
+
+    // Keep the unread tail, then top the buffer up
+    size_t avail = Available();
+    std::memmove(buffer.data(), cur, avail);
+    cur = buffer.data();
+    end = cur + avail;
+    n = std::min(n, buffer.size());
+
+    while (avail < n)
+    {
+        long got = ReadFd(fd, buffer.data() + avail, buffer.size() - avail);
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("ByteSource: read failed");
+        }
+        if (got == 0)
+        {
+            eof = true;
+            break;
+        }
+        avail += static_cast<size_t>(got);
+        end = cur + avail;
+    }
+    return avail;
+}
+
+ByteSink ByteSink::ToMemory(std::vector<char>& out, size_t bufferSize)
+{
+    ByteSink s;
+    s.memory = &out;
+    s.buffer.resize(std::max(bufferSize, MaxToken));
+    return s;
+}
+
+ByteSink ByteSink::ToFd(int fd, size_t bufferSize)
+{
+    ByteSink s;
+    s.fd = fd;
+    s.buffer.resize(std::max(bufferSize, MaxToken));
+    return s;
+}
+
+ByteSink::ByteSink(ByteSink&& other) noexcept
+    : fd(other.fd), memory(other.memory), buffer(std::move(other.buffer)), used(other.used)
+{
+    other.fd = -1;
+    other.memory = nullptr;
+    other.used = 0;
+}
+
+ByteSink::~ByteSink()
+{
+    try
+    {
+        Flush();
+    }
+    catch (const std::exception&)
+    {
+    }
+}
+
+void ByteSink::Write(const void* data, size_t n)
+{
+    const char* p = static_cast<const char*>(data);
+    while (n > 0)
+    {
+        if (used == buffer.size())
+            Flush();
+        size_t k = std::min(n, buffer.size() - used);
+        std::memcpy(buffer.data() + used, p, k);
+        used += k;
+        p += k;
+        n -= k;
+    }
+}
+
+void ByteSink::Flush()
+{
+    if (used == 0)
+        return;
+
+    if (memory)
+    {
+        memory->insert(memory->end(), buffer.data(), buffer.data() + used);
+    }
+    else if (fd >= 0)
+    {
+        size_t done = 0;
+        while (done < used)
+        {
+            long put = WriteFd(fd, buffer.data() + done, used - done);
+            if (put < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("ByteSink: write failed");
+            }
+            done += static_cast<size_t>(put);
+        }
+    }
+    used = 0;
+}
+
+// ---------------------------------------------------------------------------
+// WKT
+// ---------------------------------------------------------------------------
+
+WktReader::WktReader(ByteSource& source)
+    : src(source)
+{
+}
+
+void WktReader::Fail(const char* what) const
+{
+    throw std::runtime_error("WKT geometry " + std::to_string(geometry) + ": " + what);
+}
+
+void WktReader::SkipSpace()
+{
+    while (src.Ensure(1) > 0 && IsSpace(*src.Data()))
+        src.Skip(1);
+}
+
+int WktReader::Peek()
+{
+    SkipSpace();
+    return src.Ensure(1) > 0 ? static_cast<unsigned char>(*src.Data()) : -1;
+}
+
+void WktReader::Expect(char c)
+{
+    if (Peek() != static_cast<unsigned char>(c))
+    {
+        char msg[] = "expected ' '";
+        msg[10] = c;
+        Fail(msg);
+    }
+    src.Skip(1);
+}
+
+// Upper-cased keyword into a caller buffer; no allocation
+size_t WktReader::ReadWord(char* word, size_t capacity)
+{
+    SkipSpace();
+    size_t len = 0;
+    while (src.Ensure(1) > 0 && IsAlpha(*src.Data()))
+    {
+        if (len == capacity)
+            Fail("keyword too long");
+        char c = *src.Data();
+        word[len++] = (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c;
+        src.Skip(1);
+    }
+    return len;
+}
+
+double WktReader::ReadNumber()
+{
+    SkipSpace();
+    size_t avail = src.Ensure(MaxToken);
+    const char* first = src.Data();
+    const char* last = first + avail;
+    if (first != last && *first == '+')
+        first++;
+
+    double value;
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || ptr == first)
+        Fail("expected a number");
+    if (ptr == last && !src.Drained())
+        Fail("number too long");
+
+    src.Skip(static_cast<size_t>(ptr - src.Data()));
+    return value;
+}
+
+// EMPTY or '('; true when the list is open
+bool WktReader::ReadEmptyOrOpen()
+{
+    if (Peek() == '(')
+    {
+        src.Skip(1);
+        return true;
+    }
+
+    char word[8];
+    size_t len = ReadWord(word, sizeof(word));
+    if (!SameWord(word, len, "EMPTY"))
+        Fail("expected '(' or EMPTY");
+    return false;
+}
+
+void WktReader::ReadRing(Ring& ring)
+{
+    ring.vertices.clear();
+    if (!ReadEmptyOrOpen())
+        return;
+
+    for (;;)
+    {
+        double x = ReadNumber();
+        double y = ReadNumber();
+        ring.vertices.push_back({ x, y });
+
+        // Z / M ordinates
+        int c = Peek();
+        while (c != ',' && c != ')')
+        {
+            if (c < 0)
+                Fail("unterminated ring");
+            ReadNumber();
+            c = Peek();
+        }
+        src.Skip(1);
+        if (c == ')')
+            break;
+    }
+    Open(ring);
+}
+
+// Ring list of one polygon after its '('; reuses the rings already in poly
+void WktReader::ReadRings(Polygon& poly)
+{
+    size_t count = 0;
+    for (;;)
+    {
+        if (count == 0)
+        {
+            ReadRing(poly.outer);
+        }
+        else
+        {
+            if (poly.holes.size() < count)
+                poly.holes.emplace_back();
+            ReadRing(poly.holes[count - 1]);
+        }
+        count++;
+
+        int c = Peek();
+        if (c == ')')
+            break;
+        if (c != ',')
+            Fail("expected ',' or ')' after ring");
+        src.Skip(1);
+    }
+    src.Skip(1);
+    poly.holes.resize(count - 1);
+}
+
+bool WktReader::Next(Polygon& poly)
+{
+    for (;;)
+    {
+        if (inMulti)
+        {
+            if (needSeparator)
+            {
+                int c = Peek();
+                if (c == ')')
+                {
+                    src.Skip(1);
+                    inMulti = false;
+                    continue;
+                }
+                if (c != ',')
+                    Fail("expected ',' or ')' after polygon");
+                src.Skip(1);
+            }
+            needSeparator = true;
+
+            if (Peek() == '(')
+            {
+                src.Skip(1);
+                ReadRings(poly);
+                return true;
+            }
+            char word[8];
+            size_t len = ReadWord(word, sizeof(word));
+            if (!SameWord(word, len, "EMPTY"))
+                Fail("expected '(' or EMPTY");
+            continue;
+        }
+
+        if (Peek() < 0)
+            return false;
+        geometry++;
+
+        char word[16];
+        size_t len = ReadWord(word, sizeof(word));
+
+        // EWKT prefix: SRID=n;
+        if (SameWord(word, len, "SRID"))
+        {
+            Expect('=');
+            while (src.Ensure(1) > 0 && *src.Data() != ';')
+                src.Skip(1);
+            Expect(';');
+            len = ReadWord(word, sizeof(word));
+        }
+
+        bool multi;
+        if (SameWord(word, len, "POLYGON"))
+            multi = false;
+        else if (SameWord(word, len, "MULTIPOLYGON"))
+            multi = true;
+        else
+            Fail("expected POLYGON or MULTIPOLYGON");
+
+        // Optional Z / M / ZM tag, then EMPTY or the body
+        if (Peek() != '(')
+        {
+            char tag[8];
+            size_t tagLen = ReadWord(tag, sizeof(tag));
+            if (SameWord(tag, tagLen, "EMPTY"))
+                continue;
+            if (!SameWord(tag, tagLen, "Z") && !SameWord(tag, tagLen, "M") && !SameWord(tag, tagLen, "ZM"))
+                Fail("expected Z, M, ZM, EMPTY or '('");
+            if (!ReadEmptyOrOpen())
+                continue;
+        }
+        else
+        {
+            src.Skip(1);
+        }
+
+        if (multi)
+        {
+            inMulti = true;
+            needSeparator = false;
+            continue;
+        }
+
+        ReadRings(poly);
+        return true;
+    }
+}
+
+WktWriter::WktWriter(ByteSink& sink)
+    : out(sink)
+{
+}
+
+void WktWriter::WriteText(const char* text)
+{
+    out.Write(text, std::strlen(text));
+}
+
+void WktWriter::WriteRings(const PolygonView& poly)
+{
+    auto ring = [&](RingView v) {
+        if (v.empty())
+        {
+            WriteText("EMPTY");
+            return;
+        }
+
+        out.Write("(", 1);
+        for (size_t i = 0; i <= v.size(); i++)
+        {
+            const Point& p = v[i == v.size() ? 0 : i];
+            char* s = out.Space(2 * 32 + 2);
+            char* e = s;
+            if (i > 0)
+                *e++ = ',';
+            e = std::to_chars(e, s + 2 * 32 + 2, p.x).ptr;
+            *e++ = ' ';
+            e = std::to_chars(e, s + 2 * 32 + 2, p.y).ptr;
+            out.Commit(static_cast<size_t>(e - s));
+        }
+        out.Write(")", 1);
+    };
+
+    out.Write("(", 1);
+    for (size_t i = 0; i < poly.RingCount(); i++)
+    {
+        if (i > 0)
+            out.Write(",", 1);
+        ring(poly.RingAt(i));
+    }
+    out.Write(")", 1);
+}
+
+void WktWriter::Write(const PolygonView& poly)
+{
+    if (poly.Outer().empty())
+    {
+        WriteText("POLYGON EMPTY\n");
+        return;
+    }
+    WriteText("POLYGON ");
+    WriteRings(poly);
+    out.Write("\n", 1);
+}
+
+void WktWriter::Write(const std::vector<Polygon>& multi)
+{
+    if (multi.empty())
+    {
+        WriteText("MULTIPOLYGON EMPTY\n");
+        return;
+    }
+    WriteText("MULTIPOLYGON (");
+    for (size_t i = 0; i < multi.size(); i++)
+    {
+        if (i > 0)
+            out.Write(",", 1);
+        if (multi[i].outer.vertices.empty())
+            WriteText("EMPTY");
+        else
+            WriteRings(multi[i]);
+    }
+    WriteText(")\n");
+}
+
+// ---------------------------------------------------------------------------
+// WKB
+// ---------------------------------------------------------------------------
+
+WkbReader::WkbReader(ByteSource& source)
+    : src(source)
+{
+}
+
+void WkbReader::Fail(const char* what) const
+{
+    throw std::runtime_error("WKB geometry " + std::to_string(geometry) + ": " + what);
+}
+
+uint32_t WkbReader::ReadCount(bool swap)
+{
+    if (src.Ensure(4) < 4)
+        Fail("truncated input");
+    uint32_t n = LoadU32(src.Data(), swap);
+    src.Skip(4);
+    return n;
+}
+
+WkbReader::Header WkbReader::ReadHeader()
+{
+    if (src.Ensure(5) < 5)
+        Fail("truncated input");
+
+    Header h;
+    char order = src.Data()[0];
+    if (order != 0 && order != 1)
+        Fail("bad byte order marker");
+    h.swap = (order == 1) != HostLittle;
+    uint32_t raw = LoadU32(src.Data() + 1, h.swap);
+    src.Skip(5);
+
+    // EWKB flags in the high bits, ISO dimensions in the thousands
+    bool z = (raw & 0x80000000u) != 0;
+    bool m = (raw & 0x40000000u) != 0;
+    bool srid = (raw & 0x20000000u) != 0;
+    uint32_t code = raw & 0x0FFFFFFFu;
+    uint32_t iso = code / 1000;
+    h.type = code % 1000;
+    if (iso > 3)
+        Fail("unsupported geometry type");
+    z = z || iso == 1 || iso == 3;
+    m = m || iso == 2 || iso == 3;
+    h.dims = 2 + (z ? 1 : 0) + (m ? 1 : 0);
+
+    if (srid)
+        ReadCount(h.swap);
+    return h;
+}
+
+void WkbReader::ReadRing(Ring& ring, const Header& h)
+{
+    uint32_t n = ReadCount(h.swap);
+    auto& v = ring.vertices;
+    v.clear();
+    v.reserve(std::min<size_t>(n, MaxReserve));
+
+    // Decode whole runs of points out of the buffer at a time
+    const size_t stride = 8 * size_t(h.dims);
+    size_t left = n;
+    while (left > 0)
+    {
+        size_t avail = src.Ensure(stride);
+        if (avail < stride)
+            Fail("truncated ring");
+        size_t run = std::min(left, avail / stride);
+        const char* p = src.Data();
+        for (size_t i = 0; i < run; i++, p += stride)
+            v.push_back({ LoadF64(p, h.swap), LoadF64(p + 8, h.swap) });
+        src.Skip(run * stride);
+        left -= run;
+    }
+    Open(ring);
+}
+
+// False for an empty polygon
+bool WkbReader::ReadRings(Polygon& poly, const Header& h)
+{
+    uint32_t count = ReadCount(h.swap);
+    if (count == 0)
+        return false;
+
+    // The count is untrusted: grow the hole list one ring at a time, so a
+    // corrupt count fails as truncated input instead of a huge allocation
+    ReadRing(poly.outer, h);
+    size_t holes = count - 1;
+    for (size_t i = 0; i < holes; i++)
+    {
+        if (poly.holes.size() <= i)
+            poly.holes.emplace_back();
+        ReadRing(poly.holes[i], h);
+    }
+    poly.holes.resize(holes);
+    return true;
+}
+
+bool WkbReader::Next(Polygon& poly)
+{
+    for (;;)
+    {
+        if (pendingMembers > 0)
+        {
+            pendingMembers--;
+            Header member = ReadHeader();
+            if (member.type != WkbPolygon)
+                Fail("MultiPolygon member is not a Polygon");
+            if (ReadRings(poly, member))
+                return true;
+            continue;
+        }
+
+        if (src.Ensure(1) == 0)
+            return false;
+        geometry++;
+
+        Header h = ReadHeader();
+        if (h.type == WkbPolygon)
+        {
+            if (ReadRings(poly, h))
+                return true;
+        }
+        else if (h.type == WkbMultiPolygon)
+        {
+            pendingMembers = ReadCount(h.swap);
+        }
+        else
+        {
+            Fail("expected Polygon or MultiPolygon");
+        }
+    }
+}
+
+WkbWriter::WkbWriter(ByteSink& sink)
+    : out(sink)
+{
+}
+
+void WkbWriter::WriteCount(uint32_t n)
+{
+    if (!HostLittle)
+        n = Swap32(n);
+    out.Write(&n, 4);
+}
+
+void WkbWriter::WriteHeader(uint32_t type)
+{
+    out.Write("\x01", 1);
+    WriteCount(type);
+}
+
+void WkbWriter::WriteRings(const PolygonView& poly)
+{
+    auto ring = [&](RingView v) {
+        WriteCount(v.empty() ? 0 : static_cast<uint32_t>(v.size() + 1));
+        for (size_t i = 0; !v.empty() && i <= v.size(); i++)
+        {
+            const Point& p = v[i == v.size() ? 0 : i];
+            uint64_t xy[2] = { std::bit_cast<uint64_t>(p.x), std::bit_cast<uint64_t>(p.y) };
+            if (!HostLittle)
+            {
+                xy[0] = Swap64(xy[0]);
+                xy[1] = Swap64(xy[1]);
+            }
+            out.Write(xy, 16);
+        }
+    };
+
+    if (poly.Outer().empty())
+    {
+        WriteCount(0);
+        return;
+    }
+    WriteCount(static_cast<uint32_t>(poly.RingCount()));
+    for (size_t i = 0; i < poly.RingCount(); i++)
+        ring(poly.RingAt(i));
+}
+
+void WkbWriter::Write(const PolygonView& poly)
+{
+    WriteHeader(WkbPolygon);
+    WriteRings(poly);
+}
+
+void WkbWriter::Write(const std::vector<Polygon>& multi)
+{
+    WriteHeader(WkbMultiPolygon);
+    WriteCount(static_cast<uint32_t>(multi.size()));
+    for (const Polygon& poly : multi)
+        Write(poly);
+}
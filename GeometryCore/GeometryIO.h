@@ -0,0 +1,198 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Polygonutility.h"
+#include "GeometryViews.h"
+
+// Streaming WKT / WKB input and output for GeometryCore polygons.
+//
+// Readers pull bytes from a ByteSource (caller memory, read in place, or a
+// file descriptor through a fixed buffer) and hand back one polygon at a
+// time, so memory stays bounded by the largest polygon rather than the
+// input. Coordinates are parsed straight into Ring::vertices; passing the
+// same Polygon to every Next() call reuses its ring capacity.
+//
+// Rings are implicitly closed in GeometryCore: the repeated closing vertex
+// of WKT/WKB rings is dropped on read and written back on output.
+// Z and M ordinates are accepted and ignored. Malformed input throws
+// std::runtime_error.
+
+class ByteSource
+{
+public:
+    static constexpr size_t DefaultBuffer = 1 << 16;
+
+    // Reads a caller-owned buffer in place; the buffer must outlive the source
+    static ByteSource FromMemory(const void* data, size_t size);
+
+    // Reads an open file descriptor through a buffer of bufferSize bytes
+    static ByteSource FromFd(int fd, size_t bufferSize = DefaultBuffer);
+
+    ByteSource(ByteSource&&) = default;
+    ByteSource& operator=(ByteSource&&) = default;
+    ByteSource(const ByteSource&) = delete;
+    ByteSource& operator=(const ByteSource&) = delete;
+
+    // Make at least n bytes available (n <= buffer size) unless the input
+    // ends first; returns the number of bytes available
+    size_t Ensure(size_t n)
+    {
+        size_t avail = static_cast<size_t>(end - cur);
+        return avail >= n ? avail : Refill(n);
+    }
+
+    const char* Data() const { return cur; }
+    size_t Available() const { return static_cast<size_t>(end - cur); }
+    void Skip(size_t n) { cur += n; }
+
+    // True once the underlying input is exhausted (buffered bytes may remain)
+    bool Drained() const { return eof; }
+
+private:
+    ByteSource() = default;
+    size_t Refill(size_t n);
+
+    int fd = -1;
+    bool eof = true;
+    std::vector<char> buffer;
+    const char* cur = nullptr;
+    const char* end = nullptr;
+};
+
+class ByteSink
+{
+public:
+    static constexpr size_t DefaultBuffer = 1 << 16;
+
+    // Appends to a caller-owned vector
+    static ByteSink ToMemory(std::vector<char>& out, size_t bufferSize = DefaultBuffer);
+
+    // Writes to an open file descriptor
+    static ByteSink ToFd(int fd, size_t bufferSize = DefaultBuffer);
+
+    ByteSink(ByteSink&& other) noexcept;
+    ByteSink(const ByteSink&) = delete;
+    ByteSink& operator=(const ByteSink&) = delete;
+
+    // Flushes best-effort; call Flush() first to observe write errors
+    ~ByteSink();
+
+    // Room for n contiguous bytes (n <= buffer size); finish with Commit
+    char* Space(size_t n)
+    {
+        if (buffer.size() - used < n)
+            Flush();
+        return buffer.data() + used;
+    }
+
+    void Commit(size_t n) { used += n; }
+
+    void Write(const void* data, size_t n);
+    void Flush();
+
+private:
+    ByteSink() = default;
+
+    int fd = -1;
+    std::vector<char>* memory = nullptr;
+    std::vector<char> buffer;
+    size_t used = 0;
+};
+
+// POLYGON and MULTIPOLYGON text, optionally prefixed with SRID=n;
+// Geometries are separated by whitespace (one per line is typical).
+class WktReader
+{
+public:
+    explicit WktReader(ByteSource& source);
+
+    // Next non-empty polygon; members of a MULTIPOLYGON come back one by
+    // one. Returns false at the end of the input.
+    bool Next(Polygon& poly);
+
+    // Zero-based index of the input geometry the last polygon came from
+    size_t Geometry() const { return geometry - 1; }
+
+private:
+    void SkipSpace();
+    int Peek();
+    void Expect(char c);
+    size_t ReadWord(char* word, size_t capacity);
+    double ReadNumber();
+    bool ReadEmptyOrOpen();
+    void ReadRing(Ring& ring);
+    void ReadRings(Polygon& poly);
+    [[noreturn]] void Fail(const char* what) const;
+
+    ByteSource& src;
+    size_t geometry = 0;
+    bool inMulti = false;
+    bool needSeparator = false;
+};
+
+// ISO and extended (PostGIS) WKB, either byte order, concatenated
+// back to back
+class WkbReader
+{
+public:
+    explicit WkbReader(ByteSource& source);
+
+    // Next non-empty polygon; members of a MultiPolygon come back one by
+    // one. Returns false at the end of the input.
+    bool Next(Polygon& poly);
+
+    // Zero-based index of the input geometry the last polygon came from
+    size_t Geometry() const { return geometry - 1; }
+
+private:
+    struct Header
+    {
+        bool swap;
+        uint32_t type; // 3 = Polygon, 6 = MultiPolygon
+        uint32_t dims; // ordinates per point
+    };
+
+    Header ReadHeader();
+    uint32_t ReadCount(bool swap);
+    void ReadRing(Ring& ring, const Header& h);
+    bool ReadRings(Polygon& poly, const Header& h);
+    [[noreturn]] void Fail(const char* what) const;
+
+    ByteSource& src;
+    size_t geometry = 0;
+    uint32_t pendingMembers = 0;
+};
+
+class WktWriter
+{
+public:
+    explicit WktWriter(ByteSink& sink);
+
+    // One geometry per line; Polygons and views (e.g. FlatPolygonStore) alike
+    void Write(const PolygonView& poly);
+    void Write(const std::vector<Polygon>& multi);
+
+private:
+    void WriteRings(const PolygonView& poly);
+    void WriteText(const char* text);
+
+    ByteSink& out;
+};
+
+// Little-endian ISO WKB
+class WkbWriter
+{
+public:
+    explicit WkbWriter(ByteSink& sink);
+
+    void Write(const PolygonView& poly);
+    void Write(const std::vector<Polygon>& multi);
+
+private:
+    void WriteHeader(uint32_t type);
+    void WriteCount(uint32_t n);
+    void WriteRings(const PolygonView& poly);
+
+    ByteSink& out;
+};
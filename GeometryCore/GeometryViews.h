@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "Polygonutility.h"
+
+// Non-owning views over ring and polygon coordinates.
+// A view never copies; the storage it points at (a Ring, a caller buffer,
+// a memory-mapped FlatPolygonStore) must outlive it.
+
+// Pointer + count + orientation flag. A reversed view walks the same
+// storage back to front, so changing a ring's orientation never copies it.
+class RingView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Point*;
+        using reference = const Point&;
+
+        Iterator() = default;
+        Iterator(const Point* p, bool reversed) : p(p), step(reversed ? -1 : 1) {}
+
+        reference operator*() const { return step > 0 ? *p : p[-1]; }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { p += step; return *this; }
+        Iterator operator++(int) { Iterator t = *this; p += step; return t; }
+        Iterator& operator--() { p -= step; return *this; }
+        Iterator operator--(int) { Iterator t = *this; p -= step; return t; }
+        Iterator& operator+=(difference_type n) { p += n * step; return *this; }
+        Iterator& operator-=(difference_type n) { p -= n * step; return *this; }
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) { return (a.p - b.p) * a.step; }
+
+        bool operator==(const Iterator& o) const { return p == o.p; }
+        bool operator!=(const Iterator& o) const { return p != o.p; }
+        bool operator<(const Iterator& o) const { return (o - *this) > 0; }
+        bool operator>(const Iterator& o) const { return o < *this; }
+        bool operator<=(const Iterator& o) const { return !(o < *this); }
+        bool operator>=(const Iterator& o) const { return !(*this < o); }
+
+    private:
+        const Point* p = nullptr; // reversed iterators point one past their element
+        std::ptrdiff_t step = 1;
+    };
+
+    RingView() = default;
+    RingView(const Point* data, size_t count, bool reversed = false)
+        : data(data), count(count), reversed(reversed) {}
+    RingView(const Ring& ring) : data(ring.vertices.data()), count(ring.vertices.size()) {}
+    RingView(const std::vector<Point>& pts) : data(pts.data()), count(pts.size()) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool IsReversed() const { return reversed; }
+
+    // Underlying storage in memory order, regardless of orientation
+    const Point* Data() const { return data; }
+
+    const Point& operator[](size_t i) const { return data[reversed ? count - 1 - i : i]; }
+    Iterator begin() const { return reversed ? Iterator(data + count, true) : Iterator(data, false); }
+    Iterator end() const { return reversed ? Iterator(data, true) : Iterator(data + count, false); }
+
+    RingView Reversed() const { return RingView(data, count, !reversed); }
+
+    // Shoelace area in iteration order (> 0 for CCW)
+    double SignedArea() const
+    {
+        double a = 0.0;
+        for (size_t i = 0, j = count - 1; i < count; j = i++)
+            a += data[j].x * data[i].y - data[i].x * data[j].y;
+        return (reversed ? -a : a) * 0.5;
+    }
+
+    RingView CCW() const { return SignedArea() < 0 ? Reversed() : *this; }
+    RingView CW() const { return SignedArea() > 0 ? Reversed() : *this; }
+
+    // Owning copy, for code paths that still need a Ring
+    Ring ToRing() const { return Ring{ std::vector<Point>(begin(), end()) }; }
+
+private:
+    const Point* data = nullptr;
+    size_t count = 0;
+    bool reversed = false;
+};
+
+// Outer ring plus holes, either borrowed from a Polygon or described by a
+// flat ring table: ring i spans coords[starts[i]] .. coords[starts[i + 1]],
+// ring 0 is the outer ring
+class PolygonView
+{
+public:
+    PolygonView() = default;
+    PolygonView(const Polygon& poly) : poly(&poly), rings(1 + poly.holes.size()) {}
+    PolygonView(const Point* coords, const uint64_t* starts, size_t ringCount)
+        : coords(coords), starts(starts), rings(ringCount) {}
+
+    size_t RingCount() const { return rings; }
+    size_t HoleCount() const { return rings == 0 ? 0 : rings - 1; }
+
+    RingView RingAt(size_t i) const
+    {
+        if (poly)
+            return i == 0 ? RingView(poly->outer) : RingView(poly->holes[i - 1]);
+        return RingView(coords + starts[i], static_cast<size_t>(starts[i + 1] - starts[i]));
+    }
+
+    RingView Outer() const { return rings == 0 ? RingView() : RingAt(0); }
+    RingView Hole(size_t i) const { return RingAt(i + 1); }
+
+    // Owning copy, for code paths that still need a Polygon
+    Polygon ToPolygon() const
+    {
+        Polygon out;
+        if (rings == 0)
+            return out;
+        out.outer = Outer().ToRing();
+        out.holes.reserve(HoleCount());
+        for (size_t i = 0; i < HoleCount(); i++)
+            out.holes.push_back(Hole(i).ToRing());
+        return out;
+    }
+
+private:
+    const Polygon* poly = nullptr;
+    const Point* coords = nullptr;
+    const uint64_t* starts = nullptr;
+    size_t rings = 0;
+};
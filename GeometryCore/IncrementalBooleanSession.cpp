@@ -0,0 +1,710 @@
+#include "pch.h"
+#include "IncrementalBooleanSession.h"
+#include "NativeRings.h"
+#include "../BooleanNative/RingNesting.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    double Cross(const Point& a, const Point& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    double Orient(const Point& a, const Point& b, const Point& c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    // Proper crossing only: touching endpoints and collinear overlaps do
+    // not count. ta and tb are the parameters along each segment.
+    bool ProperCrossing(const Point& p1, const Point& p2, const Point& q1, const Point& q2,
+        double& ta, double& tb)
+    {
+        double d1 = Orient(q1, q2, p1);
+        double d2 = Orient(q1, q2, p2);
+        if (d1 == 0 || d2 == 0 || (d1 > 0) == (d2 > 0))
+            return false;
+        double d3 = Orient(p1, p2, q1);
+        double d4 = Orient(p1, p2, q2);
+        if (d3 == 0 || d4 == 0 || (d3 > 0) == (d4 > 0))
+            return false;
+        ta = d1 / (d1 - d2);
+        tb = d3 / (d3 - d4);
+        return true;
+    }
+
+    bool PointInRing(const Point& p, const std::vector<Point>& ring)
+    {
+        bool inside = false;
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+        {
+            const Point& a = ring[i];
+            const Point& b = ring[j];
+            if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+                inside = !inside;
+        }
+        return inside;
+    }
+}
+
+IncrementalBooleanSession::IncrementalBooleanSession(const Polygon& A, const Polygon& B, BoolOp operation)
+    : op(operation)
+{
+    const Ring* input[2] = { &A.outer, &B.outer };
+    double length = 0;
+    size_t edges = 0;
+    for (int s = 0; s < 2; s++)
+    {
+        const std::vector<Point>& v = input[s]->vertices;
+        if (v.size() < 3)
+            throw std::invalid_argument("IncrementalBooleanSession: rings need at least 3 vertices");
+
+        Side& side = sides[s];
+        for (const Point& p : v)
+            side.order.push_back(NewVertex(s, p));
+        size_t n = side.order.size();
+        for (size_t i = 0; i < n; i++)
+        {
+            uint32_t id = side.order[i];
+            side.next[id] = side.order[(i + 1) % n];
+            side.prev[id] = side.order[(i + n - 1) % n];
+            side.area2 += Cross(v[i], v[(i + 1) % n]);
+            length += std::hypot(v[(i + 1) % n].x - v[i].x, v[(i + 1) % n].y - v[i].y);
+        }
+        edges += n;
+    }
+
+    // About two average edges per cell keeps most cells to a handful of
+    // entries without making long edges span many cells
+    cellSize = edges ? 2 * length / edges : 1;
+    if (!(cellSize > 0))
+        cellSize = 1;
+
+    for (int s = 0; s < 2; s++)
+    {
+        for (uint32_t e : sides[s].order)
+            GridInsert(s, e);
+    }
+
+    SessionChange change;
+    for (uint32_t e : sides[0].order)
+        FindCrossings(0, e, change);
+    for (int s = 0; s < 2; s++)
+    {
+        for (uint32_t e : sides[s].order)
+            SortCrossings(s, e);
+    }
+    Finish(change, AllSides, {}, false);
+}
+
+uint32_t IncrementalBooleanSession::NewVertex(int s, Point p)
+{
+    Side& side = sides[s];
+    uint32_t id;
+    if (!side.freeIds.empty())
+    {
+        id = side.freeIds.back();
+        side.freeIds.pop_back();
+        side.pts[id] = p;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(side.pts.size());
+        side.pts.push_back(p);
+        side.next.push_back(None);
+        side.prev.push_back(None);
+        side.crossings.emplace_back();
+        stamp[s].push_back(0);
+    }
+    return id;
+}
+
+std::vector<Point> IncrementalBooleanSession::Vertices(BooleanOperand which) const
+{
+    const Side& side = sides[Index(which)];
+    std::vector<Point> out;
+    out.reserve(side.order.size());
+    for (uint32_t id : side.order)
+        out.push_back(side.pts[id]);
+    return out;
+}
+
+// ---------------------------------------------------------------
+// Grid
+// ---------------------------------------------------------------
+
+uint64_t IncrementalBooleanSession::CellKey(int64_t x, int64_t y) const
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void IncrementalBooleanSession::CellRange(int s, uint32_t e, int64_t& x0, int64_t& y0, int64_t& x1, int64_t& y1) const
+{
+    Point a = sides[s].pts[e];
+    Point b = EdgeEnd(s, e);
+    x0 = static_cast<int64_t>(std::floor(std::min(a.x, b.x) / cellSize));
+    y0 = static_cast<int64_t>(std::floor(std::min(a.y, b.y) / cellSize));
+    x1 = static_cast<int64_t>(std::floor(std::max(a.x, b.x) / cellSize));
+    y1 = static_cast<int64_t>(std::floor(std::max(a.y, b.y) / cellSize));
+}
+
+void IncrementalBooleanSession::GridInsert(int s, uint32_t e)
+{
+    int64_t x0, y0, x1, y1;
+    CellRange(s, e, x0, y0, x1, y1);
+    uint64_t entry = (static_cast<uint64_t>(s) << 32) | e;
+    for (int64_t x = x0; x <= x1; x++)
+    {
+        for (int64_t y = y0; y <= y1; y++)
+            grid[CellKey(x, y)].push_back(entry);
+    }
+}
+
+void IncrementalBooleanSession::GridRemove(int s, uint32_t e)
+{
+    int64_t x0, y0, x1, y1;
+    CellRange(s, e, x0, y0, x1, y1);
+    uint64_t entry = (static_cast<uint64_t>(s) << 32) | e;
+    for (int64_t x = x0; x <= x1; x++)
+    {
+        for (int64_t y = y0; y <= y1; y++)
+        {
+            auto it = grid.find(CellKey(x, y));
+            if (it == grid.end())
+                continue;
+            std::vector<uint64_t>& cell = it->second;
+            auto pos = std::find(cell.begin(), cell.end(), entry);
+            if (pos != cell.end())
+            {
+                *pos = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty())
+                grid.erase(it);
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// Crossings
+// ---------------------------------------------------------------
+
+void IncrementalBooleanSession::DropCrossings(int s, uint32_t e)
+{
+    int o = 1 - s;
+    for (uint32_t c : sides[s].crossings[e])
+    {
+        Crossing& x = pool[c];
+        std::vector<uint32_t>& other = sides[o].crossings[x.edge[o]];
+        other.erase(std::find(other.begin(), other.end(), c));
+        if (x.ring)
+            InvalidateRing(x.ring);
+        x.live = false;
+        freeCrossings.push_back(c);
+        liveCrossings--;
+    }
+    sides[s].crossings[e].clear();
+}
+
+void IncrementalBooleanSession::FindCrossings(int s, uint32_t e, SessionChange& change)
+{
+    int o = 1 - s;
+    if (++stampValue == 0)
+    {
+        for (auto& st : stamp)
+            std::fill(st.begin(), st.end(), 0);
+        stampValue = 1;
+    }
+
+    Point p1 = sides[s].pts[e];
+    Point p2 = EdgeEnd(s, e);
+    int64_t x0, y0, x1, y1;
+    CellRange(s, e, x0, y0, x1, y1);
+    for (int64_t x = x0; x <= x1; x++)
+    {
+        for (int64_t y = y0; y <= y1; y++)
+        {
+            auto it = grid.find(CellKey(x, y));
+            if (it == grid.end())
+                continue;
+            for (uint64_t entry : it->second)
+            {
+                if (static_cast<int>(entry >> 32) != o)
+                    continue;
+                uint32_t f = static_cast<uint32_t>(entry);
+                if (stamp[o][f] == stampValue)
+                    continue;
+                stamp[o][f] = stampValue;
+
+                change.edgesTested++;
+                double ts, to;
+                if (!ProperCrossing(p1, p2, sides[o].pts[f], EdgeEnd(o, f), ts, to))
+                    continue;
+
+                uint32_t c;
+                if (!freeCrossings.empty())
+                {
+                    c = freeCrossings.back();
+                    freeCrossings.pop_back();
+                }
+                else
+                {
+                    c = static_cast<uint32_t>(pool.size());
+                    pool.emplace_back();
+                }
+                Crossing& cr = pool[c];
+                cr.edge[s] = e;
+                cr.edge[o] = f;
+                cr.t[s] = ts;
+                cr.t[o] = to;
+                cr.p = { p1.x + ts * (p2.x - p1.x), p1.y + ts * (p2.y - p1.y) };
+                cr.keep = -1;
+                cr.ring = 0;
+                cr.live = true;
+                cr.fresh = true;
+                liveCrossings++;
+                fresh.push_back(c);
+
+                sides[s].crossings[e].push_back(c);
+                sides[o].crossings[f].push_back(c);
+                SortCrossings(o, f);
+            }
+        }
+    }
+    SortCrossings(s, e);
+}
+
+void IncrementalBooleanSession::SortCrossings(int s, uint32_t e)
+{
+    std::vector<uint32_t>& list = sides[s].crossings[e];
+    std::sort(list.begin(), list.end(), [&](uint32_t a, uint32_t b) { return pool[a].t[s] < pool[b].t[s]; });
+}
+
+// Result rings are traced with both operands CCW, except that a difference
+// walks the subtracted ring backwards
+int IncrementalBooleanSession::Direction(int s) const
+{
+    int d = sides[s].area2 >= 0 ? 1 : -1;
+    if ((op == BoolOp::AminusB && s == 1) || (op == BoolOp::BminusA && s == 0))
+        d = -d;
+    return d;
+}
+
+// Whether the piece of side s leaving c (in its trace direction) belongs
+// to the result boundary
+bool IncrementalBooleanSession::KeepOutgoing(int s, const Crossing& c) const
+{
+    int o = 1 - s;
+    Point a0 = sides[s].pts[c.edge[s]], a1 = EdgeEnd(s, c.edge[s]);
+    Point b0 = sides[o].pts[c.edge[o]], b1 = EdgeEnd(o, c.edge[o]);
+    double ds = Direction(s);
+    double doo = sides[o].area2 >= 0 ? 1 : -1; // other ring made CCW: inside is on its left
+    Point out{ (a1.x - a0.x) * ds, (a1.y - a0.y) * ds };
+    Point w{ (b1.x - b0.x) * doo, (b1.y - b0.y) * doo };
+    bool inside = Cross(w, out) > 0;
+
+    switch (op)
+    {
+    case BoolOp::Union:        return !inside;
+    case BoolOp::Intersection: return inside;
+    case BoolOp::AminusB:      return s == 0 ? !inside : inside;
+    case BoolOp::BminusA:      return s == 1 ? !inside : inside;
+    }
+    return false;
+}
+
+void IncrementalBooleanSession::Classify(uint32_t c)
+{
+    Crossing& x = pool[c];
+    x.keep = KeepOutgoing(0, x) ? 0 : KeepOutgoing(1, x) ? 1 : -1;
+}
+
+// ---------------------------------------------------------------
+// Result rings
+// ---------------------------------------------------------------
+
+void IncrementalBooleanSession::InvalidateRing(uint64_t id)
+{
+    auto it = ringIndex.find(id);
+    if (it == ringIndex.end())
+        return;
+    size_t i = it->second;
+    for (uint32_t c : ringCrossings[i])
+    {
+        if (pool[c].live && pool[c].ring == id)
+        {
+            pool[c].ring = 0;
+            pending.push_back(c);
+        }
+    }
+    removed.push_back(id);
+
+    size_t last = rings.size() - 1;
+    if (i != last)
+    {
+        rings[i] = std::move(rings[last]);
+        ringCrossings[i] = std::move(ringCrossings[last]);
+        wholeRing[i] = wholeRing[last];
+        ringIndex[rings[i].id] = i;
+    }
+    rings.pop_back();
+    ringCrossings.pop_back();
+    wholeRing.pop_back();
+    ringIndex.erase(it);
+}
+
+// The result ring, if any, that runs over position t of edge e on side s:
+// the one leaving the nearest older crossing behind that position
+void IncrementalBooleanSession::InvalidateAround(int s, uint32_t e, double t)
+{
+    const Side& side = sides[s];
+    int d = Direction(s);
+    uint32_t edge = e;
+    for (size_t steps = 0; steps <= side.order.size(); steps++)
+    {
+        const std::vector<uint32_t>& list = side.crossings[edge];
+        uint32_t found = None;
+        if (d > 0)
+        {
+            for (auto it = list.rbegin(); it != list.rend(); ++it)
+            {
+                const Crossing& x = pool[*it];
+                if (!x.fresh && (edge != e || steps > 0 || x.t[s] < t))
+                {
+                    found = *it;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t c : list)
+            {
+                const Crossing& x = pool[c];
+                if (!x.fresh && (edge != e || steps > 0 || x.t[s] > t))
+                {
+                    found = c;
+                    break;
+                }
+            }
+        }
+
+        if (found != None)
+        {
+            const Crossing& x = pool[found];
+            if (x.keep == s && x.ring)
+                InvalidateRing(x.ring);
+            return;
+        }
+        edge = d > 0 ? side.prev[edge] : side.next[edge];
+    }
+}
+
+// Walks from crossing start along the kept pieces, switching rings at
+// every crossing, until it comes back. Fails (degenerate input) if a
+// crossing has no kept side or the walk does not close.
+bool IncrementalBooleanSession::TraceFrom(uint32_t start, SessionRing& ring, std::vector<uint32_t>& visited)
+{
+    size_t limit = 2 * (sides[0].order.size() + sides[1].order.size() + liveCrossings) + 8;
+    ring.vertices.clear();
+    visited.clear();
+
+    uint32_t cur = start;
+    for (size_t steps = 0; steps < limit; steps++)
+    {
+        const Crossing& x = pool[cur];
+        if (x.keep < 0 || x.ring)
+            return false;
+        ring.vertices.push_back(x.p);
+        visited.push_back(cur);
+
+        int s = x.keep;
+        const Side& side = sides[s];
+        int d = Direction(s);
+        uint32_t e = x.edge[s];
+
+        // Next crossing on the same edge, in trace direction
+        const std::vector<uint32_t>& list = side.crossings[e];
+        size_t pos = std::find(list.begin(), list.end(), cur) - list.begin();
+        uint32_t nextCrossing = None;
+        if (d > 0 && pos + 1 < list.size())
+            nextCrossing = list[pos + 1];
+        else if (d < 0 && pos > 0)
+            nextCrossing = list[pos - 1];
+
+        // Otherwise follow the ring's vertices to the next edge with one
+        for (size_t walked = 0; nextCrossing == None && walked <= side.order.size(); walked++)
+        {
+            if (d > 0)
+            {
+                e = side.next[e];
+                ring.vertices.push_back(side.pts[e]);
+                if (!side.crossings[e].empty())
+                    nextCrossing = side.crossings[e].front();
+            }
+            else
+            {
+                ring.vertices.push_back(side.pts[e]);
+                e = side.prev[e];
+                if (!side.crossings[e].empty())
+                    nextCrossing = side.crossings[e].back();
+            }
+        }
+        if (nextCrossing == None)
+            return false;
+        if (nextCrossing == start)
+            return ring.vertices.size() >= 3;
+        cur = nextCrossing;
+    }
+    return false;
+}
+
+void IncrementalBooleanSession::Retrace(SessionChange& change)
+{
+    std::vector<uint32_t> visited;
+    for (uint32_t c : pending)
+    {
+        const Crossing& x = pool[c];
+        if (!x.live || x.ring || x.keep < 0)
+            continue;
+
+        SessionRing ring{ nextRingId++, {} };
+        if (!TraceFrom(c, ring, visited))
+            continue;
+        for (uint32_t v : visited)
+            pool[v].ring = ring.id;
+        change.added.push_back(ring.id);
+        ringIndex[ring.id] = rings.size();
+        rings.push_back(std::move(ring));
+        ringCrossings.push_back(visited);
+        wholeRing.push_back(-1);
+    }
+    pending.clear();
+}
+
+// With no crossings each operand is kept whole or not at all
+void IncrementalBooleanSession::WholeRings(SessionChange& change, int editedSide)
+{
+    bool keep[2] = { false, false };
+    if (liveCrossings == 0)
+    {
+        std::vector<Point> ringOf[2] = { Vertices(BooleanOperand::A), Vertices(BooleanOperand::B) };
+        for (int s = 0; s < 2; s++)
+        {
+            bool inside = PointInRing(ringOf[s][0], ringOf[1 - s]);
+            switch (op)
+            {
+            case BoolOp::Union:        keep[s] = !inside; break;
+            case BoolOp::Intersection: keep[s] = inside; break;
+            case BoolOp::AminusB:      keep[s] = s == 0 ? !inside : inside; break;
+            case BoolOp::BminusA:      keep[s] = s == 1 ? !inside : inside; break;
+            }
+        }
+    }
+
+    for (int s = 0; s < 2; s++)
+    {
+        uint64_t existing = 0;
+        for (size_t i = 0; i < rings.size(); i++)
+        {
+            if (wholeRing[i] == s)
+                existing = rings[i].id;
+        }
+        if (existing && keep[s] && s != editedSide && editedSide != AllSides)
+            continue;
+        if (existing)
+            InvalidateRing(existing);
+        if (!keep[s])
+            continue;
+
+        SessionRing ring{ nextRingId++, Vertices(s == 0 ? BooleanOperand::A : BooleanOperand::B) };
+        if (Direction(s) < 0)
+            std::reverse(ring.vertices.begin(), ring.vertices.end());
+        change.added.push_back(ring.id);
+        ringIndex[ring.id] = rings.size();
+        rings.push_back(std::move(ring));
+        ringCrossings.emplace_back();
+        wholeRing.push_back(s);
+    }
+}
+
+// ---------------------------------------------------------------
+// Edits
+// ---------------------------------------------------------------
+
+bool IncrementalBooleanSession::UpdateArea(int s, double delta)
+{
+    bool wasCCW = sides[s].area2 >= 0;
+    sides[s].area2 += delta;
+    return (sides[s].area2 >= 0) != wasCCW;
+}
+
+void IncrementalBooleanSession::Finish(SessionChange& change, int editedSide,
+    std::initializer_list<uint32_t> changedEdges, bool rebuild)
+{
+    if (rebuild)
+    {
+        // Orientation or operation changed: every kept side may differ
+        while (!rings.empty())
+            InvalidateRing(rings.back().id);
+        for (uint32_t c = 0; c < pool.size(); c++)
+        {
+            if (!pool[c].live)
+                continue;
+            Classify(c);
+            pending.push_back(c);
+        }
+    }
+    else
+    {
+        for (uint32_t c : fresh)
+            Classify(c);
+    }
+
+    // Rings that ran over a changed edge, or over a spot of the other ring
+    // that now has a crossing, are traced again
+    if (!rebuild && editedSide != AllSides)
+    {
+        int o = 1 - editedSide;
+        for (uint32_t e : changedEdges)
+            InvalidateAround(editedSide, e, 0);
+        for (uint32_t c : fresh)
+            InvalidateAround(o, pool[c].edge[o], pool[c].t[o]);
+    }
+
+    for (uint32_t c : fresh)
+    {
+        pool[c].fresh = false;
+        pending.push_back(c);
+    }
+    fresh.clear();
+
+    Retrace(change);
+    WholeRings(change, rebuild ? AllSides : editedSide);
+    change.removed.insert(change.removed.end(), removed.begin(), removed.end());
+    removed.clear();
+}
+
+SessionChange IncrementalBooleanSession::InsertVertex(BooleanOperand which, size_t index, Point p)
+{
+    int s = static_cast<int>(Index(which));
+    Side& side = sides[s];
+    size_t n = side.order.size();
+    if (index > n)
+        throw std::out_of_range("IncrementalBooleanSession: vertex index out of range");
+
+    uint32_t w = side.order[index % n];
+    uint32_t u = side.prev[w];
+    Point pu = side.pts[u], pw = side.pts[w];
+
+    SessionChange change;
+    DropCrossings(s, u);
+    GridRemove(s, u);
+
+    uint32_t v = NewVertex(s, p);
+    side.next[u] = v;
+    side.prev[v] = u;
+    side.next[v] = w;
+    side.prev[w] = v;
+    side.order.insert(side.order.begin() + index, v);
+    bool flipped = UpdateArea(s, Cross(pu, p) + Cross(p, pw) - Cross(pu, pw));
+
+    GridInsert(s, u);
+    GridInsert(s, v);
+    FindCrossings(s, u, change);
+    FindCrossings(s, v, change);
+    Finish(change, s, { u, v }, flipped);
+    return change;
+}
+
+SessionChange IncrementalBooleanSession::MoveVertex(BooleanOperand which, size_t index, Point p)
+{
+    int s = static_cast<int>(Index(which));
+    Side& side = sides[s];
+    if (index >= side.order.size())
+        throw std::out_of_range("IncrementalBooleanSession: vertex index out of range");
+
+    uint32_t v = side.order[index];
+    uint32_t u = side.prev[v];
+    Point pu = side.pts[u], pv = side.pts[v], pw = side.pts[side.next[v]];
+
+    SessionChange change;
+    DropCrossings(s, u);
+    DropCrossings(s, v);
+    GridRemove(s, u);
+    GridRemove(s, v);
+
+    side.pts[v] = p;
+    bool flipped = UpdateArea(s, Cross(pu, p) + Cross(p, pw) - Cross(pu, pv) - Cross(pv, pw));
+
+    GridInsert(s, u);
+    GridInsert(s, v);
+    FindCrossings(s, u, change);
+    FindCrossings(s, v, change);
+    Finish(change, s, { u, v }, flipped);
+    return change;
+}
+
+SessionChange IncrementalBooleanSession::DeleteVertex(BooleanOperand which, size_t index)
+{
+    int s = static_cast<int>(Index(which));
+    Side& side = sides[s];
+    if (index >= side.order.size())
+        throw std::out_of_range("IncrementalBooleanSession: vertex index out of range");
+    if (side.order.size() <= 3)
+        throw std::invalid_argument("IncrementalBooleanSession: rings need at least 3 vertices");
+
+    uint32_t v = side.order[index];
+    uint32_t u = side.prev[v];
+    uint32_t w = side.next[v];
+    Point pu = side.pts[u], pv = side.pts[v], pw = side.pts[w];
+
+    SessionChange change;
+    DropCrossings(s, u);
+    DropCrossings(s, v);
+    GridRemove(s, u);
+    GridRemove(s, v);
+
+    side.next[u] = w;
+    side.prev[w] = u;
+    side.next[v] = None;
+    side.prev[v] = None;
+    side.freeIds.push_back(v);
+    side.order.erase(side.order.begin() + index);
+    bool flipped = UpdateArea(s, Cross(pu, pw) - Cross(pu, pv) - Cross(pv, pw));
+
+    GridInsert(s, u);
+    FindCrossings(s, u, change);
+    Finish(change, s, { u }, flipped);
+    return change;
+}
+
+SessionChange IncrementalBooleanSession::SetOperation(BoolOp operation)
+{
+    op = operation;
+    SessionChange change;
+    Finish(change, AllSides, {}, true);
+    return change;
+}
+
+// Outer rings are CCW and holes CW, nested by RingNesting
+std::vector<Polygon> IncrementalBooleanSession::Result() const
+{
+    std::vector<PolygonBoolean::RingSpan> spans;
+    spans.reserve(rings.size());
+    for (const SessionRing& r : rings)
+        spans.push_back(ToRingSpan(r.vertices));
+
+    std::vector<Polygon> result;
+    for (const auto& group : PolygonBoolean::RingNesting::group(spans))
+    {
+        Polygon& poly = result.emplace_back();
+        poly.outer.vertices = rings[group[0]].vertices;
+        for (size_t i = 1; i < group.size(); i++)
+            poly.holes.push_back(Ring{ rings[group[i]].vertices });
+    }
+    return result;
+}
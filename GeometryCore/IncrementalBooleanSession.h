@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+#include "BooleanOps.h"
+
+// Boolean of two rings that stays up to date under vertex edits, for
+// interactive editors that recompute on every mouse move.
+//
+// The session keeps the edge arrangement: a grid of both rings' edges,
+// every crossing between them, and the side each crossing's result
+// boundary continues on. An insert, move or delete of a vertex only
+// retests the one or two edges it changes against the other ring's edges
+// in the same grid cells, and only the result rings that ran over a
+// changed edge or crossing are traced again. The rest keep their ids, so
+// a caller can redraw just the rings an edit reports. An edit costs the
+// grid cells its edges cover plus the length of the rings it retraces,
+// instead of the O(n·m) of recomputing from scratch.
+//
+// Outer rings only (holes are ignored, as in BooleanOps::ComputeBoolean2).
+// Inputs are assumed to be in general position: edges that merely touch,
+// or overlap collinearly, are not counted as crossings.
+
+enum class BooleanOperand
+{
+    A,
+    B
+};
+
+struct SessionRing
+{
+    uint64_t id;
+    std::vector<Point> vertices;
+};
+
+// What one edit did to the result; ids refer to Rings()
+struct SessionChange
+{
+    std::vector<uint64_t> removed;
+    std::vector<uint64_t> added;
+    size_t edgesTested = 0; // segment tests spent finding crossings
+};
+
+class IncrementalBooleanSession
+{
+public:
+    // Throws std::invalid_argument if either outer ring has fewer than 3
+    // vertices
+    IncrementalBooleanSession(const Polygon& A, const Polygon& B, BoolOp operation);
+
+    // index is the vertex's position in the operand's ring as last edited.
+    // Insert makes p the vertex at index (index == size appends). Indices
+    // past the end throw std::out_of_range; Delete throws
+    // std::invalid_argument when the ring would drop below 3.
+    SessionChange InsertVertex(BooleanOperand which, size_t index, Point p);
+    SessionChange MoveVertex(BooleanOperand which, size_t index, Point p);
+    SessionChange DeleteVertex(BooleanOperand which, size_t index);
+
+    // Keeps the crossings; every result ring is traced again
+    SessionChange SetOperation(BoolOp operation);
+
+    BoolOp Operation() const { return op; }
+    size_t VertexCount(BooleanOperand which) const { return sides[Index(which)].order.size(); }
+    std::vector<Point> Vertices(BooleanOperand which) const;
+    size_t CrossingCount() const { return liveCrossings; }
+
+    const std::vector<SessionRing>& Rings() const { return rings; }
+    std::vector<Polygon> Result() const;
+
+private:
+    static constexpr uint32_t None = UINT32_MAX;
+    static constexpr int AllSides = 2; // editedSide for a full rebuild
+
+    // Vertex ids are stable across edits; edge e runs from vertex e to
+    // next[e]
+    struct Side
+    {
+        std::vector<Point> pts;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> prev;
+        std::vector<std::vector<uint32_t>> crossings; // per edge, sorted by t
+        std::vector<uint32_t> freeIds;
+        std::vector<uint32_t> order; // ids in ring order
+        double area2 = 0;            // twice the signed area
+    };
+
+    struct Crossing
+    {
+        uint32_t edge[2];
+        double t[2];
+        Point p;
+        int keep;      // side the result boundary continues on after p, -1 for none
+        uint64_t ring; // result ring through p, 0 for none
+        bool live;
+        bool fresh;    // found by the current edit
+    };
+
+    static size_t Index(BooleanOperand which) { return which == BooleanOperand::A ? 0 : 1; }
+
+    uint32_t NewVertex(int s, Point p);
+    Point EdgeEnd(int s, uint32_t e) const { return sides[s].pts[sides[s].next[e]]; }
+
+    // Grid of edge bounding boxes, both sides in one hash keyed by cell
+    uint64_t CellKey(int64_t x, int64_t y) const;
+    void CellRange(int s, uint32_t e, int64_t& x0, int64_t& y0, int64_t& x1, int64_t& y1) const;
+    void GridInsert(int s, uint32_t e);
+    void GridRemove(int s, uint32_t e);
+
+    void DropCrossings(int s, uint32_t e);
+    void FindCrossings(int s, uint32_t e, SessionChange& change);
+    void SortCrossings(int s, uint32_t e);
+    void Classify(uint32_t c);
+
+    int Direction(int s) const;
+    bool KeepOutgoing(int s, const Crossing& c) const;
+
+    void InvalidateRing(uint64_t id);
+    void InvalidateAround(int s, uint32_t e, double t);
+    bool TraceFrom(uint32_t start, SessionRing& ring, std::vector<uint32_t>& visited);
+    void Retrace(SessionChange& change);
+    void WholeRings(SessionChange& change, int editedSide);
+
+    bool UpdateArea(int s, double delta); // true if the orientation flipped
+    void Finish(SessionChange& change, int editedSide, std::initializer_list<uint32_t> changedEdges,
+        bool rebuild);
+
+    Side sides[2];
+    BoolOp op;
+
+    std::vector<Crossing> pool;
+    std::vector<uint32_t> freeCrossings;
+    size_t liveCrossings = 0;
+    std::vector<uint32_t> fresh;   // crossings found by the current edit
+    std::vector<uint32_t> pending; // crossings that need a ring
+
+    double cellSize = 1;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> grid; // cell -> side << 32 | edge
+    std::vector<uint32_t> stamp[2];
+    uint32_t stampValue = 0;
+
+    std::vector<SessionRing> rings;
+    std::vector<std::vector<uint32_t>> ringCrossings; // parallel to rings
+    std::vector<int> wholeRing;                       // parallel to rings: operand kept whole, or -1
+    std::unordered_map<uint64_t, size_t> ringIndex;
+    std::vector<uint64_t> removed;                    // ring ids dropped by the current edit
+    uint64_t nextRingId = 1;
+};
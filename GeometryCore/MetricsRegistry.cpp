@@ -0,0 +1,368 @@
+#include "pch.h"
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    const size_t OpCount = static_cast<size_t>(MetricOp::Count);
+
+    // Owner-thread increment: readers only ever load, so a plain
+    // load/store pair is enough and avoids a locked instruction
+    void Add(std::atomic<uint64_t>& counter, uint64_t by)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    struct Merged
+    {
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+        uint64_t sum = 0;
+        uint64_t highest = 0;
+
+        uint64_t Percentile(double q) const
+        {
+            uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * total + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); i++)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                    return std::min(LatencyHistogram::BucketHigh(i), highest);
+            }
+            return highest;
+        }
+    };
+}
+
+// =====================================================
+// Histogram
+// =====================================================
+size_t LatencyHistogram::BucketIndex(uint64_t nanos)
+{
+    const uint64_t limit = (uint64_t(1) << MaxValueBits) - 1;
+    nanos = std::min(nanos, limit);
+    if (nanos < (uint64_t(1) << SubBucketBits))
+        return static_cast<size_t>(nanos);
+
+    // Leading one plus SubBucketBits bits of mantissa
+    int shift = static_cast<int>(std::bit_width(nanos)) - 1 - SubBucketBits;
+    size_t mantissa = static_cast<size_t>(nanos >> shift) & ((size_t(1) << SubBucketBits) - 1);
+    return (size_t(shift + 1) << SubBucketBits) | mantissa;
+}
+
+uint64_t LatencyHistogram::BucketLow(size_t index)
+{
+    if (index < (size_t(1) << SubBucketBits))
+        return index;
+    int shift = static_cast<int>(index >> SubBucketBits) - 1;
+    uint64_t mantissa = index & ((size_t(1) << SubBucketBits) - 1);
+    return ((uint64_t(1) << SubBucketBits) | mantissa) << shift;
+}
+
+uint64_t LatencyHistogram::BucketHigh(size_t index)
+{
+    if (index < (size_t(1) << SubBucketBits))
+        return index;
+    int shift = static_cast<int>(index >> SubBucketBits) - 1;
+    return BucketLow(index) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t nanos)
+{
+    Add(counts[BucketIndex(nanos)], 1);
+    Add(total, 1);
+    Add(sum, nanos);
+    if (nanos > highest.load(std::memory_order_relaxed))
+        highest.store(nanos, std::memory_order_relaxed);
+}
+
+// =====================================================
+// Registry
+// =====================================================
+struct MetricsRegistry::Shard
+{
+    std::atomic<bool> inUse{ false };
+
+    // Created by the owning thread on first use, read by snapshots
+    std::atomic<LatencyHistogram*> slots[OpCount * SizeBuckets] = {};
+
+    ~Shard()
+    {
+        for (auto& slot : slots)
+            delete slot.load();
+    }
+};
+
+struct MetricsRegistry::PeriodicDump
+{
+    std::string path;
+    MetricsFormat format;
+    std::chrono::milliseconds interval;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;
+    std::thread worker;
+
+    void Halt()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+};
+
+std::atomic<uint32_t> MetricsRegistry::enabledMask{ 0 };
+
+MetricsRegistry::MetricsRegistry() = default;
+
+MetricsRegistry& MetricsRegistry::Instance()
+{
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+void MetricsRegistry::Enable(MetricOp op, bool on)
+{
+    uint32_t bit = uint32_t(1) << static_cast<unsigned>(op);
+    if (on)
+        enabledMask.fetch_or(bit, std::memory_order_relaxed);
+    else
+        enabledMask.fetch_and(~bit, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::EnableAll(bool on)
+{
+    enabledMask.store(on ? (uint32_t(1) << OpCount) - 1 : 0, std::memory_order_relaxed);
+}
+
+const char* MetricsRegistry::OpName(MetricOp op)
+{
+    switch (op)
+    {
+    case MetricOp::GhCompute: return "gh.compute";
+    case MetricOp::ShBoolean: return "sh.boolean";
+    case MetricOp::Clip: return "clip";
+    case MetricOp::ClipOutside: return "clip.outside";
+    case MetricOp::PointInPolygon: return "pointInPolygon";
+    case MetricOp::PolygonsOverlap: return "polygonsOverlap";
+    case MetricOp::IntersectionArea: return "intersectionArea";
+    case MetricOp::IoU: return "iou";
+    case MetricOp::ConvexBatch: return "convexBatch";
+    case MetricOp::WindingOverlay: return "windingOverlay";
+    case MetricOp::MinkowskiSum: return "minkowski.sum";
+    case MetricOp::MinkowskiDifference: return "minkowski.difference";
+    default: return "unknown";
+    }
+}
+
+unsigned MetricsRegistry::SizeBucket(size_t vertices)
+{
+    if (vertices <= 1)
+        return 0;
+    return std::min<unsigned>(static_cast<unsigned>(std::bit_width(vertices)) - 1, SizeBuckets - 1);
+}
+
+// Shards outlive their threads: when a thread exits its shard, samples
+// and all, goes to the next new thread, so memory follows the peak
+// thread count rather than the number of threads ever started
+MetricsRegistry::Shard& MetricsRegistry::LocalShard()
+{
+    struct Lease
+    {
+        Shard* shard = nullptr;
+        ~Lease()
+        {
+            if (shard)
+                shard->inUse.store(false, std::memory_order_release);
+        }
+    };
+    thread_local Lease lease;
+    if (lease.shard)
+        return *lease.shard;
+
+    std::lock_guard<std::mutex> lock(shardsMutex);
+    for (const std::unique_ptr<Shard>& shard : shards)
+    {
+        if (!shard->inUse.load(std::memory_order_acquire))
+        {
+            shard->inUse.store(true, std::memory_order_relaxed);
+            lease.shard = shard.get();
+            return *shard;
+        }
+    }
+    shards.push_back(std::make_unique<Shard>());
+    shards.back()->inUse.store(true, std::memory_order_relaxed);
+    lease.shard = shards.back().get();
+    return *lease.shard;
+}
+
+void MetricsRegistry::Record(MetricOp op, size_t vertices, uint64_t nanos)
+{
+    Shard& shard = LocalShard();
+    std::atomic<LatencyHistogram*>& slot =
+        shard.slots[static_cast<size_t>(op) * SizeBuckets + SizeBucket(vertices)];
+
+    LatencyHistogram* histogram = slot.load(std::memory_order_relaxed);
+    if (!histogram)
+    {
+        histogram = new LatencyHistogram();
+        slot.store(histogram, std::memory_order_release);
+    }
+    histogram->Record(nanos);
+}
+
+std::vector<MetricsEntry> MetricsRegistry::Snapshot() const
+{
+    std::vector<Merged> merged(OpCount * SizeBuckets);
+    {
+        std::lock_guard<std::mutex> lock(shardsMutex);
+        for (const std::unique_ptr<Shard>& shard : shards)
+        {
+            for (size_t key = 0; key < merged.size(); key++)
+            {
+                const LatencyHistogram* h = shard->slots[key].load(std::memory_order_acquire);
+                if (!h)
+                    continue;
+
+                Merged& m = merged[key];
+                if (m.counts.empty())
+                    m.counts.resize(LatencyHistogram::BucketCount);
+                for (size_t i = 0; i < LatencyHistogram::BucketCount; i++)
+                    m.counts[i] += h->counts[i].load(std::memory_order_relaxed);
+                m.total += h->total.load(std::memory_order_relaxed);
+                m.sum += h->sum.load(std::memory_order_relaxed);
+                m.highest = std::max(m.highest, h->highest.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    std::vector<MetricsEntry> entries;
+    for (size_t key = 0; key < merged.size(); key++)
+    {
+        const Merged& m = merged[key];
+        if (m.total == 0)
+            continue;
+
+        MetricsEntry e;
+        e.op = static_cast<MetricOp>(key / SizeBuckets);
+        e.sizeBucket = static_cast<unsigned>(key % SizeBuckets);
+        e.count = m.total;
+        e.mean = static_cast<double>(m.sum) / m.total;
+        e.p50 = m.Percentile(0.5);
+        e.p90 = m.Percentile(0.9);
+        e.p99 = m.Percentile(0.99);
+        e.p999 = m.Percentile(0.999);
+        e.max = m.highest;
+        entries.push_back(e);
+    }
+    return entries;
+}
+
+void MetricsRegistry::Write(const std::vector<MetricsEntry>& entries, MetricsFormat format, FILE* out)
+{
+    if (format == MetricsFormat::Text)
+    {
+        fprintf(out, "%-16s %-10s %10s %10s %10s %10s %10s %10s %10s  (us)\n",
+            "op", "vertices", "count", "mean", "p50", "p90", "p99", "p999", "max");
+        for (const MetricsEntry& e : entries)
+        {
+            char size[16];
+            snprintf(size, sizeof(size), "2^%u", e.sizeBucket);
+            fprintf(out, "%-16s %-10s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                OpName(e.op), size, static_cast<unsigned long long>(e.count),
+                e.mean / 1e3, e.p50 / 1e3, e.p90 / 1e3, e.p99 / 1e3, e.p999 / 1e3, e.max / 1e3);
+        }
+        return;
+    }
+
+    fprintf(out, "{\n  \"operations\": [");
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const MetricsEntry& e = entries[i];
+        unsigned long long lo = e.sizeBucket ? 1ull << e.sizeBucket : 0;
+        unsigned long long hi = (2ull << e.sizeBucket) - 1;
+        fprintf(out, "%s\n    { \"op\": \"%s\", \"sizeBucket\": %u, \"minVertices\": %llu, \"maxVertices\": %llu,\n",
+            i ? "," : "", OpName(e.op), e.sizeBucket, lo, hi);
+        fprintf(out, "      \"count\": %llu, \"latencyNs\": { \"mean\": %.1f, \"p50\": %llu, \"p90\": %llu, "
+            "\"p99\": %llu, \"p999\": %llu, \"max\": %llu } }",
+            static_cast<unsigned long long>(e.count), e.mean,
+            static_cast<unsigned long long>(e.p50), static_cast<unsigned long long>(e.p90),
+            static_cast<unsigned long long>(e.p99), static_cast<unsigned long long>(e.p999),
+            static_cast<unsigned long long>(e.max));
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+void MetricsRegistry::Dump(const std::string& path, MetricsFormat format) const
+{
+    std::vector<MetricsEntry> entries = Snapshot();
+
+    std::string temp = path + ".tmp";
+    FILE* f = fopen(temp.c_str(), "w");
+    if (!f)
+        throw std::runtime_error("MetricsRegistry: cannot write " + temp);
+    Write(entries, format, f);
+    bool failed = ferror(f) != 0;
+    failed |= fclose(f) != 0;
+    if (failed)
+    {
+        std::remove(temp.c_str());
+        throw std::runtime_error("MetricsRegistry: cannot write " + temp);
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename does not replace on Windows
+#endif
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("MetricsRegistry: cannot replace " + path);
+}
+
+void MetricsRegistry::StartPeriodicDump(const std::string& path, MetricsFormat format,
+    std::chrono::milliseconds interval)
+{
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    if (periodic)
+        periodic->Halt();
+
+    periodic = std::make_unique<PeriodicDump>();
+    PeriodicDump* p = periodic.get();
+    p->path = path;
+    p->format = format;
+    p->interval = interval;
+    p->worker = std::thread([this, p]
+        {
+            std::unique_lock<std::mutex> wait(p->mutex);
+            while (!p->wake.wait_for(wait, p->interval, [p] { return p->stop; }))
+            {
+                wait.unlock();
+                try
+                {
+                    Dump(p->path, p->format);
+                }
+                catch (const std::exception&)
+                {
+                    // Keep the schedule; the next interval tries again
+                }
+                wait.lock();
+            }
+        });
+}
+
+void MetricsRegistry::StopPeriodicDump()
+{
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    if (!periodic)
+        return;
+    periodic->Halt();
+    std::unique_ptr<PeriodicDump> last = std::move(periodic);
+    Dump(last->path, last->format);
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Process-wide latency histograms for GeometryCore calls.
+//
+// Every instrumented call is keyed by operation and by the log2 of its
+// input vertex count (bucket k holds inputs of 2^k .. 2^(k+1) - 1 vertices).
+// Samples go to per-thread shards with no locks or shared writes on the
+// recording path; snapshots merge the shards on demand. Histograms are
+// HDR-style: 32 linear sub-buckets per power of two, so any reported
+// percentile is within about 3% of the true latency.
+//
+// Recording is off until enabled per operation; a disabled call costs one
+// relaxed atomic load. Predicates are cheap enough that timing them
+// distorts the callers' numbers, so enable them only when you need them.
+
+enum class MetricOp
+{
+    GhCompute,            // PolygonUtilityExtension::Compute
+    ShBoolean,            // BooleanOps::ComputeBoolean
+    Clip,                 // Polygonutility::ClipPolygon
+    ClipOutside,          // Polygonutility::ClipPolygonOutside
+    PointInPolygon,       // Polygonutility::PointInPolygon
+    PolygonsOverlap,      // Polygonutility::PolygonsOverlap
+    IntersectionArea,     // BooleanOps::IntersectionArea
+    IoU,                  // BooleanOps::IoU
+    ConvexBatch,          // ConvexBatchClipper batches, sized by pair count
+    WindingOverlay,       // BooleanEngine on the winding-overlay engine
+    MinkowskiSum,         // MinkowskiOps::Sum
+    MinkowskiDifference,  // MinkowskiOps::Difference
+    Count
+};
+
+enum class MetricsFormat
+{
+    Text,
+    Json
+};
+
+// Single-writer histogram of nanosecond values; readers may load the
+// counters at any time
+class LatencyHistogram
+{
+public:
+    static constexpr int SubBucketBits = 5;
+    static constexpr int MaxValueBits = 44; // about 4.9 hours in ns; larger values are clamped
+    static constexpr size_t BucketCount = size_t(MaxValueBits - SubBucketBits + 1) << SubBucketBits;
+
+    void Record(uint64_t nanos);
+
+    static size_t BucketIndex(uint64_t nanos);
+    static uint64_t BucketLow(size_t index);
+    static uint64_t BucketHigh(size_t index); // inclusive
+
+    std::atomic<uint64_t> counts[BucketCount] = {};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> highest{ 0 };
+};
+
+// One (operation, size bucket) row of a snapshot; latencies in ns
+struct MetricsEntry
+{
+    MetricOp op;
+    unsigned sizeBucket;
+    uint64_t count;
+    double mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+class MetricsRegistry
+{
+public:
+    static constexpr unsigned SizeBuckets = 48;
+
+    // Never destroyed, so calls during static destruction stay safe
+    static MetricsRegistry& Instance();
+
+    static void Enable(MetricOp op, bool on = true);
+    static void EnableAll(bool on = true);
+    static bool Enabled(MetricOp op)
+    {
+        return (enabledMask.load(std::memory_order_relaxed) >> static_cast<unsigned>(op)) & 1u;
+    }
+
+    // Adds one sample to the calling thread's shard
+    void Record(MetricOp op, size_t vertices, uint64_t nanos);
+
+    // Merged over all threads, cumulative since start; rows without
+    // samples are left out
+    std::vector<MetricsEntry> Snapshot() const;
+
+    static void Write(const std::vector<MetricsEntry>& entries, MetricsFormat format, FILE* out);
+
+    // Writes a snapshot to path via a temporary file, so readers never see
+    // a partial dump. Throws std::runtime_error if the file cannot be written.
+    void Dump(const std::string& path, MetricsFormat format) const;
+
+    // Rewrites path every interval from a background thread, until
+    // StopPeriodicDump; starting again replaces the previous schedule
+    void StartPeriodicDump(const std::string& path, MetricsFormat format, std::chrono::milliseconds interval);
+    // Stops the schedule and writes a final dump; throws like Dump
+    void StopPeriodicDump();
+
+    static const char* OpName(MetricOp op);
+    static unsigned SizeBucket(size_t vertices);
+
+private:
+    struct Shard;
+    struct PeriodicDump;
+
+    MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Shard& LocalShard();
+
+    static std::atomic<uint32_t> enabledMask;
+
+    mutable std::mutex shardsMutex; // guards the list, never the samples
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    std::mutex dumpMutex;
+    std::unique_ptr<PeriodicDump> periodic;
+};
+
+// Times its own lifetime into the registry when op is enabled
+class ScopedLatency
+{
+public:
+    ScopedLatency(MetricOp op, size_t vertices)
+        : op(op), vertices(vertices), active(MetricsRegistry::Enabled(op))
+    {
+        if (active)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedLatency()
+    {
+        if (!active)
+            return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        MetricsRegistry::Instance().Record(op, vertices,
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    MetricOp op;
+    size_t vertices;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,21 @@
+#include "pch.h"
+#include "MinkowskiOps.h"
+#include "MetricsRegistry.h"
+#include "NativeRings.h"
+#include "../BooleanNative/Minkowski.h"
+
+std::vector<Polygon> MinkowskiOps::Sum(const PolygonView& A, const PolygonView& B)
+{
+    ScopedLatency latency(MetricOp::MinkowskiSum, A.Outer().size() + B.Outer().size());
+    if (A.Outer().size() < 3 || B.Outer().size() < 3)
+        return {};
+    return AssembleNativeRings(PolygonBoolean::Minkowski::sum(ToNativeRings(A), ToNativeRings(B)));
+}
+
+std::vector<Polygon> MinkowskiOps::Difference(const PolygonView& A, const PolygonView& B)
+{
+    ScopedLatency latency(MetricOp::MinkowskiDifference, A.Outer().size() + B.Outer().size());
+    if (A.Outer().size() < 3 || B.Outer().size() < 3)
+        return {};
+    return AssembleNativeRings(PolygonBoolean::Minkowski::difference(ToNativeRings(A), ToNativeRings(B)));
+}
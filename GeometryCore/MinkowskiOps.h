@@ -0,0 +1,16 @@
+#pragma once
+#include <vector>
+#include "Polygonutility.h"
+#include "GeometryViews.h"
+
+// Minkowski sum and difference of GeometryCore polygons (outer ring plus
+// holes), computed by the BooleanNative engine: O(n + m) edge merge for
+// convex inputs, convex pieces plus a union of partial sums otherwise.
+class MinkowskiOps
+{
+public:
+    std::vector<Polygon> Sum(const PolygonView& A, const PolygonView& B);
+
+    // A - B = A + (-B): the no-fit polygon of B's reference point around A
+    std::vector<Polygon> Difference(const PolygonView& A, const PolygonView& B);
+};
@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "NativeRings.h"
+#include "../BooleanNative/RingNesting.h"
+
+namespace
+{
+    using NativePoint = PolygonBoolean::Point;
+
+    Ring ToRing(const NativeRing& ring)
+    {
+        Ring r;
+        r.vertices.reserve(ring.size());
+        for (const NativePoint& p : ring)
+            r.vertices.push_back({ p.x, p.y });
+        return r;
+    }
+}
+
+std::vector<NativeRing> ToNativeRings(const PolygonView& poly)
+{
+    std::vector<NativeRing> rings;
+    rings.reserve(poly.RingCount());
+
+    for (size_t i = 0; i < poly.RingCount(); i++) {
+        RingView r = poly.RingAt(i);
+        NativeRing& ring = rings.emplace_back();
+        ring.reserve(r.size());
+        for (const Point& p : r)
+            ring.emplace_back(p.x, p.y);
+    }
+    return rings;
+}
+
+PolygonBoolean::RingSpan ToRingSpan(RingView ring)
+{
+    static_assert(sizeof(Point) == sizeof(NativePoint), "layouts match");
+    return PolygonBoolean::RingSpan(reinterpret_cast<const NativePoint*>(ring.Data()), ring.size(),
+        ring.IsReversed());
+}
+
+std::vector<Polygon> AssembleNativeRings(const std::vector<NativeRing>& rings)
+{
+    std::vector<std::vector<size_t>> groups =
+        PolygonBoolean::RingNesting::group(PolygonBoolean::RingSpan::of(rings));
+
+    std::vector<Polygon> result;
+    result.reserve(groups.size());
+    for (const auto& group : groups) {
+        Polygon& poly = result.emplace_back();
+        poly.outer = ToRing(rings[group[0]]);
+        poly.holes.reserve(group.size() - 1);
+        for (size_t i = 1; i < group.size(); i++)
+            poly.holes.push_back(ToRing(rings[group[i]]));
+    }
+    return result;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <vector>
+#include "Polygonutility.h"
+#include "GeometryViews.h"
+#include "../BooleanNative/Polygon.h"
+#include "../BooleanNative/RingSpan.h"
+
+// Glue between GeometryCore polygons and the BooleanNative engines.
+
+using NativeRing = std::vector<PolygonBoolean::Point>;
+
+// Copies of every ring, outer first
+std::vector<NativeRing> ToNativeRings(const PolygonView& poly);
+
+// The ring read in place, in the view's iteration order
+PolygonBoolean::RingSpan ToRingSpan(RingView ring);
+
+// Engine output as polygons with holes, nested by RingNesting
+std::vector<Polygon> AssembleNativeRings(const std::vector<NativeRing>& rings);
@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "PointWelder.h"
+#include <cmath>
+
+static const uint32_t NoPoint = 0xFFFFFFFFu;
+
+PointWelder::PointWelder(double tolerance)
+    : tolerance(tolerance), invCell(1.0 / tolerance)
+{
+}
+
+void PointWelder::Reserve(size_t count)
+{
+    points.reserve(count);
+    next.reserve(count);
+    cells.reserve(count);
+}
+
+void PointWelder::Clear()
+{
+    points.clear();
+    next.clear();
+    cells.clear();
+}
+
+int64_t PointWelder::CellOf(double v) const
+{
+    return static_cast<int64_t>(std::floor(v * invCell));
+}
+
+uint64_t PointWelder::Key(int64_t cx, int64_t cy)
+{
+    // Interleave-free mix; unordered_map rehashes the result anyway
+    uint64_t h = static_cast<uint64_t>(cx) * 0x9E3779B97F4A7C15ull;
+    h ^= static_cast<uint64_t>(cy) + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+size_t PointWelder::Find(const Point& p) const
+{
+    int64_t cx = CellOf(p.x);
+    int64_t cy = CellOf(p.y);
+
+    size_t best = npos;
+    for (int64_t dy = -1; dy <= 1; dy++)
+    {
+        for (int64_t dx = -1; dx <= 1; dx++)
+        {
+            auto it = cells.find(Key(cx + dx, cy + dy));
+            if (it == cells.end())
+                continue;
+
+            // Chains may mix cells on a key collision; the distance test settles it
+            for (uint32_t i = it->second; i != NoPoint; i = next[i])
+            {
+                const Point& q = points[i];
+                if (std::fabs(p.x - q.x) < tolerance && std::fabs(p.y - q.y) < tolerance)
+                {
+                    // Earliest representative wins, as in a linear scan
+                    if (best == npos || i < best)
+                        best = i;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+size_t PointWelder::Weld(const Point& p)
+{
+    size_t found = Find(p);
+    if (found != npos)
+        return found;
+
+    uint32_t index = static_cast<uint32_t>(points.size());
+    points.push_back(p);
+
+    auto result = cells.emplace(Key(CellOf(p.x), CellOf(p.y)), index);
+    next.push_back(result.second ? NoPoint : result.first->second);
+    result.first->second = index;
+
+    return index;
+}
+
+void PointWelder::Unique(std::vector<Point>& pts)
+{
+    Clear();
+    Reserve(pts.size());
+    for (const Point& p : pts)
+        Weld(p);
+    pts = points;
+}
+
+void PointWelder::Snap(std::vector<Point>& pts)
+{
+    Clear();
+    Reserve(pts.size());
+    for (Point& p : pts)
+        p = points[Weld(p)];
+}
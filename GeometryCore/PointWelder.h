@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Polygonutility.h"
+
+// Tolerance-aware point welding on a uniform hash grid.
+// Two points weld when |dx| < tolerance and |dy| < tolerance (the same
+// test as Polygonutility::SamePoint). The cell size equals the
+// tolerance, so only the 3x3 neighbourhood of a cell has to be checked
+// and points straddling a cell border still merge.
+class PointWelder
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit PointWelder(double tolerance = 1e-6);
+
+    void Reserve(size_t count);
+    void Clear();
+
+    // Representative index of p, inserting p as a new representative if none is close
+    size_t Weld(const Point& p);
+
+    // Representative index of p, or npos
+    size_t Find(const Point& p) const;
+
+    const std::vector<Point>& Points() const { return points; }
+
+    // Keep the first point of every cluster, preserving input order
+    void Unique(std::vector<Point>& pts);
+
+    // Replace every point by its representative (first occurrence wins)
+    void Snap(std::vector<Point>& pts);
+
+private:
+    int64_t CellOf(double v) const;
+    static uint64_t Key(int64_t cx, int64_t cy);
+
+    double tolerance;
+    double invCell;
+
+    std::vector<Point> points;     // representatives
+    std::vector<uint32_t> next;    // per-cell chains through points
+    std::unordered_map<uint64_t, uint32_t> cells; // cell → first point
+};
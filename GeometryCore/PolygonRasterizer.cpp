@@ -0,0 +1,316 @@
+#include "pch.h"
+#include "PolygonRasterizer.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <thread>
+
+PolygonRasterizer::PolygonRasterizer(FillRule rule, unsigned threads)
+    : rule(rule),
+    threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+RasterGrid PolygonRasterizer::GridForBounds(const std::vector<Polygon>& polys, int maxDimension)
+{
+    RasterGrid grid;
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for (const Polygon& poly : polys)
+    {
+        for (const Point& p : poly.outer.vertices)
+        {
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+        }
+    }
+    if (minX > maxX || maxDimension <= 0)
+        return grid;
+
+    double extent = std::max(maxX - minX, maxY - minY);
+    grid.originX = minX;
+    grid.originY = minY;
+    grid.pixelSize = extent > 0 ? extent / maxDimension : 1.0;
+    grid.width = std::max(1, (int)std::ceil((maxX - minX) / grid.pixelSize));
+    grid.height = std::max(1, (int)std::ceil((maxY - minY) / grid.pixelSize));
+    return grid;
+}
+
+// =====================================================
+// Edge table
+// =====================================================
+void PolygonRasterizer::BuildEdges(const std::vector<PolygonView>& polys, const RasterGrid& grid)
+{
+    TraceScope trace("raster.buildEdges", polys.size());
+    edges.clear();
+    double inv = 1.0 / grid.pixelSize;
+
+    auto addRing = [&](RingView pts, bool hole)
+        {
+            if (pts.size() < 3) return;
+
+            // Canonical orientation (outer CCW, holes CW) so non-zero
+            // filling treats holes as holes whatever the input winding
+            double area = 0.0;
+            for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+                area += pts[j].x * pts[i].y - pts[i].x * pts[j].y;
+            int sign = ((area >= 0) != hole) ? 1 : -1;
+
+            for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+            {
+                double x0 = (pts[j].x - grid.originX) * inv, y0 = (pts[j].y - grid.originY) * inv;
+                double x1 = (pts[i].x - grid.originX) * inv, y1 = (pts[i].y - grid.originY) * inv;
+                if (y0 == y1) continue;
+
+                Edge e;
+                int dir = y1 > y0 ? 1 : -1;
+                if (y0 > y1) { std::swap(x0, x1); std::swap(y0, y1); }
+                e.yTop = y0;
+                e.yBottom = y1;
+                e.x = x0;
+                e.dxdy = (x1 - x0) / (y1 - y0);
+                e.winding = dir * sign;
+                edges.push_back(e);
+            }
+        };
+
+    for (const PolygonView& poly : polys)
+    {
+        for (size_t r = 0; r < poly.RingCount(); r++)
+            addRing(poly.RingAt(r), r > 0);
+    }
+
+    std::sort(edges.begin(), edges.end(),
+        [](const Edge& a, const Edge& b) { return a.yTop < b.yTop; });
+}
+
+void PolygonRasterizer::CollectSpans(std::vector<const Edge*>& active, double y, std::vector<Span>& spans,
+    std::vector<std::pair<double, int>>& crossings) const
+{
+    crossings.clear();
+    for (const Edge* e : active)
+    {
+        if (y >= e->yTop && y < e->yBottom)
+            crossings.emplace_back(e->x + (y - e->yTop) * e->dxdy, e->winding);
+    }
+
+    // Nearly sorted from one scanline to the next: insertion sort
+    for (size_t i = 1; i < crossings.size(); i++)
+    {
+        auto c = crossings[i];
+        size_t j = i;
+        while (j > 0 && crossings[j - 1].first > c.first)
+        {
+            crossings[j] = crossings[j - 1];
+            j--;
+        }
+        crossings[j] = c;
+    }
+
+    spans.clear();
+    int winding = 0;
+    for (size_t i = 0; i + 1 < crossings.size(); i++)
+    {
+        winding += (rule == FillRule::NonZero) ? crossings[i].second : 1;
+        bool inside = (rule == FillRule::NonZero) ? winding != 0 : (winding & 1) != 0;
+        if (inside && crossings[i + 1].first > crossings[i].first)
+            spans.push_back({ crossings[i].first, crossings[i + 1].first });
+    }
+}
+
+// =====================================================
+// Tile scheduler: emitRow(row, spansPerSample, scratch)
+// =====================================================
+template <typename RowFn>
+void PolygonRasterizer::RunTiles(int height, int samplesPerRow, RowFn&& emitRow)
+{
+    int tileCount = (height + TileRows - 1) / TileRows;
+    TraceScope trace("raster.tiles", tileCount);
+
+    // Bucket each edge into every tile it touches (edges stay y-sorted)
+    tileEdges.assign(tileCount, {});
+    for (uint32_t i = 0; i < edges.size(); i++)
+    {
+        int t0 = std::max(0, (int)std::floor(edges[i].yTop) / TileRows);
+        int t1 = std::min(tileCount - 1, (int)std::floor(edges[i].yBottom) / TileRows);
+        for (int t = t0; t <= t1; t++)
+            tileEdges[t].push_back(i);
+    }
+
+    std::atomic<int> nextTile{ 0 };
+    auto worker = [&]()
+        {
+            std::vector<const Edge*> active;
+            std::vector<std::pair<double, int>> crossings;
+            std::vector<std::vector<Span>> rowSpans(samplesPerRow);
+
+            for (int t = nextTile++; t < tileCount; t = nextTile++)
+            {
+                const std::vector<uint32_t>& list = tileEdges[t];
+                TraceScope tileTrace("raster.tile", list.size());
+                size_t pending = 0;
+                active.clear();
+
+                int rowEnd = std::min(height, (t + 1) * TileRows);
+                for (int row = t * TileRows; row < rowEnd; row++)
+                {
+                    for (int s = 0; s < samplesPerRow; s++)
+                    {
+                        double y = row + (s + 0.5) / samplesPerRow;
+
+                        // Active edge table: admit by yTop, retire by yBottom
+                        while (pending < list.size() && edges[list[pending]].yTop <= y)
+                            active.push_back(&edges[list[pending++]]);
+                        active.erase(std::remove_if(active.begin(), active.end(),
+                            [y](const Edge* e) { return e->yBottom <= y; }), active.end());
+
+                        CollectSpans(active, y, rowSpans[s], crossings);
+                    }
+                    emitRow(row, rowSpans);
+                }
+            }
+        };
+
+    unsigned n = std::min<unsigned>(threadCount, std::max(1, tileCount));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < n; i++)
+        pool.emplace_back([&]()
+            {
+                if (TraceRecorder::Enabled())
+                    TraceRecorder::Instance().SetThreadName("raster worker");
+                worker();
+            });
+    worker();
+    for (auto& th : pool)
+        th.join();
+}
+
+// =====================================================
+// Coverage
+// =====================================================
+CoverageMask PolygonRasterizer::RasterizeCoverage(const PolygonView& poly, const RasterGrid& grid)
+{
+    return RasterizeCoverage(std::vector<PolygonView>{ poly }, grid);
+}
+
+CoverageMask PolygonRasterizer::RasterizeCoverage(const std::vector<Polygon>& polys, const RasterGrid& grid)
+{
+    return RasterizeCoverage(std::vector<PolygonView>(polys.begin(), polys.end()), grid);
+}
+
+CoverageMask PolygonRasterizer::RasterizeCoverage(const std::vector<PolygonView>& polys, const RasterGrid& grid)
+{
+    CoverageMask mask;
+    mask.width = grid.width;
+    mask.height = grid.height;
+    mask.coverage.assign((size_t)grid.width * grid.height, 0);
+    if (grid.width <= 0 || grid.height <= 0)
+        return mask;
+
+    BuildEdges(polys, grid);
+
+    const int W = grid.width;
+    RunTiles(grid.height, SubScanlines,
+        [&](int row, const std::vector<std::vector<Span>>& rowSpans)
+        {
+            // Exact horizontal coverage: partial end pixels directly,
+            // interior runs through a difference array
+            thread_local std::vector<float> partial, diff;
+            partial.assign(W, 0.0f);
+            diff.assign(W + 1, 0.0f);
+
+            const float w = 1.0f / SubScanlines;
+            for (const auto& spans : rowSpans)
+            {
+                for (const Span& s : spans)
+                {
+                    double x0 = std::max(0.0, s.x0);
+                    double x1 = std::min((double)W, s.x1);
+                    if (x1 <= x0) continue;
+
+                    int i0 = (int)x0;
+                    int i1 = std::min(W - 1, (int)x1);
+                    if (i0 == i1)
+                    {
+                        partial[i0] += (float)(x1 - x0) * w;
+                        continue;
+                    }
+                    partial[i0] += (float)(i0 + 1 - x0) * w;
+                    diff[i0 + 1] += w;
+                    diff[i1] -= w;
+                    partial[i1] += (float)(x1 - i1) * w;
+                }
+            }
+
+            uint8_t* out = &mask.coverage[(size_t)row * W];
+            float run = 0.0f;
+            for (int x = 0; x < W; x++)
+            {
+                run += diff[x];
+                float c = std::min(1.0f, run + partial[x]);
+                out[x] = (uint8_t)std::lround(c * 255.0f);
+            }
+        });
+
+    return mask;
+}
+
+// =====================================================
+// Bitsets (pixel-centre sampling)
+// =====================================================
+BitMask PolygonRasterizer::RasterizeBits(const PolygonView& poly, const RasterGrid& grid)
+{
+    return RasterizeBits(std::vector<PolygonView>{ poly }, grid);
+}
+
+BitMask PolygonRasterizer::RasterizeBits(const std::vector<Polygon>& polys, const RasterGrid& grid)
+{
+    return RasterizeBits(std::vector<PolygonView>(polys.begin(), polys.end()), grid);
+}
+
+BitMask PolygonRasterizer::RasterizeBits(const std::vector<PolygonView>& polys, const RasterGrid& grid)
+{
+    BitMask mask;
+    mask.width = grid.width;
+    mask.height = grid.height;
+    mask.wordsPerRow = ((size_t)std::max(0, grid.width) + 63) / 64;
+    mask.bits.assign(mask.wordsPerRow * std::max(0, grid.height), 0);
+    if (grid.width <= 0 || grid.height <= 0)
+        return mask;
+
+    BuildEdges(polys, grid);
+
+    const int W = grid.width;
+    RunTiles(grid.height, 1,
+        [&](int row, const std::vector<std::vector<Span>>& rowSpans)
+        {
+            uint64_t* words = &mask.bits[(size_t)row * mask.wordsPerRow];
+            for (const Span& s : rowSpans[0])
+            {
+                // Pixels whose centre x + 0.5 lies in [x0, x1)
+                int i0 = std::max(0, (int)std::ceil(s.x0 - 0.5));
+                int i1 = std::min(W, (int)std::ceil(s.x1 - 0.5));
+                for (int x = i0; x < i1; x++)
+                    words[x >> 6] |= uint64_t(1) << (x & 63);
+            }
+        });
+
+    return mask;
+}
+
+double PolygonRasterizer::CoverageArea(const CoverageMask& mask, const RasterGrid& grid)
+{
+    uint64_t sum = 0;
+    for (uint8_t c : mask.coverage)
+        sum += c;
+    return (double)sum / 255.0 * grid.pixelSize * grid.pixelSize;
+}
+
+double PolygonRasterizer::CoverageArea(const BitMask& mask, const RasterGrid& grid)
+{
+    uint64_t count = 0;
+    for (uint64_t w : mask.bits)
+        count += std::popcount(w);
+    return (double)count * grid.pixelSize * grid.pixelSize;
+}
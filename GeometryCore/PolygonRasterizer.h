@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Polygonutility.h"
+#include "GeometryViews.h"
+
+enum class FillRule
+{
+    EvenOdd,
+    NonZero
+};
+
+// Pixel grid in world coordinates. Row 0 starts at originY and rows grow
+// towards +y; pixels are square.
+struct RasterGrid
+{
+    double originX = 0.0;
+    double originY = 0.0;
+    double pixelSize = 1.0;
+    int width = 0;
+    int height = 0;
+};
+
+// 8-bit anti-aliased coverage, row-major (255 = fully covered)
+struct CoverageMask
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> coverage;
+};
+
+// 1 bit per pixel, sampled at pixel centres, rows padded to 64 bits
+struct BitMask
+{
+    int width = 0;
+    int height = 0;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+
+    bool Get(int x, int y) const
+    {
+        return (bits[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+    }
+};
+
+// Scanline rasterizer with a sorted active-edge table. Rows are split
+// into tiles that worker threads pick up independently.
+class PolygonRasterizer
+{
+public:
+    explicit PolygonRasterizer(FillRule rule = FillRule::NonZero, unsigned threads = 0);
+
+    static RasterGrid GridForBounds(const std::vector<Polygon>& polys, int maxDimension);
+
+    // Polygons are read in place, as Polygon or as views
+    CoverageMask RasterizeCoverage(const PolygonView& poly, const RasterGrid& grid);
+    CoverageMask RasterizeCoverage(const std::vector<Polygon>& polys, const RasterGrid& grid);
+    CoverageMask RasterizeCoverage(const std::vector<PolygonView>& polys, const RasterGrid& grid);
+
+    BitMask RasterizeBits(const PolygonView& poly, const RasterGrid& grid);
+    BitMask RasterizeBits(const std::vector<Polygon>& polys, const RasterGrid& grid);
+    BitMask RasterizeBits(const std::vector<PolygonView>& polys, const RasterGrid& grid);
+
+    // Raster estimate of the covered area, in world units
+    static double CoverageArea(const CoverageMask& mask, const RasterGrid& grid);
+    static double CoverageArea(const BitMask& mask, const RasterGrid& grid);
+
+private:
+    struct Edge
+    {
+        double yTop, yBottom; // yTop < yBottom, pixel space
+        double x;             // x at yTop
+        double dxdy;
+        int winding;
+    };
+
+    struct Span
+    {
+        double x0, x1;
+    };
+
+    static const int TileRows = 32;
+    static const int SubScanlines = 4;
+
+    void BuildEdges(const std::vector<PolygonView>& polys, const RasterGrid& grid);
+
+    template <typename RowFn>
+    void RunTiles(int height, int samplesPerRow, RowFn&& emitRow);
+
+    void CollectSpans(std::vector<const Edge*>& active, double y, std::vector<Span>& spans,
+        std::vector<std::pair<double, int>>& crossings) const;
+
+    FillRule rule;
+    unsigned threadCount;
+
+    std::vector<Edge> edges;                   // sorted by yTop
+    std::vector<std::vector<uint32_t>> tileEdges;
+};
@@ -1,7 +1,10 @@
 ﻿#include "pch.h"
 #include "PolygonUtilityExtension.h"
+#include "MetricsRegistry.h"
+#include "TraceRecorder.h"
 #include <cmath>
 #include <algorithm>
+#include <memory>
 
 static double EPS = 1e-9;
 
@@ -21,7 +24,7 @@ void Cleanup(Node* poly) {
 // =====================================================
 // Build circular doubly linked polygon
 // =====================================================
-Node* PolygonUtilityExtension::BuildPolygon(const std::vector<Point>& pts)
+Node* PolygonUtilityExtension::BuildPolygon(RingView pts)
 {
     if (pts.empty()) return nullptr;
     Node* first = nullptr;
@@ -92,8 +95,12 @@ bool PolygonUtilityExtension::SegmentIntersect(
 // =====================================================
 // Find all intersections
 // =====================================================
-void PolygonUtilityExtension::FindIntersections(Node* A, Node* B)
+void PolygonUtilityExtension::FindIntersections(Node* A, Node* B, BooleanStats* stats)
 {
+    // Counted locally and added once, to keep the inner loop free of stats
+    uint64_t tests = 0;
+    uint64_t found = 0;
+
     Node* a = A;
     do {
         Node* aNext = a->next;
@@ -107,8 +114,10 @@ void PolygonUtilityExtension::FindIntersections(Node* A, Node* B)
 
             Point ip;
             double ta, tb;
+            tests++;
             if (SegmentIntersect(a->p, aNext->p, b->p, bNext->p, ip, ta, tb))
             {
+                found++;
                 Node* na = new Node();
                 na->p = ip; na->isIntersection = true; na->alpha = ta;
 
@@ -125,9 +134,16 @@ void PolygonUtilityExtension::FindIntersections(Node* A, Node* B)
         } while (b != B);
         a = aNext;
     } while (a != A);
+
+    if (stats)
+    {
+        stats->segmentTests += tests;
+        stats->intersections += found;
+        stats->allocations += 2 * found;
+    }
 }
 
-bool PolygonUtilityExtension::PointInsidePolygon(const std::vector<Point>& poly, const Point& p)
+bool PolygonUtilityExtension::PointInsidePolygon(RingView poly, const Point& p)
 {
     if (poly.empty()) return false;
 
@@ -149,7 +165,7 @@ bool PolygonUtilityExtension::PointInsidePolygon(const std::vector<Point>& poly,
 // =====================================================
 // Entry / Exit marking (Fixed Toggle Logic)
 // =====================================================
-void PolygonUtilityExtension::MarkEntryExit(Node* poly, const std::vector<Point>& other, GHOp op, bool isA)
+void PolygonUtilityExtension::MarkEntryExit(Node* poly, RingView other, GHOp op, bool isA)
 {
     Node* startNode = poly;
     while (startNode->isIntersection) startNode = startNode->next;
@@ -179,9 +195,9 @@ void PolygonUtilityExtension::MarkEntryExit(Node* poly, const std::vector<Point>
 // =====================================================
 // Trace output polygon (With Direction switching)
 // =====================================================
-std::vector<Point> PolygonUtilityExtension::TraceResult(Node* start, GHOp op, bool startOnA)
+void PolygonUtilityExtension::TraceResult(Node* start, GHOp op, bool startOnA, std::vector<Point>& result)
 {
-    std::vector<Point> result;
+    result.clear();
     Node* cur = start;
     bool onPolyA = startOnA;
     bool forward = true; // Default direction
@@ -214,7 +230,6 @@ std::vector<Point> PolygonUtilityExtension::TraceResult(Node* start, GHOp op, bo
         cur = forward ? cur->next : cur->prev;
         if (cur == start) break;
     }
-    return result;
 }
 
 // =====================================================
@@ -236,63 +251,149 @@ void PolygonUtilityExtension::EnsureCCW(std::vector<Point>& pts) {
 // FIXED COMPUTE FOR INTERSECTION
 // =====================================================
 std::vector<std::vector<Point>> PolygonUtilityExtension::Compute(
-    const std::vector<Point>& Apts,
-    const std::vector<Point>& Bpts,
-    GHOp operation)
+    RingView Apts,
+    RingView Bpts,
+    GHOp operation,
+    BooleanStats* stats)
 {
-    // Winding order  
-    std::vector<Point> A_fixed = Apts;
-    std::vector<Point> B_fixed = Bpts;
-    EnsureCCW(A_fixed);
-    EnsureCCW(B_fixed);
+    std::vector<std::vector<Point>> result;
+    Compute(Apts, Bpts, operation, [&](RingView loop) {
+        result.emplace_back(loop.begin(), loop.end());
+    }, stats);
+    if (stats)
+        stats->allocations += result.size();
+    return result;
+}
+
+size_t PolygonUtilityExtension::Compute(
+    RingView Apts,
+    RingView Bpts,
+    GHOp operation,
+    const RingSink& sink,
+    BooleanStats* stats)
+{
+    ScopedLatency latency(MetricOp::GhCompute, Apts.size() + Bpts.size());
+    TraceScope trace("gh.compute", Apts.size() + Bpts.size());
+    if (stats)
+        stats->calls++;
+
+    // A ring under 3 vertices bounds nothing (and BuildPolygon has no node
+    // for an empty one): the answer is the other ring or nothing
+    if (Apts.size() < 3 || Bpts.size() < 3)
+    {
+        bool validA = Apts.size() >= 3;
+        bool validB = Bpts.size() >= 3;
+        RingView kept;
+        if (operation == GHOp::Union)
+            kept = validA ? Apts : validB ? Bpts : RingView();
+        else if (operation == GHOp::DifferenceAB && validA)
+            kept = Apts;
+        else if (operation == GHOp::DifferenceBA && validB)
+            kept = Bpts;
+        if (kept.empty())
+            return 0;
+
+        sink(kept.CCW());
+        if (stats)
+        {
+            stats->outputRings++;
+            stats->outputVertices += kept.size();
+        }
+        return 1;
+    }
+
+    // Winding order: flip the view, not the data
+    RingView A_fixed, B_fixed;
+    {
+        PhaseTimer timer(stats, BooleanStats::Normalize);
+        A_fixed = Apts.CCW();
+        B_fixed = Bpts.CCW();
+    }
 
-    Node* A = BuildPolygon(A_fixed);
-    Node* B = BuildPolygon(B_fixed);
+    // Owned until the end, so a throwing sink does not leak the rings
+    using NodeRing = std::unique_ptr<Node, decltype(&Cleanup)>;
+    NodeRing ownA(nullptr, &Cleanup);
+    NodeRing ownB(nullptr, &Cleanup);
+    {
+        PhaseTimer timer(stats, BooleanStats::BuildNodes);
+        TraceScope phase("gh.buildNodes");
+        ownA.reset(BuildPolygon(A_fixed));
+        ownB.reset(BuildPolygon(B_fixed));
+    }
+    Node* A = ownA.get();
+    Node* B = ownB.get();
+    if (stats)
+        stats->allocations += A_fixed.size() + B_fixed.size();
 
     // Find and Insert Intersections (Sorted by Alpha)
-    FindIntersections(A, B);
+    {
+        PhaseTimer timer(stats, BooleanStats::FindIntersections);
+        TraceScope phase("gh.findIntersections");
+        FindIntersections(A, B, stats);
+    }
 
     // Mark Entry/Exit 
-    MarkEntryExit(A, B_fixed, operation, true);
-    MarkEntryExit(B, A_fixed, operation, false);
+    {
+        PhaseTimer timer(stats, BooleanStats::MarkEntryExit);
+        TraceScope phase("gh.markEntryExit");
+        MarkEntryExit(A, B_fixed, operation, true);
+        MarkEntryExit(B, A_fixed, operation, false);
+
+        // Reset Visited Flags
+        auto ResetVisited = [](Node* poly) {
+            if (!poly) return;
+            Node* n = poly;
+            do {
+                n->visited = false;
+                n = n->next;
+            } while (n != poly);
+            };
+        ResetVisited(A);
+        ResetVisited(B);
+    }
 
-    // Reset Visited Flags
-    auto ResetVisited = [](Node* poly) {
-        if (!poly) return;
-        Node* n = poly;
-        do {
-            n->visited = false;
-            n = n->next;
-        } while (n != poly);
-        };
-    ResetVisited(A);
-    ResetVisited(B);
+    size_t emitted = 0;
+    {
+        PhaseTimer timer(stats, BooleanStats::Trace);
+        TraceScope phase("gh.trace");
 
-    std::vector<std::vector<Point>> result;
+        // 5. Choose start polygon
+        Node* startPoly = (operation == GHOp::DifferenceBA) ? B : A;
+        bool startOnA = (operation != GHOp::DifferenceBA);
 
-    // 5. Choose start polygon
-    Node* startPoly = (operation == GHOp::DifferenceBA) ? B : A;
-    bool startOnA = (operation != GHOp::DifferenceBA);
+        // 6. Traversal: one scratch buffer for every loop, handed to the
+        // sink as soon as the loop closes
+        std::vector<Point> loop;
+        Node* n = startPoly;
+        do {
+            if (n->isIntersection && !n->visited && n->entry)
+            {
+                TraceResult(n, operation, startOnA, loop);
+                if (loop.size() >= 3)
+                {
+                    sink(RingView(loop));
+                    emitted++;
+                    if (stats)
+                    {
+                        stats->outputRings++;
+                        stats->outputVertices += loop.size();
+                    }
+                }
+            }
+            n = n->next;
+        } while (n != startPoly);
 
-    // 6. Traversal
-    // 
-    Node* n = startPoly;
-    do {
-        if (n->isIntersection && !n->visited && n->entry)
-        {
-            auto loop = TraceResult(n, operation, startOnA);
-            if (loop.size() >= 3)
-                result.push_back(loop);
+        // 0Fallback for no intersections
+        if (emitted == 0) {
+            bool A_in_B = PointInsidePolygon(B_fixed, A_fixed[0]);
+            bool B_in_A = PointInsidePolygon(A_fixed, B_fixed[0]);
+            // ... (standard fallback logic)
         }
-        n = n->next;
-    } while (n != startPoly);
-
-    // 0Fallback for no intersections
-    if (result.empty()) {
-        bool A_in_B = PointInsidePolygon(B_fixed, A_fixed[0]);
-        bool B_in_A = PointInsidePolygon(A_fixed, B_fixed[0]);
-        // ... (standard fallback logic)
     }
 
-    return result;
+    PhaseTimer timer(stats, BooleanStats::Cleanup);
+    TraceScope phase("gh.cleanup");
+    ownA.reset();
+    ownB.reset();
+    return emitted;
 }
\ No newline at end of file
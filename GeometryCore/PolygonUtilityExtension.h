@@ -1,6 +1,13 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include "Polygonutility.h"
+#include "GeometryViews.h"
+#include "BooleanStats.h"
+
+// Receives finished result rings one at a time. The view points into a
+// scratch buffer that is reused for the next ring, so copy what you keep.
+using RingSink = std::function<void(RingView)>;
 
 
 enum class GHOp
@@ -28,25 +35,39 @@ class PolygonUtilityExtension
 {
 public:
     void EnsureCCW(std::vector<Point>& pts);
-    std::vector<std::vector<Point>> Compute(
-        const std::vector<Point>& A,
-        const std::vector<Point>& B,
-        GHOp operation);
 
-private:
-    // Core steps
-    Node* BuildPolygon(const std::vector<Point>& pts);
-    void InsertInOrder(Node* startNode, Node* newNode);
-    void FindIntersections(Node* A, Node* B);
+    // Inputs are read in place; clockwise rings are walked in reverse
+    // rather than copied and reordered. When stats is set, per-phase
+    // times and counters are added to it.
+    std::vector<std::vector<Point>> Compute(
+        RingView A,
+        RingView B,
+        GHOp operation,
+        BooleanStats* stats = nullptr);
 
-    void MarkEntryExit(Node* poly, const std::vector<Point>& other, GHOp op, bool isA);
-    std::vector<Point> TraceResult(Node* start, GHOp op, bool startOnA);
+    // Same, but each ring goes to the sink as soon as it is traced instead
+    // of being collected; returns the number of rings emitted
+    size_t Compute(
+        RingView A,
+        RingView B,
+        GHOp operation,
+        const RingSink& sink,
+        BooleanStats* stats = nullptr);
 
-    // Geometry helpers
+    // Geometry helpers; public so GeometryBench can time them in isolation
     bool SegmentIntersect(
         const Point& p1, const Point& p2,
         const Point& q1, const Point& q2,
         Point& ip, double& alphaP, double& alphaQ);
 
-    bool PointInsidePolygon(const std::vector<Point>& poly, const Point& p);
+    bool PointInsidePolygon(RingView poly, const Point& p);
+
+private:
+    // Core steps
+    Node* BuildPolygon(RingView pts);
+    void InsertInOrder(Node* startNode, Node* newNode);
+    void FindIntersections(Node* A, Node* B, BooleanStats* stats);
+
+    void MarkEntryExit(Node* poly, RingView other, GHOp op, bool isA);
+    void TraceResult(Node* start, GHOp op, bool startOnA, std::vector<Point>& result);
 };
@@ -1,16 +1,25 @@
 ﻿#include "pch.h"
 #include "Polygonutility.h"
+#include "GeometryViews.h"
+#include "PointWelder.h"
+#include "MetricsRegistry.h"
+#include "TraceRecorder.h"
 #include <cmath>
 #include <algorithm>
 
 bool Polygonutility::PointInRing(const Point& p, const Ring& r)
+{
+	return PointInRing(p, RingView(r));
+}
+
+bool Polygonutility::PointInRing(const Point& p, const RingView& r)
 {
 	bool inside = false;
-	int n = r.vertices.size();
+	int n = r.size();
 
 	for (int i = 0, j = n - 1; i < n; j = i++) {
-		auto& a = r.vertices[i];
-		auto& b = r.vertices[j];
+		auto& a = r[i];
+		auto& b = r[j];
 
 		if ((a.y > p.y) != (b.y > p.y)) {
 			double x = (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x;
@@ -23,14 +32,21 @@ bool Polygonutility::PointInRing(const Point& p, const Ring& r)
 
 bool Polygonutility::PointInPolygon(const Point& p, const Polygon& poly)
 {
+	return PointInPolygon(p, PolygonView(poly));
+}
+
+bool Polygonutility::PointInPolygon(const Point& p, const PolygonView& poly)
+{
+	ScopedLatency latency(MetricOp::PointInPolygon, poly.Outer().size());
+
 	//  Outside outer boundary → NOT inside polygon
-	if (!PointInRing(p, poly.outer))
+	if (!PointInRing(p, poly.Outer()))
 		return false;
 
 	//  Inside any hole → NOT inside polygon
-	for (const Ring& hole : poly.holes)
+	for (size_t i = 0; i < poly.HoleCount(); i++)
 	{
-		if (PointInRing(p, hole))
+		if (PointInRing(p, poly.Hole(i)))
 			return false;
 	}
 
@@ -69,19 +85,26 @@ bool Polygonutility::SegmentIntersect(const Point& p1, const Point& p2,
 
 bool Polygonutility::PolygonsOverlap(const Polygon& A, const Polygon& B)
 {
+	return PolygonsOverlap(PolygonView(A), PolygonView(B));
+}
+
+bool Polygonutility::PolygonsOverlap(const PolygonView& A, const PolygonView& B)
+{
+	ScopedLatency latency(MetricOp::PolygonsOverlap, A.Outer().size() + B.Outer().size());
+
 	//  Any vertex of A inside B
-	for (const Point& p : A.outer.vertices)
+	for (const Point& p : A.Outer())
 		if (PointInPolygon(p, B))
 			return true;
 
 	//  Any vertex of B inside A
-	for (const Point& p : B.outer.vertices)
+	for (const Point& p : B.Outer())
 		if (PointInPolygon(p, A))
 			return true;
 
 	//  Edge-edge intersection (MISSING PART)
-	const auto& aV = A.outer.vertices;
-	const auto& bV = B.outer.vertices;
+	RingView aV = A.Outer();
+	RingView bV = B.Outer();
 
 	for (size_t i = 0; i < aV.size(); i++)
 	{
@@ -151,22 +174,121 @@ bool Polygonutility::SamePoint(const Point& a, const Point& b)
 
 void Polygonutility::RemoveDuplicates(std::vector<Point>& pts)
 {
-	std::vector<Point> unique;
-	for (const Point& p : pts)
+	// Same tolerance as SamePoint, expected O(n) via the hash grid
+	PointWelder welder(1e-6);
+	welder.Unique(pts);
+}
+
+static bool Collinear(const Point& a, const Point& b, const Point& c)
+{
+	double abx = b.x - a.x, aby = b.y - a.y;
+	double bcx = c.x - b.x, bcy = c.y - b.y;
+	double cross = abx * bcy - aby * bcx;
+	double dot = abx * bcx + aby * bcy;
+	double scale = std::sqrt((abx * abx + aby * aby) * (bcx * bcx + bcy * bcy));
+
+	// Straight-through only: spikes (dot < 0) are left alone
+	return dot > 0 && std::fabs(cross) <= 1e-9 * scale;
+}
+
+void Polygonutility::RemoveRedundantVertices(std::vector<Point>& ring)
+{
+	if (ring.size() < 3)
+		return;
+
+	std::vector<Point> out;
+	out.reserve(ring.size());
+
+	for (const Point& p : ring)
+	{
+		if (!out.empty() && SamePoint(out.back(), p))
+			continue;
+		while (out.size() >= 2 && Collinear(out[out.size() - 2], out.back(), p))
+			out.pop_back();
+		out.push_back(p);
+	}
+
+	// Close the loop: the seam may still hold a duplicate or collinear vertex
+	size_t start = 0;
+	while (out.size() - start >= 3)
+	{
+		if (SamePoint(out.back(), out[start]))
+			out.pop_back();
+		else if (Collinear(out[out.size() - 2], out.back(), out[start]))
+			out.pop_back();
+		else if (Collinear(out.back(), out[start], out[start + 1]))
+			start++;
+		else
+			break;
+	}
+	out.erase(out.begin(), out.begin() + start);
+
+	if (out.size() >= 3)
+		ring.swap(out);
+}
+
+static double SegmentDistance(const Point& p, const Point& a, const Point& b)
+{
+	double dx = b.x - a.x, dy = b.y - a.y;
+	double len2 = dx * dx + dy * dy;
+	double t = len2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+	t = std::max(0.0, std::min(1.0, t));
+	double ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+	return std::sqrt(ex * ex + ey * ey);
+}
+
+void Polygonutility::SimplifyRing(std::vector<Point>& ring, double tolerance)
+{
+	size_t n = ring.size();
+	if (n < 4 || tolerance <= 0)
+		return;
+
+	// Split the closed ring at vertex 0 and the vertex farthest from it
+	size_t far = 0;
+	double farDist = -1;
+	for (size_t i = 1; i < n; i++)
+	{
+		double dx = ring[i].x - ring[0].x, dy = ring[i].y - ring[0].y;
+		double d = dx * dx + dy * dy;
+		if (d > farDist) { farDist = d; far = i; }
+	}
+
+	std::vector<char> keep(n, 0);
+	keep[0] = keep[far] = 1;
+
+	// Index n stands for vertex 0 closing the ring
+	std::vector<std::pair<size_t, size_t>> stack = { { 0, far }, { far, n } };
+	while (!stack.empty())
 	{
-		bool found = false;
-		for (const Point& u : unique)
+		auto [first, last] = stack.back();
+		stack.pop_back();
+
+		const Point& a = ring[first];
+		const Point& b = ring[last % n];
+		double maxDist = 0;
+		size_t index = 0;
+		for (size_t i = first + 1; i < last; i++)
 		{
-			if (SamePoint(p, u))
-			{
-				found = true;
-				break;
-			}
+			double d = SegmentDistance(ring[i], a, b);
+			if (d > maxDist) { maxDist = d; index = i; }
+		}
+
+		if (maxDist > tolerance)
+		{
+			keep[index] = 1;
+			stack.push_back({ first, index });
+			stack.push_back({ index, last });
 		}
-		if (!found)
-			unique.push_back(p);
 	}
-	pts = unique;
+
+	std::vector<Point> out;
+	for (size_t i = 0; i < n; i++)
+		if (keep[i])
+			out.push_back(ring[i]);
+
+	// Rings thinner than the tolerance keep their original shape
+	if (out.size() >= 3)
+		ring.swap(out);
 }
 
 Point Polygonutility::ComputeCentroid(const std::vector<Point>& pts)
@@ -195,23 +317,6 @@ void Polygonutility::SortCCW(std::vector<Point>& pts)
 		});
 }
 
-double SignedArea(const std::vector<Point>& pts)
-{
-	double area = 0.0;
-	for (size_t i = 0; i < pts.size(); i++)
-	{
-		const Point& p = pts[i];
-		const Point& q = pts[(i + 1) % pts.size()];
-		area += (p.x * q.y - q.x * p.y);
-	}
-	return area * 0.5;
-}
-
-bool IsCCW(const std::vector<Point>& pts)
-{
-	return SignedArea(pts) > 0;
-}
-
 bool Polygonutility::Inside(const Point& p, const Point& a, const Point& b, bool clipCCW)
 {
 	double cross =
@@ -225,9 +330,16 @@ bool Polygonutility::Inside(const Point& p, const Point& a, const Point& b, bool
 
 std::vector<Point> Polygonutility::ClipPolygon(const std::vector<Point>& subject, const std::vector<Point>& clip, Polygonutility& util)
 {
-	std::vector<Point> output = subject;
+	return ClipPolygon(RingView(subject), RingView(clip), util);
+}
+
+std::vector<Point> Polygonutility::ClipPolygon(const RingView& subject, const RingView& clip, Polygonutility& util)
+{
+	ScopedLatency latency(MetricOp::Clip, subject.size() + clip.size());
+	TraceScope trace("clip", subject.size() + clip.size());
+	std::vector<Point> output(subject.begin(), subject.end());
 
-	bool clipCCW = IsCCW(clip);
+	bool clipCCW = clip.SignedArea() > 0;
 
 	for (size_t i = 0; i < clip.size(); i++)
 	{
@@ -272,8 +384,15 @@ std::vector<Point> Polygonutility::ClipPolygon(const std::vector<Point>& subject
 
 std::vector<Point> Polygonutility::ClipPolygonOutside(const std::vector<Point>& subject, const std::vector<Point>& clip, Polygonutility& util)
 {
-	std::vector<Point> output = subject;
-	bool clipCCW = IsCCW(clip);
+	return ClipPolygonOutside(RingView(subject), RingView(clip), util);
+}
+
+std::vector<Point> Polygonutility::ClipPolygonOutside(const RingView& subject, const RingView& clip, Polygonutility& util)
+{
+	ScopedLatency latency(MetricOp::ClipOutside, subject.size() + clip.size());
+	TraceScope trace("clip.outside", subject.size() + clip.size());
+	std::vector<Point> output(subject.begin(), subject.end());
+	bool clipCCW = clip.SignedArea() > 0;
 
 	for (size_t i = 0; i < clip.size(); i++)
 	{
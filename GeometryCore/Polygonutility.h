@@ -14,12 +14,17 @@ struct Polygon {
 	std::vector<Ring> holes;
 };
 
+class RingView;    // GeometryViews.h
+class PolygonView;
+
 class Polygonutility
 {
 public:
 	bool PointInRing(const Point& p, const Ring& r);
+	bool PointInRing(const Point& p, const RingView& r);
 
 	bool PointInPolygon(const Point& p, const Polygon& poly);
+	bool PointInPolygon(const Point& p, const PolygonView& poly);
 
 	bool OnSegment(const Point& a, const Point& b, const Point& p);
 
@@ -31,6 +36,9 @@ public:
 	bool PolygonsOverlap(
 		const Polygon& A,
 		const Polygon& B);
+	bool PolygonsOverlap(
+		const PolygonView& A,
+		const PolygonView& B);
 
 	void CollectIntersectionPoints(
 		const Polygon& A,
@@ -41,6 +49,12 @@ public:
 
 	void RemoveDuplicates(std::vector<Point>& pts);
 
+	// Drop repeated and straight-through collinear vertices of a closed ring (linear time)
+	void RemoveRedundantVertices(std::vector<Point>& ring);
+
+	// Douglas–Peucker on a closed ring; no vertex moves more than tolerance
+	void SimplifyRing(std::vector<Point>& ring, double tolerance);
+
 	Point ComputeCentroid(const std::vector<Point>& pts);
 
 	void SortCCW(std::vector<Point>& pts);
@@ -51,9 +65,17 @@ public:
 		const std::vector<Point>& subject,
 		const std::vector<Point>& clip,
 		Polygonutility& util);
+	std::vector<Point> ClipPolygon(
+		const RingView& subject,
+		const RingView& clip,
+		Polygonutility& util);
 
 	std::vector<Point> ClipPolygonOutside(
 		const std::vector<Point>& subject,
 		const std::vector<Point>& clip,
 		Polygonutility& util);
+	std::vector<Point> ClipPolygonOutside(
+		const RingView& subject,
+		const RingView& clip,
+		Polygonutility& util);
 };
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "TraceRecorder.h"
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+    int64_t SteadyNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void WriteString(FILE* f, const std::string& s)
+    {
+        fputc('"', f);
+        for (unsigned char c : s)
+        {
+            if (c == '"' || c == '\\')
+                fprintf(f, "\\%c", c);
+            else if (c < 0x20)
+                fprintf(f, "\\u%04x", c);
+            else
+                fputc(c, f);
+        }
+        fputc('"', f);
+    }
+}
+
+std::atomic<bool> TraceRecorder::recording{ false };
+
+TraceRecorder::TraceRecorder() = default;
+
+TraceRecorder& TraceRecorder::Instance()
+{
+    static TraceRecorder* instance = new TraceRecorder();
+    return *instance;
+}
+
+void TraceRecorder::Start(size_t maxEventsPerThread)
+{
+    int64_t unset = 0;
+    epoch.compare_exchange_strong(unset, SteadyNs());
+    maxEvents.store(maxEventsPerThread, std::memory_order_relaxed);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Stop()
+{
+    recording.store(false, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Clear()
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+    epoch.store(recording.load() ? SteadyNs() : 0);
+}
+
+uint64_t TraceRecorder::Now() const
+{
+    int64_t ns = SteadyNs() - epoch.load(std::memory_order_relaxed);
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+}
+
+// Buffers are kept after their thread exits: the events still belong in
+// the trace, and a new thread should get a track of its own
+TraceRecorder::ThreadBuffer& TraceRecorder::LocalBuffer()
+{
+    thread_local ThreadBuffer* local = nullptr;
+    if (local)
+        return *local;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.push_back(std::make_unique<ThreadBuffer>());
+    local = buffers.back().get();
+    local->tid = static_cast<unsigned>(buffers.size());
+    local->name = "thread " + std::to_string(local->tid);
+    return *local;
+}
+
+void TraceRecorder::SetThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void TraceRecorder::Record(const char* name, uint64_t startNs, uint64_t endNs, uint64_t size)
+{
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() >= maxEvents.load(std::memory_order_relaxed))
+    {
+        buffer.dropped++;
+        return;
+    }
+    buffer.events.push_back({ name, startNs, endNs > startNs ? endNs - startNs : 0, size });
+}
+
+void TraceRecorder::Write(const std::string& path) const
+{
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f)
+        throw std::runtime_error("TraceRecorder: cannot write " + path);
+
+    // Timestamps are in microseconds; three decimals keep the ns resolution
+    size_t dropped = 0;
+    bool first = true;
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            dropped += buffer->dropped;
+
+            fprintf(f, "%s\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+                first ? "" : ",", buffer->tid);
+            WriteString(f, buffer->name);
+            fprintf(f, "}}");
+            first = false;
+
+            for (const Event& e : buffer->events)
+            {
+                fprintf(f, ",\n{\"ph\":\"X\",\"cat\":\"geometry\",\"pid\":1,\"tid\":%u,\"name\":", buffer->tid);
+                WriteString(f, e.name);
+                fprintf(f, ",\"ts\":%.3f,\"dur\":%.3f", e.startNs / 1e3, e.durationNs / 1e3);
+                if (e.size)
+                    fprintf(f, ",\"args\":{\"size\":%llu}", static_cast<unsigned long long>(e.size));
+                fprintf(f, "}");
+            }
+        }
+    }
+    fprintf(f, "\n],\"otherData\":{\"droppedEvents\":%zu}}\n", dropped);
+
+    bool failed = ferror(f) != 0;
+    failed |= fclose(f) != 0;
+    if (failed)
+        throw std::runtime_error("TraceRecorder: cannot write " + path);
+}
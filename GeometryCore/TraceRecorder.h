@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline of engine phases in the Chrome Trace Event format, for
+// chrome://tracing or ui.perfetto.dev.
+//
+// TraceScope marks a region as one complete ("X") event with its thread,
+// name and input size. Each thread appends to its own buffer, so threads
+// never contend with each other; a buffer's lock is only ever contended
+// by Write or Clear.
+// While the recorder is stopped a scope costs one relaxed atomic load.
+//
+// Event names must be string literals (or otherwise outlive the recorder):
+// only the pointer is stored.
+
+class TraceRecorder
+{
+public:
+    static constexpr size_t DefaultMaxEvents = size_t(1) << 20; // per thread, 32 MB
+
+    // Never destroyed, so scopes during static destruction stay safe
+    static TraceRecorder& Instance();
+
+    static bool Enabled() { return recording.load(std::memory_order_relaxed); }
+
+    // Timestamps count from the first Start after a Clear. A thread's
+    // events past maxEventsPerThread are dropped and counted in the output.
+    void Start(size_t maxEventsPerThread = DefaultMaxEvents);
+    void Stop();
+    void Clear();
+
+    // Label for the calling thread's track
+    void SetThreadName(const std::string& name);
+
+    void Record(const char* name, uint64_t startNs, uint64_t endNs, uint64_t size);
+    uint64_t Now() const; // ns since the trace epoch
+
+    // Writes all buffered events; throws std::runtime_error if the file
+    // cannot be written
+    void Write(const std::string& path) const;
+
+private:
+    struct Event
+    {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint64_t size;
+    };
+
+    struct ThreadBuffer
+    {
+        mutable std::mutex mutex;
+        unsigned tid;
+        std::string name;
+        std::vector<Event> events;
+        size_t dropped = 0;
+    };
+
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    ThreadBuffer& LocalBuffer();
+
+    static std::atomic<bool> recording;
+
+    std::atomic<int64_t> epoch{ 0 }; // steady_clock ns at the first Start
+    std::atomic<size_t> maxEvents{ DefaultMaxEvents };
+
+    mutable std::mutex buffersMutex; // guards the list, never the events
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+// One trace event covering the scope's lifetime; size is the input size
+// shown in the event's args (vertices, edges, rows), 0 to omit
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, uint64_t size = 0)
+        : name(name), size(size), active(TraceRecorder::Enabled())
+    {
+        if (active)
+            start = TraceRecorder::Instance().Now();
+    }
+
+    ~TraceScope()
+    {
+        if (active)
+        {
+            TraceRecorder& recorder = TraceRecorder::Instance();
+            recorder.Record(name, start, recorder.Now(), size);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t size;
+    bool active;
+    uint64_t start = 0;
+};
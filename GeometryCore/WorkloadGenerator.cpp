@@ -0,0 +1,291 @@
+#include "pch.h"
+#include "WorkloadGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+
+    Polygon Square(double x, double y, double side, bool clockwise)
+    {
+        Polygon poly;
+        poly.outer.vertices = { { x, y }, { x + side, y }, { x + side, y + side }, { x, y + side } };
+        if (clockwise)
+            std::reverse(poly.outer.vertices.begin(), poly.outer.vertices.end());
+        return poly;
+    }
+
+    size_t GridSide(size_t cells)
+    {
+        size_t k = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(cells))));
+        return std::max<size_t>(k, 1);
+    }
+
+    size_t Count(const std::vector<Polygon>& polys)
+    {
+        size_t n = 0;
+        for (const Polygon& p : polys)
+        {
+            n += p.outer.vertices.size();
+            for (const Ring& h : p.holes)
+                n += h.vertices.size();
+        }
+        return n;
+    }
+}
+
+size_t Workload::PairCount() const
+{
+    if (a.empty() || b.empty())
+        return 0;
+    return std::max(a.size(), b.size());
+}
+
+size_t Workload::VertexCount() const
+{
+    return Count(a) + Count(b);
+}
+
+WorkloadGenerator::WorkloadGenerator(uint64_t seed)
+    : rng(seed)
+{
+}
+
+double WorkloadGenerator::Uniform()
+{
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double WorkloadGenerator::Uniform(double lo, double hi)
+{
+    return lo + (hi - lo) * Uniform();
+}
+
+// One jittered angle per slot of 2 pi / n. The gap between neighbours is
+// at most 1.4 slots, under pi even for a triangle, so every vertex sees
+// the next one on its left and the ring is simple around the center;
+// fully random angles can leave a gap past pi and fold the ring over.
+Polygon WorkloadGenerator::Star(size_t n, Point center, double radius)
+{
+    n = std::max<size_t>(n, 3);
+    double slot = 2 * Pi / n;
+    double start = Uniform(0, 2 * Pi);
+
+    Polygon poly;
+    poly.outer.vertices.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double t = start + slot * (i + Uniform(0.3, 0.7));
+        double r = radius * Uniform(0.3, 1.0);
+        poly.outer.vertices.push_back({ center.x + r * std::cos(t), center.y + r * std::sin(t) });
+    }
+    return poly;
+}
+
+// Sum of periodic value-noise octaves over the angle, each octave twice as
+// fine and roughness times as strong as the last. The radius stays positive,
+// so the ring is star-shaped around the center and never self-intersects.
+Polygon WorkloadGenerator::Coastline(size_t n, Point center, double radius, double roughness)
+{
+    n = std::max<size_t>(n, 3);
+    // Octaves finer than the vertex spacing add nothing; past 20 the noise
+    // tables would outgrow the ring for little visible detail
+    size_t octaves = 1;
+    while ((size_t(2) << octaves) <= n && octaves < 20)
+        octaves++;
+
+    std::vector<std::vector<double>> noise(octaves);
+    for (size_t k = 0; k < octaves; k++)
+    {
+        noise[k].resize(size_t(2) << k);
+        for (double& v : noise[k])
+            v = Uniform(-1, 1);
+    }
+
+    Polygon poly;
+    poly.outer.vertices.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double u = static_cast<double>(i) / n;
+        double r = 1.0;
+        double amplitude = 0.35;
+        for (size_t k = 0; k < octaves; k++)
+        {
+            const std::vector<double>& samples = noise[k];
+            double x = u * samples.size();
+            size_t j = static_cast<size_t>(x);
+            double f = x - j;
+            r += amplitude * (samples[j] * (1 - f) + samples[(j + 1) % samples.size()] * f);
+            amplitude *= roughness;
+        }
+        r = radius * std::max(r, 0.1);
+        double t = 2 * Pi * u;
+        poly.outer.vertices.push_back({ center.x + r * std::cos(t), center.y + r * std::sin(t) });
+    }
+    return poly;
+}
+
+Polygon WorkloadGenerator::Convex(size_t n, Point center, double radius)
+{
+    n = std::max<size_t>(n, 3);
+    std::vector<double> angles(n);
+    for (double& t : angles)
+        t = Uniform(0, 2 * Pi);
+    std::sort(angles.begin(), angles.end());
+
+    Polygon poly;
+    poly.outer.vertices.reserve(n);
+    for (double t : angles)
+        poly.outer.vertices.push_back({ center.x + radius * std::cos(t), center.y + radius * std::sin(t) });
+    return poly;
+}
+
+// Perimeter split into n points, shared evenly by length; every point but
+// the corners is nudged off the edge by at most jitter, so edges are
+// collinear with the neighbour's only up to round-off
+Polygon WorkloadGenerator::CollinearRect(size_t n, Point origin, double width, double height, double jitter)
+{
+    n = std::max<size_t>(n, 4);
+    double perimeter = 2 * (width + height);
+    const double lengths[4] = { width, height, width, height };
+    const Point corners[4] = {
+        origin,
+        { origin.x + width, origin.y },
+        { origin.x + width, origin.y + height },
+        { origin.x, origin.y + height } };
+
+    size_t counts[4];
+    size_t assigned = 0;
+    for (int s = 0; s < 4; s++)
+    {
+        counts[s] = std::max<size_t>(1, static_cast<size_t>(n * lengths[s] / perimeter));
+        assigned += counts[s];
+    }
+    counts[0] += n > assigned ? n - assigned : 0;
+
+    Polygon poly;
+    poly.outer.vertices.reserve(n);
+    for (int s = 0; s < 4; s++)
+    {
+        const Point& p0 = corners[s];
+        const Point& p1 = corners[(s + 1) % 4];
+        double nx = -(p1.y - p0.y) / lengths[s];
+        double ny = (p1.x - p0.x) / lengths[s];
+        poly.outer.vertices.push_back(p0);
+        for (size_t i = 1; i < counts[s]; i++)
+        {
+            double f = static_cast<double>(i) / counts[s];
+            double d = Uniform(-jitter, jitter);
+            poly.outer.vertices.push_back({
+                p0.x + f * (p1.x - p0.x) + d * nx,
+                p0.y + f * (p1.y - p0.y) + d * ny });
+        }
+    }
+    return poly;
+}
+
+std::vector<Polygon> WorkloadGenerator::SquareGrid(size_t n, Point origin, double size)
+{
+    size_t squares = std::max<size_t>(n / 4, 1);
+    size_t k = GridSide(squares);
+    double cell = size / k;
+
+    std::vector<Polygon> grid;
+    grid.reserve(squares);
+    for (size_t i = 0; i < squares; i++)
+        grid.push_back(Square(origin.x + (i % k) * cell, origin.y + (i / k) * cell, cell, false));
+    return grid;
+}
+
+Polygon WorkloadGenerator::WithHoles(size_t n, Point origin, double size)
+{
+    size_t holes = std::max<size_t>((n > 4 ? n - 4 : 0) / 4, 1);
+    size_t k = GridSide(holes);
+    double cell = size / k;
+
+    Polygon poly = Square(origin.x, origin.y, size, false);
+    poly.holes.reserve(holes);
+    for (size_t i = 0; i < holes; i++)
+    {
+        Polygon hole = Square(origin.x + ((i % k) + 0.25) * cell, origin.y + ((i / k) + 0.25) * cell, cell * 0.5, true);
+        poly.holes.push_back(std::move(hole.outer));
+    }
+    return poly;
+}
+
+Workload WorkloadGenerator::Generate(WorkloadKind kind, size_t vertices)
+{
+    Workload w;
+    switch (kind)
+    {
+    case WorkloadKind::Star:
+        w.a.push_back(Star(vertices, { 0, 0 }, 1));
+        w.b.push_back(Star(vertices, { 0.35, 0.2 }, 1));
+        break;
+
+    case WorkloadKind::Coastline:
+        w.a.push_back(Coastline(vertices, { 0, 0 }, 1));
+        w.b.push_back(Coastline(vertices, { 0.3, 0.15 }, 1));
+        break;
+
+    case WorkloadKind::SquareGrid:
+    {
+        double half = 0.5 / GridSide(std::max<size_t>(vertices / 4, 1));
+        w.a = SquareGrid(vertices, { 0, 0 }, 1);
+        w.b = SquareGrid(vertices, { half, half }, 1);
+        break;
+    }
+
+    case WorkloadKind::Holes:
+        w.a.push_back(WithHoles(vertices, { 0, 0 }, 1));
+        w.b.push_back(WithHoles(vertices, { 0.5, 0.25 }, 1));
+        break;
+
+    case WorkloadKind::Collinear:
+        w.a.push_back(CollinearRect(vertices, { 0, 0 }, 2, 1, 1e-12));
+        w.b.push_back(CollinearRect(vertices, { 1, 0 }, 2, 1, 1e-12));
+        break;
+
+    case WorkloadKind::Convex:
+        w.a.push_back(Convex(vertices, { 0, 0 }, 1));
+        w.b.push_back(Convex(vertices, { 0.5, 0.3 }, 1));
+        break;
+    }
+    return w;
+}
+
+const char* WorkloadGenerator::KindName(WorkloadKind kind)
+{
+    switch (kind)
+    {
+    case WorkloadKind::Star: return "star";
+    case WorkloadKind::Coastline: return "coastline";
+    case WorkloadKind::SquareGrid: return "square-grid";
+    case WorkloadKind::Holes: return "holes";
+    case WorkloadKind::Collinear: return "collinear";
+    case WorkloadKind::Convex: return "convex";
+    }
+    return "unknown";
+}
+
+bool WorkloadGenerator::ParseKind(const std::string& name, WorkloadKind& kind)
+{
+    for (WorkloadKind k : AllKinds())
+    {
+        if (name == KindName(k))
+        {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<WorkloadKind>& WorkloadGenerator::AllKinds()
+{
+    static const std::vector<WorkloadKind> kinds = {
+        WorkloadKind::Star, WorkloadKind::Coastline, WorkloadKind::SquareGrid,
+        WorkloadKind::Holes, WorkloadKind::Collinear, WorkloadKind::Convex };
+    return kinds;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "Polygonutility.h"
+
+// Seeded synthetic inputs for benchmarks and scaling tests.
+//
+// The same seed gives the same coordinates on every platform: values come
+// from std::mt19937_64 mapped to doubles by hand, because the standard
+// distributions are not specified bit-for-bit across library vendors.
+// Sizes are approximate per-side vertex counts and may range from about
+// ten up to ten million.
+
+enum class WorkloadKind
+{
+    Star,       // jittered angles, random radii: simple, strongly concave
+    Coastline,  // fractal radius over the angle: rough but simple
+    SquareGrid, // grid of squares sharing edges, B offset by half a cell
+    Holes,      // one square with thousands of square holes
+    Collinear,  // subdivided rectangles whose edges overlap almost exactly
+    Convex      // random points on a circle, in angle order
+};
+
+// Two operand sets; engines that take single polygons pair a[i] with b[i]
+// (the shorter side wraps around)
+struct Workload
+{
+    std::vector<Polygon> a;
+    std::vector<Polygon> b;
+
+    size_t PairCount() const;
+    size_t VertexCount() const;
+};
+
+class WorkloadGenerator
+{
+public:
+    explicit WorkloadGenerator(uint64_t seed);
+
+    Workload Generate(WorkloadKind kind, size_t vertices);
+
+    // Single families, vertex count n (at least 3)
+    Polygon Star(size_t n, Point center, double radius);
+    Polygon Coastline(size_t n, Point center, double radius, double roughness = 0.5);
+    Polygon Convex(size_t n, Point center, double radius);
+    Polygon CollinearRect(size_t n, Point origin, double width, double height, double jitter);
+
+    // About n vertices in total: n / 4 unit squares, or an outer square
+    // with (n - 4) / 4 square holes
+    std::vector<Polygon> SquareGrid(size_t n, Point origin, double size);
+    Polygon WithHoles(size_t n, Point origin, double size);
+
+    static const char* KindName(WorkloadKind kind);
+    static bool ParseKind(const std::string& name, WorkloadKind& kind);
+    static const std::vector<WorkloadKind>& AllKinds();
+
+private:
+    double Uniform(); // [0, 1)
+    double Uniform(double lo, double hi);
+
+    std::mt19937_64 rng;
+};
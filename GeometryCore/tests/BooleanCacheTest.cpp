@@ -0,0 +1,105 @@
+// Tests BooleanCache hits, misses and eviction, and that cached answers
+// match the engine's
+
+#include "TestCheck.h"
+#include "../BooleanCache.h"
+#include <cmath>
+#include <vector>
+
+static double Area(const std::vector<Polygon>& polys)
+{
+    double total = 0;
+    for (const Polygon& p : polys)
+    {
+        total += std::fabs(PolygonView(p).Outer().SignedArea());
+        for (size_t h = 0; h < p.holes.size(); h++)
+            total -= std::fabs(PolygonView(p).Hole(h).SignedArea());
+    }
+    return total;
+}
+
+static Polygon Box(double x0, double y0, double x1, double y1)
+{
+    Polygon p;
+    p.outer.vertices = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+    return p;
+}
+
+static void TestHits()
+{
+    BooleanEngine engine;
+    BooleanCache cache(engine);
+    Polygon a = Box(0, 0, 4, 4);
+    Polygon b = Box(2, 2, 6, 6);
+
+    std::vector<Polygon> first = cache.Compute(a, b, BoolOp::Intersection);
+    std::vector<Polygon> second = cache.Compute(a, b, BoolOp::Intersection);
+    CHECK_NEAR(Area(first), 4, 1e-9);
+    CHECK_NEAR(Area(second), 4, 1e-9);
+    BooleanCacheStats stats = cache.Stats();
+    CHECK(stats.misses == 1 && stats.hits == 1 && stats.entries == 1);
+
+    // The same inputs under another operation, or swapped, are new keys
+    CHECK_NEAR(Area(cache.Compute(a, b, BoolOp::Union)), 28, 1e-9);
+    CHECK_NEAR(Area(cache.Compute(b, a, BoolOp::AminusB)), 12, 1e-9);
+    CHECK(cache.Stats().misses == 3);
+
+    // Shared results point at the same entry
+    BooleanCache::Result x = cache.ComputeShared(a, b, BoolOp::Union);
+    BooleanCache::Result y = cache.ComputeShared(a, b, BoolOp::Union);
+    CHECK(x && x == y);
+
+    // A moved vertex changes the key
+    Polygon moved = b;
+    moved.outer.vertices[0] = { 3, 2 };
+    CHECK_NEAR(Area(cache.Compute(a, moved, BoolOp::Intersection)), 2.5, 1e-9);
+
+    BooleanOps ops;
+    CHECK_NEAR(cache.IntersectionArea(a, b), ops.IntersectionArea(a, b), 1e-12);
+    CHECK_NEAR(cache.IoU(a, b), ops.IoU(a, b), 1e-12);
+    uint64_t hits = cache.Stats().hits;
+    CHECK_NEAR(cache.IoU(a, b), 4.0 / 28.0, 1e-12);
+    CHECK(cache.Stats().hits == hits + 1);
+
+    cache.ResetCounters();
+    stats = cache.Stats();
+    CHECK(stats.hits == 0 && stats.misses == 0 && stats.entries > 0);
+    CHECK(stats.HitRate() == 0.0);
+}
+
+static void TestEviction()
+{
+    BooleanEngine engine;
+    BooleanCache cache(engine);
+    for (int i = 0; i < 20; i++)
+        cache.Compute(Box(0, 0, 4, 4), Box(i, 1, i + 3, 3), BoolOp::Union);
+    BooleanCacheStats full = cache.Stats();
+    CHECK(full.entries == 20 && full.bytes > 0);
+
+    // Halving the budget evicts the oldest entries first
+    cache.SetMaxBytes(full.bytes / 2);
+    BooleanCacheStats half = cache.Stats();
+    CHECK(half.bytes <= full.bytes / 2);
+    CHECK(half.entries < 20 && half.evictions == 20 - half.entries);
+    cache.Compute(Box(0, 0, 4, 4), Box(19, 1, 22, 3), BoolOp::Union);
+    CHECK(cache.Stats().hits == 1);
+    cache.Compute(Box(0, 0, 4, 4), Box(0, 1, 3, 3), BoolOp::Union);
+    CHECK(cache.Stats().hits == 1);
+
+    // A result larger than the budget is returned but not kept
+    cache.SetMaxBytes(1);
+    CHECK_NEAR(Area(cache.Compute(Box(0, 0, 1, 1), Box(5, 5, 6, 6), BoolOp::Union)), 2, 1e-9);
+    CHECK(cache.Stats().entries == 0);
+
+    cache.SetMaxBytes(size_t(1) << 20);
+    cache.Compute(Box(0, 0, 1, 1), Box(5, 5, 6, 6), BoolOp::Union);
+    cache.Clear();
+    CHECK(cache.Stats().entries == 0 && cache.Stats().bytes == 0);
+}
+
+int main()
+{
+    TestHits();
+    TestEviction();
+    return Report("BooleanCache");
+}
@@ -0,0 +1,99 @@
+// Tests the batched convex clipper against areas known in closed form
+
+#include "TestCheck.h"
+#include "../ConvexBatchClipper.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+static double Area(ConvexBatchClipper& clipper, const SmallConvex& a, const SmallConvex& b)
+{
+    double out = -1;
+    clipper.IntersectionAreas(&a, &b, 1, &out);
+    return out;
+}
+
+// Overlaps, containment, touching and disjoint pairs, in every lane of a
+// block and across a block boundary
+static void TestAreas()
+{
+    ConvexBatchClipper clipper;
+    std::vector<SmallConvex> A, B;
+    std::vector<double> expected;
+    for (int i = 0; i < 2 * ConvexBatchClipper::Lanes + 3; i++)
+    {
+        double x = i * 10.0;
+        A.push_back(ConvexBatchClipper::RotatedBox(x, 0, 2, 2, 0));
+        switch (i % 4)
+        {
+        case 0: B.push_back(ConvexBatchClipper::RotatedBox(x + 1, 1, 2, 2, 0)); expected.push_back(1); break;
+        case 1: B.push_back(ConvexBatchClipper::RotatedBox(x, 0, 1, 1, 0.3)); expected.push_back(1); break;
+        case 2: B.push_back(ConvexBatchClipper::RotatedBox(x + 2, 0, 2, 2, 0)); expected.push_back(0); break;
+        default: B.push_back(ConvexBatchClipper::RotatedBox(x + 5, 0, 2, 2, 0)); expected.push_back(0); break;
+        }
+    }
+
+    std::vector<double> out(A.size(), -1);
+    clipper.IntersectionAreas(A.data(), B.data(), A.size(), out.data());
+    for (size_t i = 0; i < A.size(); i++)
+        CHECK_NEAR(out[i], expected[i], 1e-9);
+
+    // A square turned 45 degrees: four corner tips of (sqrt 2 - 1)^2 each
+    // stick out of the other
+    SmallConvex square = ConvexBatchClipper::RotatedBox(0, 0, 2, 2, 0);
+    SmallConvex diamond = ConvexBatchClipper::RotatedBox(0, 0, 2, 2, 0.78539816339744831);
+    CHECK_NEAR(Area(clipper, square, diamond), 4 - 4 * (std::sqrt(2.0) - 1) * (std::sqrt(2.0) - 1), 1e-9);
+
+    double iou = -1;
+    clipper.IoU(&square, &square, 1, &iou);
+    CHECK_NEAR(iou, 1, 1e-12);
+}
+
+// A repeated vertex is a zero-length edge, which must not clip anything
+static void TestRepeatedVertex()
+{
+    ConvexBatchClipper clipper;
+    std::vector<Point> repeated = { { 0, 0 }, { 2, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 } };
+    SmallConvex shifted = ConvexBatchClipper::FromPoints({ { 1, 1 }, { 3, 1 }, { 3, 3 }, { 1, 3 } });
+    SmallConvex unit = ConvexBatchClipper::FromPoints({ { 0.5, 0.5 }, { 1.5, 0.5 }, { 1.5, 1.5 }, { 0.5, 1.5 } });
+
+    SmallConvex fromPoints = ConvexBatchClipper::FromPoints(repeated);
+    CHECK(fromPoints.count == 4);
+
+    // Also built by hand, so the kernel sees the zero-length edge
+    SmallConvex raw;
+    raw.count = (int)repeated.size();
+    for (int i = 0; i < raw.count; i++)
+        raw.vertices[i] = repeated[i];
+
+    for (const SmallConvex& a : { fromPoints, raw })
+    {
+        CHECK_NEAR(Area(clipper, a, shifted), 1, 1e-12);
+        CHECK_NEAR(Area(clipper, shifted, a), 1, 1e-12);
+        CHECK_NEAR(Area(clipper, a, unit), 1, 1e-12);
+        CHECK_NEAR(Area(clipper, unit, a), 1, 1e-12);
+    }
+
+    // A closing copy of the first vertex is dropped too
+    CHECK(ConvexBatchClipper::FromPoints({ { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 } }).count == 3);
+}
+
+static void TestFromPointsRejects()
+{
+    CHECK_THROWS(ConvexBatchClipper::FromPoints({ { 0, 0 }, { 1, 0 } }), std::invalid_argument);
+    CHECK_THROWS(ConvexBatchClipper::FromPoints({ { 0, 0 }, { 1, 0 }, { 1, 0 }, { 0, 0 } }), std::invalid_argument);
+    CHECK_THROWS(ConvexBatchClipper::FromPoints({ { 0, 0 }, { 2, 0 }, { 1, 0.5 }, { 2, 2 }, { 0, 2 } }), std::invalid_argument);
+
+    std::vector<Point> nine;
+    for (int i = 0; i < 9; i++)
+        nine.push_back({ std::cos(i * 0.6981317), std::sin(i * 0.6981317) });
+    CHECK_THROWS(ConvexBatchClipper::FromPoints(nine), std::invalid_argument);
+}
+
+int main()
+{
+    TestAreas();
+    TestRepeatedVertex();
+    TestFromPointsRejects();
+    return Report("ConvexBatchClipper");
+}
@@ -0,0 +1,365 @@
+// Tests WKT and WKB reading and writing: round trips, byte order, Z and M
+// ordinates, SRID prefixes and malformed input
+
+#include "TestCheck.h"
+#include "../GeometryIO.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Square with a square hole; rings are stored open, as GeometryCore does
+static Polygon Framed()
+{
+    Polygon p;
+    p.outer.vertices = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+    p.holes.push_back({ { { 2, 2 }, { 2, 4 }, { 4, 4 }, { 4, 2 } } });
+    return p;
+}
+
+static Polygon Triangle()
+{
+    Polygon p;
+    p.outer.vertices = { { 0.1, 0.2 }, { 1.0 / 3.0, -7.25e-9 }, { 12345.678, 1e12 } };
+    return p;
+}
+
+static bool SameRing(const Ring& a, const Ring& b)
+{
+    if (a.vertices.size() != b.vertices.size())
+        return false;
+    for (size_t i = 0; i < a.vertices.size(); i++)
+    {
+        if (a.vertices[i].x != b.vertices[i].x || a.vertices[i].y != b.vertices[i].y)
+            return false;
+    }
+    return true;
+}
+
+static bool SamePolygon(const Polygon& a, const Polygon& b)
+{
+    if (!SameRing(a.outer, b.outer) || a.holes.size() != b.holes.size())
+        return false;
+    for (size_t i = 0; i < a.holes.size(); i++)
+    {
+        if (!SameRing(a.holes[i], b.holes[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename Reader>
+static std::vector<Polygon> ReadAll(const void* data, size_t size)
+{
+    ByteSource source = ByteSource::FromMemory(data, size);
+    Reader reader(source);
+    std::vector<Polygon> out;
+    Polygon poly;
+    while (reader.Next(poly))
+        out.push_back(poly);
+    return out;
+}
+
+static std::vector<Polygon> ReadWkt(const std::string& text)
+{
+    return ReadAll<WktReader>(text.data(), text.size());
+}
+
+static std::vector<Polygon> ReadWkb(const std::vector<char>& bytes)
+{
+    return ReadAll<WkbReader>(bytes.data(), bytes.size());
+}
+
+// True if reading throws std::runtime_error, without crashing or hanging
+template <typename Fn>
+static bool Rejects(Fn read)
+{
+    try
+    {
+        read();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// Hand-built WKB in either byte order
+struct WkbBuilder
+{
+    bool big = false;
+    std::vector<char> bytes;
+
+    void Raw(const void* p, size_t n)
+    {
+        const char* c = static_cast<const char*>(p);
+        if (big)
+        {
+            for (size_t i = n; i > 0; i--)
+                bytes.push_back(c[i - 1]);
+        }
+        else
+        {
+            bytes.insert(bytes.end(), c, c + n);
+        }
+    }
+
+    void Header(uint32_t type)
+    {
+        bytes.push_back(big ? 0 : 1);
+        Raw(&type, 4);
+    }
+
+    void Count(uint32_t n) { Raw(&n, 4); }
+    void Number(double v) { Raw(&v, 8); }
+
+    // Closed ring with extra ordinates after x and y
+    void Ring(const ::Ring& ring, int extra)
+    {
+        Count(static_cast<uint32_t>(ring.vertices.size() + 1));
+        for (size_t i = 0; i <= ring.vertices.size(); i++)
+        {
+            const Point& p = ring.vertices[i % ring.vertices.size()];
+            Number(p.x);
+            Number(p.y);
+            for (int k = 0; k < extra; k++)
+                Number(100.0 + k);
+        }
+    }
+
+    void Polygon(const ::Polygon& poly, uint32_t type, int extra)
+    {
+        Header(type);
+        Count(static_cast<uint32_t>(1 + poly.holes.size()));
+        Ring(poly.outer, extra);
+        for (const ::Ring& hole : poly.holes)
+            Ring(hole, extra);
+    }
+};
+
+static void TestRoundTrip()
+{
+    std::vector<Polygon> multi = { Framed(), Triangle() };
+
+    std::vector<char> text;
+    {
+        ByteSink sink = ByteSink::ToMemory(text);
+        WktWriter writer(sink);
+        writer.Write(Framed());
+        writer.Write(multi);
+        writer.Write(Polygon());
+        sink.Flush();
+    }
+    std::vector<Polygon> fromWkt = ReadAll<WktReader>(text.data(), text.size());
+    CHECK(fromWkt.size() == 3);
+    if (fromWkt.size() == 3)
+    {
+        CHECK(SamePolygon(fromWkt[0], Framed()));
+        CHECK(SamePolygon(fromWkt[1], Framed()));
+        CHECK(SamePolygon(fromWkt[2], Triangle()));
+    }
+
+    std::vector<char> binary;
+    {
+        ByteSink sink = ByteSink::ToMemory(binary);
+        WkbWriter writer(sink);
+        writer.Write(Framed());
+        writer.Write(multi);
+        sink.Flush();
+    }
+    std::vector<Polygon> fromWkb = ReadWkb(binary);
+    CHECK(fromWkb.size() == 3);
+    if (fromWkb.size() == 3)
+    {
+        CHECK(SamePolygon(fromWkb[0], Framed()));
+        CHECK(SamePolygon(fromWkb[1], Framed()));
+        CHECK(SamePolygon(fromWkb[2], Triangle()));
+    }
+
+    // Through a file descriptor with a buffer smaller than one polygon, so
+    // points straddle every refill
+    FILE* file = tmpfile();
+    CHECK(file != nullptr);
+    if (file)
+    {
+        fwrite(binary.data(), 1, binary.size(), file);
+        fflush(file);
+        rewind(file);
+        ByteSource source = ByteSource::FromFd(fileno(file), 40);
+        WkbReader reader(source);
+        Polygon poly;
+        size_t count = 0;
+        while (reader.Next(poly))
+        {
+            CHECK(SamePolygon(poly, count == 2 ? Triangle() : Framed()));
+            count++;
+        }
+        CHECK(count == 3);
+        fclose(file);
+    }
+}
+
+static void TestByteOrder()
+{
+    for (bool big : { false, true })
+    {
+        WkbBuilder wkb;
+        wkb.big = big;
+        wkb.Polygon(Framed(), 3, 0);
+        wkb.Header(6);
+        wkb.Count(2);
+        wkb.Polygon(Triangle(), 3, 0);
+        wkb.big = !big; // members may use the other byte order
+        wkb.Polygon(Framed(), 3, 0);
+
+        std::vector<Polygon> read = ReadWkb(wkb.bytes);
+        CHECK(read.size() == 3);
+        if (read.size() == 3)
+        {
+            CHECK(SamePolygon(read[0], Framed()));
+            CHECK(SamePolygon(read[1], Triangle()));
+            CHECK(SamePolygon(read[2], Framed()));
+        }
+    }
+}
+
+static void TestExtraOrdinates()
+{
+    // ISO Z, M and ZM, then the EWKB Z and M flags
+    const uint32_t types[] = { 1003, 2003, 3003, 0x80000003u, 0x40000003u, 0xC0000003u };
+    const int extra[] = { 1, 1, 2, 1, 1, 2 };
+    for (int i = 0; i < 6; i++)
+    {
+        WkbBuilder wkb;
+        wkb.Polygon(Framed(), types[i], extra[i]);
+        std::vector<Polygon> read = ReadWkb(wkb.bytes);
+        CHECK(read.size() == 1 && SamePolygon(read[0], Framed()));
+    }
+
+    const char* texts[] = {
+        "POLYGON Z ((0 0 1,10 0 1,10 10 1,0 10 1,0 0 1),(2 2 5,2 4 5,4 4 5,4 2 5,2 2 5))",
+        "POLYGON M ((0 0 1,10 0 1,10 10 1,0 10 1,0 0 1),(2 2 5,2 4 5,4 4 5,4 2 5,2 2 5))",
+        "polygon zm((0 0 1 2,10 0 1 2,10 10 1 2,0 10 1 2,0 0 1 2),(2 2 5 6,2 4 5 6,4 4 5 6,4 2 5 6,2 2 5 6))",
+    };
+    for (const char* text : texts)
+    {
+        std::vector<Polygon> read = ReadWkt(text);
+        CHECK(read.size() == 1 && SamePolygon(read[0], Framed()));
+    }
+}
+
+static void TestSrid()
+{
+    WkbBuilder wkb;
+    wkb.Header(0x20000003u);
+    wkb.Count(4326);
+    wkb.Count(2);
+    wkb.Ring(Framed().outer, 0);
+    wkb.Ring(Framed().holes[0], 0);
+    // SRID and Z together
+    wkb.Header(0xA0000003u);
+    wkb.Count(3857);
+    wkb.Count(1);
+    wkb.Ring(Triangle().outer, 1);
+
+    std::vector<Polygon> read = ReadWkb(wkb.bytes);
+    CHECK(read.size() == 2);
+    if (read.size() == 2)
+    {
+        CHECK(SamePolygon(read[0], Framed()));
+        CHECK(SamePolygon(read[1], Triangle()));
+    }
+
+    read = ReadWkt("SRID=4326;POLYGON((0 0,10 0,10 10,0 10,0 0),(2 2,2 4,4 4,4 2,2 2))\n"
+        "SRID=3857;MULTIPOLYGON(((0 0,10 0,10 10,0 10,0 0),(2 2,2 4,4 4,4 2,2 2)),EMPTY)");
+    CHECK(read.size() == 2);
+    for (const Polygon& p : read)
+        CHECK(SamePolygon(p, Framed()));
+}
+
+static void TestMalformedWkb()
+{
+    WkbBuilder good;
+    good.Polygon(Framed(), 3, 0);
+
+    // Every proper prefix is truncated input
+    for (size_t n = 1; n < good.bytes.size(); n++)
+    {
+        std::vector<char> cut(good.bytes.begin(), good.bytes.begin() + n);
+        CHECK(Rejects([&] { ReadWkb(cut); }));
+    }
+
+    std::vector<char> bytes = good.bytes;
+    bytes[0] = 2;
+    CHECK(Rejects([&] { ReadWkb(bytes); }));
+
+    WkbBuilder point;
+    point.Header(1);
+    point.Number(1);
+    point.Number(2);
+    CHECK(Rejects([&] { ReadWkb(point.bytes); }));
+
+    WkbBuilder fourDims;
+    fourDims.Polygon(Framed(), 4003, 0);
+    CHECK(Rejects([&] { ReadWkb(fourDims.bytes); }));
+
+    // Huge counts fail as truncated input rather than allocating
+    WkbBuilder rings;
+    rings.Header(3);
+    rings.Count(0xFFFFFFFFu);
+    rings.Ring(Framed().outer, 0);
+    CHECK(Rejects([&] { ReadWkb(rings.bytes); }));
+
+    WkbBuilder points;
+    points.Header(3);
+    points.Count(1);
+    points.Count(0xFFFFFFFFu);
+    points.Number(0);
+    points.Number(0);
+    CHECK(Rejects([&] { ReadWkb(points.bytes); }));
+
+    WkbBuilder member;
+    member.Header(6);
+    member.Count(1);
+    member.Header(6);
+    member.Count(0);
+    CHECK(Rejects([&] { ReadWkb(member.bytes); }));
+}
+
+static void TestMalformedWkt()
+{
+    const char* texts[] = {
+        "POLYGON ((0 0,1 0,1 1",
+        "POLYGON ((0 0,1 0,1 1,0 0)",
+        "POLYGON ((0 0,1 0,x 1,0 0))",
+        "POLYGON (0 0,1 0,1 1,0 0)",
+        "POINT (1 2)",
+        "POLYGON Q ((0 0,1 0,1 1,0 0))",
+        "MULTIPOLYGON (((0 0,1 0,1 1,0 0)) ((0 0,1 0,1 1,0 0)))",
+        "POLYGON ((0 0,1 0,1 1,0 0)) POLYGON",
+    };
+    for (const char* text : texts)
+    {
+        bool rejected = Rejects([&] { ReadWkt(text); });
+        if (!rejected)
+            fprintf(stderr, "accepted: %s\n", text);
+        CHECK(rejected);
+    }
+
+    CHECK(ReadWkt("").empty());
+    CHECK(ReadWkt("  POLYGON EMPTY\n MULTIPOLYGON EMPTY ").empty());
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestByteOrder();
+    TestExtraOrdinates();
+    TestSrid();
+    TestMalformedWkb();
+    TestMalformedWkt();
+    return Report("GeometryIO");
+}
@@ -0,0 +1,161 @@
+// Tests that IncrementalBooleanSession stays equal to a from-scratch
+// boolean under a run of vertex edits
+
+#include "TestCheck.h"
+#include "../IncrementalBooleanSession.h"
+#include "../BooleanEngine.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+static double Area(const std::vector<Polygon>& polys)
+{
+    double total = 0;
+    for (const Polygon& p : polys)
+    {
+        total += std::fabs(PolygonView(p).Outer().SignedArea());
+        for (size_t h = 0; h < p.holes.size(); h++)
+            total -= std::fabs(PolygonView(p).Hole(h).SignedArea());
+    }
+    return total;
+}
+
+static Polygon FromVertices(const std::vector<Point>& vertices)
+{
+    Polygon p;
+    p.outer.vertices = vertices;
+    return p;
+}
+
+static const double TwoPi = 6.283185307179586;
+
+// Vertex at angle t and a random radius around c. Rings whose vertices go
+// round c with increasing angles are star-shaped, and so stay simple under
+// edits that keep the angles in order.
+static Point Spoke(Point c, double t, std::mt19937& rng)
+{
+    double r = std::uniform_real_distribution<double>(2.0, 4.0)(rng);
+    return { c.x + r * std::cos(t), c.y + r * std::sin(t) };
+}
+
+static Polygon Star(Point c, int n, std::mt19937& rng)
+{
+    Polygon p;
+    for (int i = 0; i < n; i++)
+        p.outer.vertices.push_back(Spoke(c, TwoPi * (i + 0.5) / n, rng));
+    return p;
+}
+
+static double Angle(Point c, Point p)
+{
+    double t = std::atan2(p.y - c.y, p.x - c.x);
+    return t < 0 ? t + TwoPi : t;
+}
+
+// Session result against the winding-overlay engine on its current rings
+static void Compare(const IncrementalBooleanSession& session, const BooleanEngine& engine)
+{
+    Polygon a = FromVertices(session.Vertices(BooleanOperand::A));
+    Polygon b = FromVertices(session.Vertices(BooleanOperand::B));
+    double expected = Area(engine.Compute(a, b, session.Operation(), EngineKind::WindingOverlay));
+    CHECK_NEAR(Area(session.Result()), expected, 1e-9 * (1 + expected));
+}
+
+static void TestSquares()
+{
+    Polygon a = FromVertices({ { 0, 0 }, { 4, 0 }, { 4, 4 }, { 0, 4 } });
+    Polygon b = FromVertices({ { 2, 1 }, { 6, 1 }, { 6, 5 }, { 2, 5 } });
+    IncrementalBooleanSession session(a, b, BoolOp::Intersection);
+    CHECK(session.CrossingCount() == 2);
+    CHECK_NEAR(Area(session.Result()), 6, 1e-12);
+
+    // Pulling B clear of A leaves nothing to intersect
+    session.MoveVertex(BooleanOperand::B, 0, { 5, 1 });
+    session.MoveVertex(BooleanOperand::B, 3, { 5, 5 });
+    CHECK(session.CrossingCount() == 0);
+    CHECK(session.Result().empty());
+
+    // ... and the union is both squares whole, each ring reported once
+    SessionChange change = session.SetOperation(BoolOp::Union);
+    CHECK(change.added.size() == 2);
+    CHECK_NEAR(Area(session.Result()), 16 + 4, 1e-12);
+
+    // A vertex inserted into B's left edge reaches back into A
+    change = session.InsertVertex(BooleanOperand::B, 0, { 3, 2.5 });
+    CHECK(session.VertexCount(BooleanOperand::B) == 5);
+    CHECK(session.CrossingCount() == 2);
+    CHECK(!change.removed.empty() && !change.added.empty());
+
+    BooleanEngine engine;
+    Compare(session, engine);
+}
+
+static void TestErrors()
+{
+    Polygon a = FromVertices({ { 0, 0 }, { 4, 0 }, { 4, 4 }, { 0, 4 } });
+    Polygon b = FromVertices({ { 2, 1 }, { 6, 1 }, { 2, 5 } });
+    CHECK_THROWS(IncrementalBooleanSession(FromVertices({ { 0, 0 }, { 1, 0 } }), b, BoolOp::Union),
+        std::invalid_argument);
+
+    IncrementalBooleanSession session(a, b, BoolOp::Union);
+    CHECK_THROWS(session.MoveVertex(BooleanOperand::A, 4, { 1, 1 }), std::out_of_range);
+    CHECK_THROWS(session.InsertVertex(BooleanOperand::A, 5, { 1, 1 }), std::out_of_range);
+    CHECK_THROWS(session.DeleteVertex(BooleanOperand::B, 0), std::invalid_argument);
+    CHECK(session.VertexCount(BooleanOperand::B) == 3);
+}
+
+static void TestRandomEdits()
+{
+    std::mt19937 rng(7);
+    BooleanEngine engine;
+    const BoolOp ops[] = { BoolOp::Union, BoolOp::Intersection, BoolOp::AminusB, BoolOp::BminusA };
+    const Point centers[] = { { 0, 0 }, { 2.5, 0.5 } };
+
+    IncrementalBooleanSession session(Star(centers[0], 24, rng), Star(centers[1], 24, rng), BoolOp::Union);
+    Compare(session, engine);
+    for (int step = 0; step < 300; step++)
+    {
+        BooleanOperand which = (step & 1) ? BooleanOperand::B : BooleanOperand::A;
+        Point c = centers[step & 1];
+        std::vector<Point> ring = session.Vertices(which);
+        size_t count = ring.size();
+        size_t index = rng() % count;
+        double t = Angle(c, ring[index]);
+        switch (rng() % 4)
+        {
+        case 0:
+        {
+            // A new spoke halfway between the vertex and the one before it
+            double before = Angle(c, ring[(index + count - 1) % count]);
+            double gap = t - before;
+            if (gap < 0)
+                gap += TwoPi;
+            session.InsertVertex(which, index, Spoke(c, before + gap * 0.5, rng));
+            break;
+        }
+        case 1:
+            if (count > 12)
+            {
+                session.DeleteVertex(which, index);
+                break;
+            }
+            [[fallthrough]];
+        case 2:
+            session.MoveVertex(which, index, Spoke(c, t, rng));
+            break;
+        default:
+            session.SetOperation(ops[rng() % 4]);
+            break;
+        }
+        Compare(session, engine);
+    }
+}
+
+int main()
+{
+    TestSquares();
+    TestErrors();
+    TestRandomEdits();
+    return Report("IncrementalBooleanSession");
+}
@@ -0,0 +1,104 @@
+// Tests MinkowskiOps sums and differences against closed-form areas
+
+#include "TestCheck.h"
+#include "../MinkowskiOps.h"
+#include <cmath>
+#include <vector>
+
+static double RingArea(const Ring& ring)
+{
+    double a = 0;
+    for (size_t i = 0, j = ring.vertices.size() - 1; i < ring.vertices.size(); j = i++)
+        a += ring.vertices[j].x * ring.vertices[i].y - ring.vertices[i].x * ring.vertices[j].y;
+    return std::fabs(a) * 0.5;
+}
+
+// Outer rings minus holes, whatever their orientation
+static double Area(const std::vector<Polygon>& polys)
+{
+    double total = 0;
+    for (const Polygon& p : polys)
+    {
+        total += RingArea(p.outer);
+        for (const Ring& hole : p.holes)
+            total -= RingArea(hole);
+    }
+    return total;
+}
+
+static Polygon Box(double x0, double y0, double x1, double y1)
+{
+    Polygon p;
+    p.outer.vertices = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+    return p;
+}
+
+static void TestConvex()
+{
+    MinkowskiOps ops;
+    CHECK_NEAR(Area(ops.Sum(Box(0, 0, 2, 2), Box(0, 0, 1, 1))), 9, 1e-9);
+
+    // The square's corner opposite the triangle's hypotenuse is cut off
+    Polygon triangle;
+    triangle.outer.vertices = { { 0, 0 }, { 1, 0 }, { 0, 1 } };
+    CHECK_NEAR(Area(ops.Sum(Box(0, 0, 2, 2), triangle)), 8.5, 1e-9);
+
+    // Clockwise input gives the same sum
+    Polygon clockwise = Box(0, 0, 1, 1);
+    std::vector<Point> reversed(clockwise.outer.vertices.rbegin(), clockwise.outer.vertices.rend());
+    clockwise.outer.vertices = reversed;
+    CHECK_NEAR(Area(ops.Sum(Box(0, 0, 2, 2), clockwise)), 9, 1e-9);
+
+    // A - B grows A by the reflection of B
+    std::vector<Polygon> nfp = ops.Difference(Box(0, 0, 4, 4), Box(0, 0, 1, 2));
+    CHECK_NEAR(Area(nfp), 30, 1e-9);
+    CHECK(nfp.size() == 1);
+    if (nfp.size() == 1)
+    {
+        double minX = 1e9, minY = 1e9;
+        for (const Point& p : nfp[0].outer.vertices)
+        {
+            minX = std::fmin(minX, p.x);
+            minY = std::fmin(minY, p.y);
+        }
+        CHECK_NEAR(minX, -1, 1e-12);
+        CHECK_NEAR(minY, -2, 1e-12);
+    }
+}
+
+static void TestConcave()
+{
+    MinkowskiOps ops;
+
+    // An L of three unit cells swept by a unit square is a 3x3 square
+    // missing its top right cell
+    Polygon ell;
+    ell.outer.vertices = { { 0, 0 }, { 2, 0 }, { 2, 1 }, { 1, 1 }, { 1, 2 }, { 0, 2 } };
+    CHECK_NEAR(Area(ops.Sum(ell, Box(0, 0, 1, 1))), 8, 1e-9);
+
+    // A frame whose hole is wider than the swept square keeps a smaller hole
+    Polygon frame = Box(0, 0, 10, 10);
+    frame.holes.push_back({ { { 2, 2 }, { 2, 8 }, { 8, 8 }, { 8, 2 } } });
+    CHECK_NEAR(Area(ops.Sum(frame, Box(0, 0, 2, 2))), 144 - 16, 1e-9);
+
+    // ... and loses it once the square no longer fits
+    CHECK_NEAR(Area(ops.Sum(frame, Box(0, 0, 7, 7))), 289, 1e-9);
+}
+
+static void TestDegenerate()
+{
+    MinkowskiOps ops;
+    Polygon segment;
+    segment.outer.vertices = { { 0, 0 }, { 1, 0 } };
+    CHECK(ops.Sum(Box(0, 0, 1, 1), segment).empty());
+    CHECK(ops.Difference(segment, Box(0, 0, 1, 1)).empty());
+    CHECK(ops.Sum(Polygon(), Polygon()).empty());
+}
+
+int main()
+{
+    TestConvex();
+    TestConcave();
+    TestDegenerate();
+    return Report("MinkowskiOps");
+}
@@ -0,0 +1,115 @@
+// Tests OffsetEngine on shapes with closed-form buffers, and that its
+// running time grows about linearly on a noisy outline
+
+#include "TestCheck.h"
+#include "../../BooleanNative/OffsetEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PolygonBoolean;
+
+static const double Pi = 3.14159265358979323846;
+
+static double Area(const std::vector<std::vector<Point>>& rings)
+{
+    double total = 0;
+    for (const auto& ring : rings)
+    {
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+            total += ring[j].cross(ring[i]);
+    }
+    return total * 0.5;
+}
+
+static std::vector<std::vector<Point>> Square(double side)
+{
+    return { { Point(0, 0), Point(side, 0), Point(side, side), Point(0, side) } };
+}
+
+static void TestSquare()
+{
+    OffsetOptions miter;
+    miter.join = JoinType::MITER;
+    CHECK_NEAR(Area(OffsetEngine::offset(Square(10), 1, miter)), 144, 1e-9);
+    CHECK_NEAR(Area(OffsetEngine::offset(Square(10), -1, miter)), 64, 1e-9);
+
+    // Round joins stay inside the exact buffer, by at most the arc
+    // tolerance along the corners
+    OffsetOptions round;
+    round.arcTolerance = 1e-3;
+    double area = Area(OffsetEngine::offset(Square(10), 1, round));
+    CHECK(area <= 140 + Pi);
+    CHECK(area >= 140 + Pi - 2 * Pi * 1e-3);
+
+    CHECK(OffsetEngine::offset(Square(10), -5.5, round).empty());
+}
+
+// A notch much narrower than the distance disappears in the buffer
+static void TestNotch()
+{
+    std::vector<std::vector<Point>> notched = { {
+        Point(0, 0), Point(4.9, 0), Point(5, 3), Point(5.1, 0), Point(10, 0),
+        Point(10, 10), Point(0, 10) } };
+    OffsetOptions miter;
+    miter.join = JoinType::MITER;
+    CHECK_NEAR(Area(OffsetEngine::offset(notched, 1, miter)), 144, 1e-9);
+}
+
+// Unit circle with radial noise, sampled at n vertices
+static std::vector<std::vector<Point>> NoisyCircle(int n, double noise)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> jitter(-noise, noise);
+    std::vector<Point> ring;
+    for (int i = 0; i < n; i++)
+    {
+        double angle = 2 * Pi * i / n;
+        double radius = 1 + jitter(rng);
+        ring.push_back(Point(radius * std::cos(angle), radius * std::sin(angle)));
+    }
+    return { ring };
+}
+
+static double Seconds(const std::vector<std::vector<Point>>& rings, double distance)
+{
+    double best = HUGE_VAL;
+    for (int run = 0; run < 3; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto result = OffsetEngine::offset(rings, distance);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        CHECK(result.size() == 1);
+    }
+    return best;
+}
+
+// Noise far below the distance: every concave corner used to send a
+// spike of length |distance| into the self-union, and the spikes crossed
+// each other quadratically in the vertex count
+static void TestNoisyScaling()
+{
+    const double distance = 0.005;
+    auto small = NoisyCircle(25000, 1e-4);
+    auto large = NoisyCircle(100000, 1e-4);
+
+    double area = Area(OffsetEngine::offset(large, distance));
+    CHECK(area > Pi * (1 - 1e-4 + distance) * (1 - 1e-4 + distance));
+    CHECK(area < Pi * (1 + 1e-4 + distance) * (1 + 1e-4 + distance));
+
+    // Four times the vertices: 4x when linear, 16x when quadratic
+    double ratio = Seconds(large, distance) / Seconds(small, distance);
+    if (ratio > 8)
+        fprintf(stderr, "noisy offset: 4x the vertices took %.1fx the time\n", ratio);
+    CHECK(ratio <= 8);
+}
+
+int main()
+{
+    TestSquare();
+    TestNotch();
+    TestNoisyScaling();
+    return Report("OffsetEngine");
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// CHECK and CHECK_NEAR for the GeometryCore tests, as in the C API test:
+// a failed check is reported and counted, and the run goes on
+#include <cmath>
+#include <cstdio>
+
+inline int failures = 0;
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,      \
+                __LINE__, #cond);                                        \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                          \
+    do {                                                                 \
+        double a_ = (actual), e_ = (expected);                           \
+        if (std::fabs(a_ - e_) > (tolerance)) {                          \
+            fprintf(stderr, "%s:%d: %s = %.9g, expected %.9g\n",         \
+                __FILE__, __LINE__, #actual, a_, e_);                    \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+#define CHECK_THROWS(expr, type)                                         \
+    do {                                                                 \
+        bool thrown_ = false;                                            \
+        try { (void)(expr); }                                            \
+        catch (const type&) { thrown_ = true; }                          \
+        if (!thrown_) {                                                  \
+            fprintf(stderr, "%s:%d: %s did not throw %s\n", __FILE__,   \
+                __LINE__, #expr, #type);                                 \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+// Result line and exit code for main
+inline int Report(const char* name)
+{
+    if (failures)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("%s: all checks passed\n", name);
+    return 0;
+}
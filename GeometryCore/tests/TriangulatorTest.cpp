@@ -0,0 +1,115 @@
+// Tests that Triangulator covers polygons, holes included, with the
+// expected number of counter-clockwise triangles
+
+#include "TestCheck.h"
+#include "../../BooleanNative/Triangulator.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PolygonBoolean;
+
+static double RingArea(const std::vector<Point>& ring)
+{
+    double a = 0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+        a += ring[j].cross(ring[i]);
+    return a * 0.5;
+}
+
+// Triangulates and checks the triangles against the rings: n + 2h - 2 of
+// them, all counter-clockwise, adding up to the polygon's area
+static void CheckCover(const std::vector<std::vector<Point>>& rings)
+{
+    std::vector<Point> all;
+    double expected = std::fabs(RingArea(rings[0]));
+    for (size_t r = 0; r < rings.size(); r++)
+    {
+        all.insert(all.end(), rings[r].begin(), rings[r].end());
+        if (r > 0)
+            expected -= std::fabs(RingArea(rings[r]));
+    }
+
+    std::vector<size_t> indices;
+    CHECK(Triangulator::triangulate(rings, indices));
+    CHECK(indices.size() == 3 * (all.size() + 2 * (rings.size() - 1) - 2));
+
+    double total = 0;
+    bool ccw = true;
+    bool inRange = true;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        if (indices[t] >= all.size() || indices[t + 1] >= all.size() || indices[t + 2] >= all.size())
+        {
+            inRange = false;
+            continue;
+        }
+        const Point& a = all[indices[t]];
+        double area = (all[indices[t + 1]] - a).cross(all[indices[t + 2]] - a) * 0.5;
+        ccw = ccw && area > 0;
+        total += area;
+    }
+    CHECK(inRange);
+    CHECK(ccw);
+    CHECK_NEAR(total, expected, 1e-9 * (1 + expected));
+}
+
+static std::vector<Point> Box(double x0, double y0, double x1, double y1)
+{
+    return { Point(x0, y0), Point(x1, y0), Point(x1, y1), Point(x0, y1) };
+}
+
+static void TestShapes()
+{
+    CheckCover({ Box(0, 0, 1, 1) });
+
+    // Clockwise outer and counter-clockwise holes are accepted as well
+    std::vector<Point> cw = Box(0, 0, 10, 10);
+    std::vector<Point> reversed(cw.rbegin(), cw.rend());
+    CheckCover({ reversed, Box(1, 1, 3, 3), Box(6, 2, 8, 7) });
+
+    // A comb has a split or merge vertex at every tooth
+    std::vector<Point> comb = { Point(0, 0), Point(20, 0) };
+    for (int i = 9; i >= 0; i--)
+    {
+        comb.push_back(Point(2 * i + 2, 5));
+        comb.push_back(Point(2 * i + 1.5, 1));
+        comb.push_back(Point(2 * i + 1, 5));
+        comb.push_back(Point(2 * i + 0.5, 1 + 0.1 * i));
+    }
+    CheckCover({ comb });
+
+    // Star with random spokes and a star-shaped hole
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> radius(5, 10);
+    std::uniform_real_distribution<double> inner(1, 2);
+    std::vector<Point> star, hole;
+    for (int i = 0; i < 200; i++)
+    {
+        double t = 6.283185307179586 * i / 200;
+        double r = radius(rng);
+        star.push_back(Point(r * std::cos(t), r * std::sin(t)));
+    }
+    for (int i = 40; i > 0; i--)
+    {
+        double t = 6.283185307179586 * i / 40;
+        double r = inner(rng);
+        hole.push_back(Point(r * std::cos(t), r * std::sin(t)));
+    }
+    CheckCover({ star, hole });
+}
+
+static void TestRejects()
+{
+    std::vector<size_t> indices = { 1, 2, 3 };
+    CHECK(!Triangulator::triangulate(std::vector<std::vector<Point>>(), indices));
+    CHECK(indices.empty());
+    CHECK(!Triangulator::triangulate({ { Point(0, 0), Point(1, 0) } }, indices));
+}
+
+int main()
+{
+    TestShapes();
+    TestRejects();
+    return Report("Triangulator");
+}